@@ -156,10 +156,8 @@ FrameCountType ActionsInProgress::whenActionsFinished(const PrerequisiteSet & ac
 	int totalMax = 0;
 	
 	// if there are actions still left
-	for (UnitCountType uc(0); uc < actions.size(); ++uc)
+	for (const ActionType & a : actions)
 	{	
-		// pop an action off the set
-		const ActionType & a = actions.getActionType(uc);
 			
 		// define a new minimum
 		int actionMin = std::numeric_limits<int>::max();
@@ -2,54 +2,159 @@
 
 using namespace BOSS;
 
-ActionSet::ActionSet()
+namespace
 {
+    std::vector<ActionSet> CalculateAllActions()
+    {
+        std::vector<ActionSet> allActions(Races::NUM_RACES);
+        for (RaceID r(0); r < Races::NUM_RACES; ++r)
+        {
+            for (const ActionType & action : ActionTypes::GetAllActionTypes(r))
+            {
+                allActions[r].add(action);
+            }
+        }
+
+        return allActions;
+    }
+
+    // every action type of each race, worked out once
+    const ActionSet & GetAllActions(const RaceID race)
+    {
+        static const std::vector<ActionSet> allActions = CalculateAllActions();
 
+        return allActions[race];
+    }
+}
+
+ActionSet::ActionSet()
+    : _race(Races::None)
+{
+    clear();
 }
 
 const size_t ActionSet::size() const
 {
-    return _actionTypes.size();
+    size_t count = 0;
+    for (size_t w(0); w < NumWords; ++w)
+    {
+        count += PopCount(_bits[w]);
+    }
+
+    return count;
 }
 
 const bool ActionSet::isEmpty() const
 {
-    return size() == 0;
+    for (size_t w(0); w < NumWords; ++w)
+    {
+        if (_bits[w])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+const RaceID ActionSet::getRace() const
+{
+    return _race;
+}
+
+ActionType ActionSet::operator [] (const size_t & index) const
+{
+    size_t remaining = index;
+    for (size_t w(0); w < NumWords; ++w)
+    {
+        const size_t count = PopCount(_bits[w]);
+        if (remaining < count)
+        {
+            Word word = _bits[w];
+            for (; remaining > 0; --remaining)
+            {
+                word &= word - 1;
+            }
+
+            return ActionType(_race, (ActionID)(w * WordBits + LowestBit(word)));
+        }
+
+        remaining -= count;
+    }
+
+    BOSS_ASSERT(false, "ActionSet index out of range: %d of %d", (int)index, (int)size());
+    return ActionTypes::None;
 }
 
-const ActionType & ActionSet::operator [] (const size_t & index) const
+ActionSet::const_iterator ActionSet::begin() const
 {
-    return _actionTypes[index];
+    return const_iterator(this, 0);
 }
 
-ActionType & ActionSet::operator [] (const size_t & index)
+ActionSet::const_iterator ActionSet::end() const
 {
-    return _actionTypes[index];
+    return const_iterator(this, NumWords);
 }
 
 const bool ActionSet::contains(const ActionType & action) const
 {
-    return _actionTypes.contains(action);
+    return action.getRace() == _race && ((_bits[action.ID() / WordBits] >> (action.ID() % WordBits)) & 1);
 }
 
 void ActionSet::add(const ActionType & action)
 {
-    _actionTypes.push_back(action);
+    BOSS_ASSERT(isEmpty() || action.getRace() == _race, "Can't add an action of another race to an ActionSet");
+
+    _race = action.getRace();
+    _bits[action.ID() / WordBits] |= (Word)1 << (action.ID() % WordBits);
+}
+
+void ActionSet::add(const ActionSet & set)
+{
+    if (set.isEmpty())
+    {
+        return;
+    }
+
+    BOSS_ASSERT(isEmpty() || set._race == _race, "Can't add actions of another race to an ActionSet");
+
+    _race = set._race;
+    for (size_t w(0); w < NumWords; ++w)
+    {
+        _bits[w] |= set._bits[w];
+    }
+}
+
+void ActionSet::addAllActions(const RaceID & race)
+{
+    add(GetAllActions(race));
 }
 
 void ActionSet::remove(const ActionType & action)
 {
-    for (size_t i(0); i<_actionTypes.size(); ++i)
+    if (action.getRace() == _race)
     {
-        if (_actionTypes[i] == action)
-        {
-            _actionTypes.removeByShift(i);
-            return;
-        }
+        _bits[action.ID() / WordBits] &= ~((Word)1 << (action.ID() % WordBits));
+    }
+}
+
+void ActionSet::remove(const ActionSet & set)
+{
+    if (set._race != _race)
+    {
+        return;
+    }
+
+    for (size_t w(0); w < NumWords; ++w)
+    {
+        _bits[w] &= ~set._bits[w];
     }
 }
 
 void ActionSet::clear()
 {
-    _actionTypes.clear();
-}
\ No newline at end of file
+    for (size_t w(0); w < NumWords; ++w)
+    {
+        _bits[w] = 0;
+    }
+}
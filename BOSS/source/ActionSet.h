@@ -2,31 +2,121 @@
 
 #include "Common.h"
 #include "Constants.h"
-#include "Array.hpp"
 #include "ActionType.h"
 
+#include <bitset>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 namespace BOSS
 {
 
+// A set of action types of one race, held as a bitset of their IDs, so adding, removing, contains,
+// union and difference are a few instructions and a set is cheap to copy. The actions are visited,
+// and indexed, in order of ID.
 class ActionSet
 {
-	Vec<ActionType, Constants::MAX_ACTION_TYPES> _actionTypes;
+    typedef unsigned long long Word;
+
+    static const size_t WordBits = 64;
+    static const size_t NumWords = 2;
+
+    static_assert(Constants::MAX_ACTION_TYPES <= NumWords * WordBits, "ActionSet has too few bits for MAX_ACTION_TYPES");
+
+    Word    _bits[NumWords];
+    RaceID  _race;
+
+    static size_t PopCount(const Word word)
+    {
+        return std::bitset<WordBits>(word).count();
+    }
+
+    // the index of the lowest set bit, the word must not be 0
+    static size_t LowestBit(const Word word)
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        if (_BitScanForward(&index, (unsigned long)word))
+        {
+            return index;
+        }
+
+        _BitScanForward(&index, (unsigned long)(word >> 32));
+        return index + 32;
+#else
+        return __builtin_ctzll(word);
+#endif
+    }
 
 public:
 
-	ActionSet();
+    // visits the actions in order of ID
+    class const_iterator
+    {
+        const ActionSet *   _set;
+        size_t              _word;
+        Word                _remaining;     // the bits of _word not visited yet
+
+        void skipEmptyWords()
+        {
+            while (_remaining == 0 && ++_word < NumWords)
+            {
+                _remaining = _set->_bits[_word];
+            }
+        }
+
+    public:
+
+        const_iterator(const ActionSet * set, const size_t word)
+            : _set(set)
+            , _word(word)
+            , _remaining(word < NumWords ? set->_bits[word] : 0)
+        {
+            if (_word < NumWords)
+            {
+                skipEmptyWords();
+            }
+        }
+
+        ActionType operator * () const
+        {
+            return ActionType(_set->_race, (ActionID)(_word * WordBits + LowestBit(_remaining)));
+        }
+
+        const_iterator & operator ++ ()
+        {
+            _remaining &= _remaining - 1;
+            skipEmptyWords();
+            return *this;
+        }
+
+        bool operator != (const const_iterator & rhs) const
+        {
+            return _word != rhs._word || _remaining != rhs._remaining;
+        }
+    };
+
+    ActionSet();
 
     const size_t size() const;
     const bool isEmpty() const;
     const bool contains(const ActionType & type) const;
+    const RaceID getRace() const;
+
+    // the index-th action in order of ID
+    ActionType operator [] (const size_t & index) const;
 
-    const ActionType & operator [] (const size_t & index) const;
-    ActionType & operator [] (const size_t & index);
+    const_iterator begin() const;
+    const_iterator end() const;
 
     void add(const ActionType & action);
+    void add(const ActionSet & set);
     void addAllActions(const RaceID & race);
     void remove(const ActionType & action);
+    void remove(const ActionSet & set);
     void clear();
 };
 
-}
\ No newline at end of file
+}
@@ -439,9 +439,8 @@ void ActionTypeData::AddPrerequisites()
             ActionTypeData & typeData = allActionTypeDataVec[r][a];
 		    const PrerequisiteSet & pre = typeData.getPrerequisites();
 
-            for (size_t p(0); p<pre.size(); ++p)
+            for (const ActionType & preActionType : pre)
             {
-                const ActionType & preActionType = pre.getActionType(p);
 
                 // the addon has to be an addon of the building that construct the unit
                 if (preActionType.isAddon() && (preActionType.whatBuildsAction() == typeData.whatBuildsActionID))
@@ -579,9 +578,8 @@ void ActionTypeData::CalculateRecursivePrerequisites(PrerequisiteSet & allPre, c
         }
     }
 
-	for (size_t a(0); a < pre.size(); ++a)
+	for (const ActionType & actionType : pre)
     {
-        const ActionType & actionType = pre.getActionType(a);
 
         if (!allPre.contains(actionType))
         {
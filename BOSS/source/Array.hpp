@@ -9,36 +9,46 @@ template <class T,size_t max_capacity>
 class Vec
 {
     size_t	_size;
-    size_t  _capacity;
     T		_arr[max_capacity];
 
 public:
 
     Vec<T,max_capacity>()
         : _size(0)
-        ,_capacity(max_capacity)
     {
 		BOSS_ASSERT(max_capacity>0, "Vec initializing with capacity = 0");
     }
 
+    // only the elements in use are copied, the search copies states which hold several mostly empty Vecs
+    Vec<T,max_capacity>(const Vec<T,max_capacity> & other)
+        : _size(other._size)
+    {
+        std::copy(other._arr, other._arr + other._size, _arr);
+    }
+
+    Vec<T,max_capacity> & operator = (const Vec<T,max_capacity> & other)
+    {
+        _size = other._size;
+        std::copy(other._arr, other._arr + other._size, _arr);
+        return *this;
+    }
+
     Vec<T,max_capacity>(const size_t & size)
         : _size(size)
-        ,_capacity(max_capacity)
     {
-        BOSS_ASSERT(size <= max_capacity,"Vec initializing with size > capacity, Size = %d, Capacity = %d",size,_capacity);
+        BOSS_ASSERT(size <= max_capacity,"Vec initializing with size > capacity, Size = %d, Capacity = %d",size,max_capacity);
     }
 
     Vec<T,max_capacity>(const size_t & size,const T & val)
         : _size(size)
-        ,_capacity(max_capacity)
     {
-        BOSS_ASSERT(size <= max_capacity,"Vec initializing with size > capacity, Size = %d, Capacity = %d",size,_capacity);
+        BOSS_ASSERT(size <= max_capacity,"Vec initializing with size > capacity, Size = %d, Capacity = %d",size,max_capacity);
         fill(val);
     }
     
     void resize(const size_t & size)
     {
-        BOSS_ASSERT(size <= max_capacity,"Vec resizing with size > capacity, Size = %d, Cpacity = %d",size,_capacity);
+        BOSS_ASSERT(size <= max_capacity,"Vec resizing with size > capacity, Size = %d, Cpacity = %d",size,max_capacity);
         _size = size;
     }
 
@@ -80,7 +90,7 @@ public:
     void addSorted(const T & e)
     {
         size_t index(0);
-        while (_arr[index] < e)
+        while (index < _size && _arr[index] < e)
         {
             ++index;
         }
@@ -100,7 +110,7 @@ public:
     void copyShiftRight(const size_t & index)
     {
         BOSS_ASSERT(_size < capacity(),"Array over capacity: Size = %d",capacity());
-        for (size_t i(_size + 1); i > index; --i)
+        for (size_t i(_size); i > index; --i)
         {
             _arr[i] = _arr[i-1];
         }
@@ -119,9 +129,9 @@ public:
         _size--;
     }
     
-    const size_t & capacity() const
+    size_t capacity() const
     {
-        return _capacity;
+        return max_capacity;
     }
 
     void push_back(const T & e)
@@ -131,11 +141,18 @@ public:
         ++_size;
     }
 
+    T & back()
+    {
+        BOSS_ASSERT(!empty(),"Vector back() with empty array");
+
+        return get(_size - 1);
+    }
+
     const T & back() const
     {
         BOSS_ASSERT(!empty(),"Vector back() with empty array");
 
-        return get(_size);
+        return get(_size - 1);
     }
 
     void remove(const size_t & index)
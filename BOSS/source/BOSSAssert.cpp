@@ -1,6 +1,8 @@
 #include "BOSSAssert.h"
 #include "BOSSException.h"
 
+#include <cstring>
+
 using namespace BOSS;
 
 namespace BOSS
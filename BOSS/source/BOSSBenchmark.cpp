@@ -0,0 +1,233 @@
+#include "BOSSBenchmark.h"
+
+#include "BOSSParameters.h"
+#include "Timer.hpp"
+#include "rapidjson/prettywriter.h"
+#include "rapidjson/stringbuffer.h"
+
+#include <fstream>
+
+using namespace BOSS;
+
+namespace
+{
+    typedef rapidjson::PrettyWriter<rapidjson::StringBuffer> JSONWriter;
+
+    class BenchmarkCase
+    {
+    public:
+        std::string                     name;
+        RaceID                          race;
+        FrameCountType                  startFrame;
+        DFBB_BuildOrderSearchResults    results;
+        double                          timeElapsed;    // all of it, with the search settings worked out by the smart search
+    };
+
+    BenchmarkCase RunCase(const rapidjson::Value & val, const int searchTimeLimit, const size_t numThreads)
+    {
+        BOSS_ASSERT(val.HasMember("Name") && val["Name"].IsString(), "Benchmark case has no 'Name' string");
+        BOSS_ASSERT(val.HasMember("State") && val["State"].IsString(), "Benchmark case has no 'State' string");
+        BOSS_ASSERT(val.HasMember("Goal") && val["Goal"].IsString(), "Benchmark case has no 'Goal' string");
+
+        BenchmarkCase benchmarkCase;
+        benchmarkCase.name = val["Name"].GetString();
+
+        // the start state is a state from the config, optionally with a build order done from it
+        GameState state(BOSSParameters::Instance().GetState(val["State"].GetString()));
+        if (val.HasMember("BuildOrder"))
+        {
+            BOSS_ASSERT(val["BuildOrder"].IsString(), "Benchmark case 'BuildOrder' is not a string");
+
+            const BuildOrder & buildOrder = BOSSParameters::Instance().GetBuildOrder(val["BuildOrder"].GetString());
+            const bool buildOrderIsLegal = buildOrder.doActions(state);
+
+            BOSS_ASSERT(buildOrderIsLegal, "Benchmark case %s: build order %s is not legal from its state", benchmarkCase.name.c_str(), val["BuildOrder"].GetString());
+        }
+
+        const BuildOrderSearchGoal & goal = BOSSParameters::Instance().GetBuildOrderSearchGoalMap(val["Goal"].GetString());
+
+        benchmarkCase.race = state.getRace();
+        benchmarkCase.startFrame = state.getCurrentFrame();
+
+        DFBB_BuildOrderSmartSearch search(state.getRace());
+        search.setState(state);
+        search.setGoal(goal);
+        search.setTimeLimit(searchTimeLimit);
+        search.setNumThreads(numThreads);
+
+        Timer timer;
+        timer.start();
+        search.search();
+
+        benchmarkCase.timeElapsed = timer.getElapsedTimeInMilliSec();
+        benchmarkCase.results = search.getResults();
+
+        return benchmarkCase;
+    }
+
+    void WriteCase(JSONWriter & writer, const BenchmarkCase & benchmarkCase)
+    {
+        const DFBB_BuildOrderSearchResults & results = benchmarkCase.results;
+
+        writer.StartObject();
+
+        writer.String("name");
+        writer.String(benchmarkCase.name.c_str());
+        writer.String("race");
+        writer.String(Races::GetRaceName(benchmarkCase.race).c_str());
+        writer.String("solved");
+        writer.Bool(results.solved);
+        writer.String("solutionFound");
+        writer.Bool(results.solutionFound);
+
+        // frames from the start state to the end of the best build order found
+        writer.String("makespan");
+        if (results.solutionFound)
+        {
+            writer.Int(results.upperBound - benchmarkCase.startFrame);
+        }
+        else
+        {
+            writer.Null();
+        }
+
+        writer.String("buildOrderLength");
+        writer.Uint64(results.buildOrder.size());
+        writer.String("lowerBound");
+        writer.Int(results.lowerBound - benchmarkCase.startFrame);
+        writer.String("nodes");
+        writer.Uint64(results.nodesExpanded);
+        writer.String("nodesPerSecond");
+        writer.Double(results.timeElapsed > 0 ? 1000.0 * results.nodesExpanded / results.timeElapsed : 0);
+
+        writer.String("timeToFirstSolutionMS");
+        if (results.solutionFound)
+        {
+            writer.Double(results.timeFirstSolution);
+        }
+        else
+        {
+            writer.Null();
+        }
+
+        writer.String("timeToProofMS");
+        if (results.solved)
+        {
+            writer.Double(benchmarkCase.timeElapsed);
+        }
+        else
+        {
+            writer.Null();
+        }
+
+        writer.String("timeElapsedMS");
+        writer.Double(benchmarkCase.timeElapsed);
+        writer.String("ttHitRate");
+        writer.Double(results.ttHitRate());
+        writer.String("ttCutoffRate");
+        writer.Double(results.ttCutoffRate());
+
+        writer.EndObject();
+    }
+
+    void WriteSuite(JSONWriter & writer, const std::string & name, const std::vector<BenchmarkCase> & cases)
+    {
+        size_t solved = 0;
+        unsigned long long nodes = 0;
+        double timeElapsed = 0;
+        double searchTime = 0;
+
+        for (const BenchmarkCase & benchmarkCase : cases)
+        {
+            solved += benchmarkCase.results.solved ? 1 : 0;
+            nodes += benchmarkCase.results.nodesExpanded;
+            timeElapsed += benchmarkCase.timeElapsed;
+            searchTime += benchmarkCase.results.timeElapsed;
+        }
+
+        writer.StartObject();
+
+        writer.String("name");
+        writer.String(name.c_str());
+        writer.String("cases");
+        writer.Uint64(cases.size());
+        writer.String("solved");
+        writer.Uint64(solved);
+        writer.String("nodes");
+        writer.Uint64(nodes);
+        writer.String("nodesPerSecond");
+        writer.Double(searchTime > 0 ? 1000.0 * nodes / searchTime : 0);
+        writer.String("timeElapsedMS");
+        writer.Double(timeElapsed);
+
+        writer.String("results");
+        writer.StartArray();
+        for (const BenchmarkCase & benchmarkCase : cases)
+        {
+            WriteCase(writer, benchmarkCase);
+        }
+        writer.EndArray();
+
+        writer.EndObject();
+    }
+}
+
+void Benchmark::RunBenchmark(const std::string & benchmarkFilename, const std::string & resultsFilename, const size_t numThreads)
+{
+    // the states, build orders and goals the cases refer to
+    BOSSParameters::Instance().ParseParameters(benchmarkFilename);
+
+    rapidjson::Document document;
+    JSONTools::ParseJSONFile(document, benchmarkFilename);
+
+    BOSS_ASSERT(document.HasMember("Benchmark"), "No 'Benchmark' member found");
+    const rapidjson::Value & benchmark = document["Benchmark"];
+
+    BOSS_ASSERT(benchmark.HasMember("SearchTimeLimitMS") && benchmark["SearchTimeLimitMS"].IsInt(), "Benchmark must have a 'SearchTimeLimitMS' int");
+    BOSS_ASSERT(benchmark.HasMember("Suites") && benchmark["Suites"].IsObject(), "Benchmark must have a 'Suites' object");
+
+    const int searchTimeLimit = benchmark["SearchTimeLimitMS"].GetInt();
+
+    rapidjson::StringBuffer buffer;
+    JSONWriter writer(buffer);
+
+    writer.StartObject();
+    writer.String("searchTimeLimitMS");
+    writer.Int(searchTimeLimit);
+    writer.String("threads");
+    writer.Uint64(numThreads);
+
+    writer.String("suites");
+    writer.StartArray();
+
+    printf("%-10s%-32s%8s%10s%14s%12s\n", "Suite", "Case", "Result", "Makespan", "Nodes", "Time (ms)");
+
+    const rapidjson::Value & suites = benchmark["Suites"];
+    for (rapidjson::Value::ConstMemberIterator itr = suites.MemberBegin(); itr != suites.MemberEnd(); ++itr)
+    {
+        const std::string &         name = itr->name.GetString();
+        const rapidjson::Value &    val  = itr->value;
+
+        BOSS_ASSERT(val.IsArray(), "Benchmark suite %s is not an array of cases", name.c_str());
+
+        std::vector<BenchmarkCase> cases;
+        for (size_t i(0); i < val.Size(); ++i)
+        {
+            cases.push_back(RunCase(val[i], searchTimeLimit, numThreads));
+
+            const BenchmarkCase & benchmarkCase = cases.back();
+            printf("%-10s%-32s%8s%10d%14llu%12.2lf\n", name.c_str(), benchmarkCase.name.c_str(), benchmarkCase.results.solved ? "solved" : "timeout",
+                benchmarkCase.results.upperBound - benchmarkCase.startFrame, benchmarkCase.results.nodesExpanded, benchmarkCase.timeElapsed);
+        }
+
+        WriteSuite(writer, name, cases);
+    }
+
+    writer.EndArray();
+    writer.EndObject();
+
+    std::ofstream resultsFile(resultsFilename.c_str());
+    BOSS_ASSERT(resultsFile.is_open(), "Couldn't open results file: %s", resultsFilename.c_str());
+
+    resultsFile << buffer.GetString() << std::endl;
+}
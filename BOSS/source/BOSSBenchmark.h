@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Common.h"
+#include "JSONTools.h"
+#include "rapidjson/rapidjson.h"
+#include "rapidjson/document.h"
+
+namespace BOSS
+{
+
+// Runs DFBB_BuildOrderSmartSearch on fixed suites of start states and goals, so that changes to the
+// search can be compared by their results. The suites are read from a config file which also holds the
+// states, build orders and goals they refer to, in the format of BOSSParameters. Each case reports its
+// makespan, nodes per second, and the time to the first solution and to the proof that the best one
+// found is optimal, and all of it is written to a results file as JSON.
+namespace Benchmark
+{
+    void RunBenchmark(const std::string & benchmarkFilename, const std::string & resultsFilename, const size_t numThreads);
+}
+
+}
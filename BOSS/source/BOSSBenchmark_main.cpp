@@ -0,0 +1,30 @@
+#include "BOSS.h"
+#include "BOSSBenchmark.h"
+
+using namespace BOSS;
+
+// BOSS_Benchmark [benchmark config] [results file] [threads]
+int main(int argc, char *argv[])
+{
+    const std::string benchmarkFile = argc > 1 ? argv[1] : "BOSS_Benchmark.txt";
+    const std::string resultsFile   = argc > 2 ? argv[2] : "BOSS_Benchmark_Results.json";
+    const size_t numThreads         = argc > 3 ? (size_t)atoi(argv[3]) : 1;
+
+    try
+    {
+        // the benchmark builds against the bwapidata copy of BWAPI, whose types have to be set up first
+        BWAPI::BWAPI_init();
+
+        // Initialize all the BOSS internal data
+        BOSS::init();
+
+        BOSS::Benchmark::RunBenchmark(benchmarkFile, resultsFile, numThreads);
+    }
+    catch (const BOSSException & e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
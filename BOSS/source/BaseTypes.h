@@ -8,4 +8,5 @@ namespace BOSS
     typedef 	unsigned short  UnitCountType;
     typedef     unsigned char   ActionID;
     typedef     unsigned char   RaceID;
+    typedef     unsigned long long HashType;
 }
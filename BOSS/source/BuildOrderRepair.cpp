@@ -0,0 +1,232 @@
+#include "BuildOrderRepair.h"
+
+#include <limits>
+
+using namespace BOSS;
+
+namespace
+{
+    // each pass of the local search tries every removal and every swap once
+    const size_t MaxImprovementPasses = 3;
+
+    const FrameCountType NotAchieved = std::numeric_limits<FrameCountType>::max();
+}
+
+BuildOrderRepair::BuildOrderRepair(const GameState & state, const BuildOrderSearchGoal & goal)
+    : _state(state)
+    , _goal(goal)
+    , _completionTime(NotAchieved)
+{
+
+}
+
+bool BuildOrderRepair::repair(const GameState & planState, const BuildOrder & plan)
+{
+    _buildOrder.clear();
+    _completionTime = NotAchieved;
+
+    if (planState.getRace() != _state.getRace())
+    {
+        return false;
+    }
+
+    BuildOrder remaining;
+    fastForward(planState, plan, remaining);
+
+    BuildOrder prefix;
+    keepLegalPrefix(remaining, prefix);
+
+    // whatever the goal still wants after the old build order is made naively. The naive search gives up
+    // on states it can't make a worker or supply from right away, like a zerg state out of larva, so less
+    // of the old build order is kept until it can finish it.
+    for (size_t length(prefix.size()); _completionTime == NotAchieved; length /= 2)
+    {
+        BuildOrder buildOrder;
+        GameState state(_state);
+        for (size_t i(0); i < length; ++i)
+        {
+            buildOrder.add(prefix[i]);
+            state.doAction(prefix[i]);
+        }
+
+        NaiveBuildOrderSearch naiveSearch(state, _goal);
+        buildOrder.add(naiveSearch.solve());
+
+        _completionTime = evaluate(buildOrder);
+        if (_completionTime != NotAchieved)
+        {
+            _buildOrder = buildOrder;
+        }
+        else if (length == 0)
+        {
+            return false;
+        }
+    }
+
+    for (size_t pass(0); pass < MaxImprovementPasses && improve(); ++pass)
+    {
+    }
+
+    return true;
+}
+
+// drops the actions of the plan which the state has done since planState
+void BuildOrderRepair::fastForward(const GameState & planState, const BuildOrder & plan, BuildOrder & remaining) const
+{
+    const RaceID race = _state.getRace();
+    const ActionType & worker = ActionTypes::GetWorker(race);
+    const size_t numActions = ActionTypes::GetAllActionTypes(race).size();
+
+    std::vector<int> done(numActions, 0);
+    for (ActionID a(0); a < numActions; ++a)
+    {
+        const ActionType & action = ActionTypes::GetActionType(race, a);
+        done[a] = std::max(0, (int)_state.getUnitData().getNumTotal(action) - (int)planState.getUnitData().getNumTotal(action));
+    }
+
+    // a zerg building uses up the drone which made it, so those drones were made too
+    if (race == Races::Zerg)
+    {
+        for (ActionID a(0); a < numActions; ++a)
+        {
+            const ActionType & action = ActionTypes::GetActionType(race, a);
+            if (action.whatBuildsActionType().isWorker() && !action.isMorphed())
+            {
+                done[worker.ID()] += done[a];
+            }
+        }
+    }
+
+    for (size_t i(0); i < plan.size(); ++i)
+    {
+        if (done[plan[i].ID()] > 0)
+        {
+            done[plan[i].ID()]--;
+        }
+        else
+        {
+            remaining.add(plan[i]);
+        }
+    }
+}
+
+// keeps the rest of the old build order up to its first action which isn't legal any more, adding supply where it
+// runs short the way NaiveBuildOrderSearch does, and leaving out goal units the new goal has enough of
+void BuildOrderRepair::keepLegalPrefix(const BuildOrder & remaining, BuildOrder & prefix) const
+{
+    GameState prefixState(_state);
+    const ActionType & supplyProvider = ActionTypes::GetSupplyProvider(prefixState.getRace());
+
+    for (size_t i(0); i < remaining.size(); ++i)
+    {
+        const ActionType & action = remaining[i];
+        const UnitCountType total = prefixState.getUnitData().getNumTotal(action);
+        const UnitCountType goal = _goal.getGoal(action);
+        const UnitCountType goalMax = _goal.getGoalMax(action);
+
+        if ((goal > 0 && total >= goal) || (goalMax > 0 && total >= goalMax))
+        {
+            continue;
+        }
+
+        const UnitData & units = prefixState.getUnitData();
+        if (!action.isMorphed() && !action.isSupplyProvider() && (action.supplyRequired() > (units.getMaxSupply() + units.getSupplyInProgress() - units.getCurrentSupply())))
+        {
+            if (!prefixState.isLegal(supplyProvider))
+            {
+                return;
+            }
+
+            prefix.add(supplyProvider);
+            prefixState.doAction(supplyProvider);
+        }
+
+        if (!prefixState.isLegal(action))
+        {
+            return;
+        }
+
+        prefix.add(action);
+        prefixState.doAction(action);
+    }
+}
+
+// one pass of the local search, returns whether it found anything better
+bool BuildOrderRepair::improve()
+{
+    bool improved = false;
+
+    // an action which can go without finishing the goal any later is left out
+    for (size_t i(0); i < _buildOrder.size(); )
+    {
+        BuildOrder candidate;
+        for (size_t j(0); j < _buildOrder.size(); ++j)
+        {
+            if (j != i)
+            {
+                candidate.add(_buildOrder[j]);
+            }
+        }
+
+        const FrameCountType completionTime = evaluate(candidate);
+        if (completionTime <= _completionTime)
+        {
+            improved = improved || completionTime < _completionTime;
+            _buildOrder = candidate;
+            _completionTime = completionTime;
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    // an action is moved one place earlier if that finishes the goal sooner
+    for (size_t i(1); i < _buildOrder.size(); ++i)
+    {
+        if (_buildOrder[i] == _buildOrder[i-1])
+        {
+            continue;
+        }
+
+        BuildOrder candidate(_buildOrder);
+        std::swap(candidate[i], candidate[i-1]);
+
+        const FrameCountType completionTime = evaluate(candidate);
+        if (completionTime < _completionTime)
+        {
+            improved = true;
+            _buildOrder = candidate;
+            _completionTime = completionTime;
+        }
+    }
+
+    return improved;
+}
+
+// the frame the build order finishes the goal, or NotAchieved if it isn't legal or doesn't achieve the goal
+FrameCountType BuildOrderRepair::evaluate(const BuildOrder & buildOrder)
+{
+    GameState state(_state);
+    if (!buildOrder.doActions(state))
+    {
+        return NotAchieved;
+    }
+
+    if (!_goal.isAchievedBy(state))
+    {
+        return NotAchieved;
+    }
+
+    return state.getLastActionFinishTime();
+}
+
+const BuildOrder & BuildOrderRepair::getBuildOrder() const
+{
+    return _buildOrder;
+}
+
+FrameCountType BuildOrderRepair::getCompletionTime() const
+{
+    return _completionTime;
+}
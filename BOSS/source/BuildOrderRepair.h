@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Common.h"
+#include "BuildOrderSearchGoal.h"
+#include "GameState.h"
+#include "BuildOrder.h"
+#include "NaiveBuildOrderSearch.h"
+
+namespace BOSS
+{
+
+// Reuses a build order found for an earlier goal from an earlier state, when a new goal which is often
+// much the same is wanted from a state a few actions later. What the state has done of the old build
+// order since it was planned is dropped, what is left is kept as long as it stays legal, and a naive
+// build order for what the goal still wants is added to the end. A local search then tries dropping
+// each action and moving each action earlier, keeping the changes which finish the goal sooner.
+class BuildOrderRepair
+{
+    GameState                   _state;
+    BuildOrderSearchGoal        _goal;
+    BuildOrder                  _buildOrder;
+    FrameCountType              _completionTime;
+
+    void                        fastForward(const GameState & planState, const BuildOrder & plan, BuildOrder & remaining) const;
+    void                        keepLegalPrefix(const BuildOrder & remaining, BuildOrder & prefix) const;
+    bool                        improve();
+    FrameCountType              evaluate(const BuildOrder & buildOrder);
+
+public:
+
+    BuildOrderRepair(const GameState & state, const BuildOrderSearchGoal & goal);
+
+    // plan is the build order found from planState; returns whether the repaired build order achieves the goal
+    bool                        repair(const GameState & planState, const BuildOrder & plan);
+
+    const BuildOrder &          getBuildOrder() const;
+    FrameCountType              getCompletionTime() const;
+};
+
+}
@@ -35,9 +35,8 @@ void CombatSearch::generateLegalActions(const GameState & state, ActionSet & leg
 {
     // prune actions we have too many of already
     const ActionSet & allActions = params.getRelevantActions();
-    for (ActionID a(0); a<allActions.size(); ++a)
+    for (const ActionType & action : allActions)
     {
-        const ActionType & action = allActions[a];
         bool isLegal = state.isLegal(action);
 
         if (!isLegal)
@@ -72,9 +71,8 @@ void CombatSearch::generateLegalActions(const GameState & state, ActionSet & leg
         }
 
         // figure out of anything can be made before a worker
-        for (size_t a(0); a < legalActions.size(); ++a)
+        for (const ActionType & actionType : legalActions)
         {
-            const ActionType & actionType = legalActions[a];
             const FrameCountType whenCanPerformAction = state.whenCanPerform(actionType);
             if (whenCanPerformAction < workerReady)
             {
@@ -24,8 +24,6 @@ namespace BOSS
 
         const size_t MAX_OF_ACTION          = 200;
 
-        const size_t NUM_HASHES             = 2;
-
         const size_t MPWPF                  = 45;
 
         const size_t GPWPF                  = 70;
@@ -0,0 +1,372 @@
+#include "DFBB_BuildOrderParallelSearch.h"
+
+#include <exception>
+#include <thread>
+
+using namespace BOSS;
+
+namespace
+{
+    // the tree is split level by level until there are this many tasks per worker, or this deep
+    const size_t TasksPerWorker = 4;
+    const size_t MaxSplitDepth  = 3;
+}
+
+DFBB_SharedSearchData::DFBB_SharedSearchData(size_t workers, int initialUpperBound)
+    : _queuedTasks(0)
+    , _pendingTasks(0)
+    , _idleWorkers(0)
+    , _stopped(false)
+    , upperBound(initialUpperBound)
+{
+    for (size_t i(0); i < workers; ++i)
+    {
+        _queues.push_back(std::unique_ptr<TaskQueue>(new TaskQueue()));
+    }
+
+    results.upperBound = initialUpperBound;
+}
+
+void DFBB_SharedSearchData::push(size_t worker, std::vector<DFBB_SearchTask> & tasks)
+{
+    // count them first, so that no worker thinks the search is over while they're on their way
+    _pendingTasks += (int)tasks.size();
+
+    std::lock_guard<std::mutex> lock(_queues[worker]->mutex);
+    for (DFBB_SearchTask & task : tasks)
+    {
+        _queues[worker]->tasks.push_back(task);
+    }
+    _queuedTasks += (int)tasks.size();
+}
+
+bool DFBB_SharedSearchData::pop(size_t worker, DFBB_SearchTask & task)
+{
+    // our own tasks first, in order
+    {
+        std::lock_guard<std::mutex> lock(_queues[worker]->mutex);
+        if (!_queues[worker]->tasks.empty())
+        {
+            task = _queues[worker]->tasks.front();
+            _queues[worker]->tasks.pop_front();
+            _queuedTasks--;
+            return true;
+        }
+    }
+
+    // then steal the last task of another worker
+    for (size_t i(1); i < _queues.size(); ++i)
+    {
+        TaskQueue & queue = *_queues[(worker + i) % _queues.size()];
+
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty())
+        {
+            task = queue.tasks.back();
+            queue.tasks.pop_back();
+            _queuedTasks--;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool DFBB_SharedSearchData::isIdleWorkerWaiting() const
+{
+    return _idleWorkers > 0 && _queuedTasks == 0;
+}
+
+bool DFBB_SharedSearchData::hasPendingTasks() const
+{
+    return _pendingTasks > 0;
+}
+
+int DFBB_SharedSearchData::queuedLowerBound()
+{
+    int lowerBound = upperBound;
+    for (auto & queue : _queues)
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        for (const DFBB_SearchTask & task : queue->tasks)
+        {
+            lowerBound = std::min(lowerBound, (int)task.lowerBound);
+        }
+    }
+
+    return lowerBound;
+}
+
+bool DFBB_SharedSearchData::waitForTask(size_t worker, DFBB_SearchTask & task)
+{
+    _idleWorkers++;
+
+    while (!_stopped && _pendingTasks > 0)
+    {
+        if (_queuedTasks > 0 && pop(worker, task))
+        {
+            _idleWorkers--;
+            return true;
+        }
+
+        std::this_thread::yield();
+    }
+
+    _idleWorkers--;
+    return false;
+}
+
+void DFBB_SharedSearchData::finishTask()
+{
+    _pendingTasks--;
+}
+
+void DFBB_SharedSearchData::stop()
+{
+    _stopped = true;
+}
+
+void DFBB_SharedSearchData::restart()
+{
+    _stopped = false;
+}
+
+DFBB_BuildOrderParallelSearch::DFBB_BuildOrderParallelSearch(const DFBB_BuildOrderSearchParameters & p)
+    : _params(p)
+    , _firstSearch(true)
+    , _timeSearched(0)
+{
+}
+
+void DFBB_BuildOrderParallelSearch::setTimeLimit(double ms)
+{
+    _params.searchTimeLimit = ms;
+}
+
+const DFBB_BuildOrderSearchResults & DFBB_BuildOrderParallelSearch::getResults() const
+{
+    return _results;
+}
+
+// sets up the workers and splits the tree into their first tasks
+void DFBB_BuildOrderParallelSearch::startSearch()
+{
+    const size_t numWorkers = std::max((size_t)1, _params.numThreads);
+
+    if (numWorkers == 1)
+    {
+        _workers.push_back(std::unique_ptr<DFBB_BuildOrderStackSearch>(new DFBB_BuildOrderStackSearch(_params)));
+        return;
+    }
+
+    int upperBound = _params.initialUpperBound ? _params.initialUpperBound : Tools::GetUpperBound(_params.initialState, _params.goal);
+
+    // add one frame to the upper bound so our strictly lesser than check still works if we have an exact upper bound
+    _shared.reset(new DFBB_SharedSearchData(numWorkers, upperBound + 1));
+
+    for (size_t i(0); i < numWorkers; ++i)
+    {
+        _workers.push_back(std::unique_ptr<DFBB_BuildOrderStackSearch>(new DFBB_BuildOrderStackSearch(_params, _shared.get(), i)));
+    }
+
+    // this runs on the calling thread, which also gets the lazily initialized data of BOSS
+    // initialized before there are other threads
+    std::vector<DFBB_SearchTask> tasks(1);
+    tasks[0].state = _params.initialState;
+
+    for (size_t depth(0); depth < MaxSplitDepth && !tasks.empty() && tasks.size() < numWorkers * TasksPerWorker; ++depth)
+    {
+        std::vector<DFBB_SearchTask> children;
+        for (const DFBB_SearchTask & task : tasks)
+        {
+            _workers[0]->expandTask(task, children);
+        }
+
+        tasks.swap(children);
+    }
+
+    // deal them out in order, so that every worker starts on the leftmost subtrees, where the
+    // move ordering puts the good solutions that tighten the bound for the others
+    std::vector<std::vector<DFBB_SearchTask>> dealt(numWorkers);
+    for (size_t t(0); t < tasks.size(); ++t)
+    {
+        dealt[t % numWorkers].push_back(tasks[t]);
+    }
+
+    for (size_t i(0); i < numWorkers; ++i)
+    {
+        _shared->push(i, dealt[i]);
+    }
+}
+
+void DFBB_BuildOrderParallelSearch::search()
+{
+    _searchTimer.start();
+    _searchStart = std::chrono::steady_clock::now();
+
+    if (_results.solved)
+    {
+        return;
+    }
+
+    if (_firstSearch)
+    {
+        startSearch();
+        _firstSearch = false;
+    }
+
+    if (!_shared)
+    {
+        _workers[0]->setTimeLimit(_params.searchTimeLimit);
+        _workers[0]->search();
+        collectResults();
+        return;
+    }
+
+    _shared->restart();
+    _shared->searchStart = _searchStart;
+
+    // a BOSSException must not escape a thread, so it's passed on to the caller like the serial search would throw it
+    std::exception_ptr exception;
+    std::mutex exceptionMutex;
+
+    std::vector<std::thread> threads;
+    for (size_t i(1); i < _workers.size(); ++i)
+    {
+        threads.push_back(std::thread([this, i, &exception, &exceptionMutex]()
+        {
+            try
+            {
+                runWorker(i);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(exceptionMutex);
+                exception = std::current_exception();
+                _shared->stop();
+            }
+        }));
+    }
+
+    try
+    {
+        runWorker(0);
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(exceptionMutex);
+        exception = std::current_exception();
+        _shared->stop();
+    }
+
+    for (std::thread & thread : threads)
+    {
+        thread.join();
+    }
+
+    collectResults();
+
+    if (exception)
+    {
+        std::rethrow_exception(exception);
+    }
+}
+
+void DFBB_BuildOrderParallelSearch::runWorker(size_t worker)
+{
+    DFBB_BuildOrderStackSearch & search = *_workers[worker];
+
+    while (true)
+    {
+        // a task which timed out in the last search() call is resumed, otherwise the worker gets a new one
+        if (!search.getResults().timedOut)
+        {
+            DFBB_SearchTask task;
+            if (!_shared->waitForTask(worker, task))
+            {
+                return;
+            }
+
+            search.startTask(task);
+        }
+
+        if (_params.searchTimeLimit)
+        {
+            double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _searchStart).count();
+            search.setTimeLimit(std::max(1.0, _params.searchTimeLimit - elapsed));
+        }
+
+        search.search();
+
+        if (search.getResults().timedOut)
+        {
+            _shared->stop();
+            return;
+        }
+
+        _shared->finishTask();
+    }
+}
+
+void DFBB_BuildOrderParallelSearch::collectResults()
+{
+    const bool hadSolution = _results.solutionFound;
+    const double timeFirstSolution = _results.timeFirstSolution;
+
+    if (!_shared)
+    {
+        _results = _workers[0]->getResults();
+    }
+    else
+    {
+        collectSharedResults();
+    }
+
+    // the workers time the first solution from the start of the call which found it
+    if (hadSolution)
+    {
+        _results.timeFirstSolution = timeFirstSolution;
+    }
+    else if (_results.solutionFound)
+    {
+        _results.timeFirstSolution += _timeSearched;
+    }
+
+    _timeSearched += _results.timeElapsed;
+}
+
+void DFBB_BuildOrderParallelSearch::collectSharedResults()
+{
+    {
+        std::lock_guard<std::mutex> lock(_shared->resultsMutex);
+        _results = _shared->results;
+    }
+
+    _results.nodesExpanded = 0;
+    _results.ttProbes = 0;
+    _results.ttHits = 0;
+    _results.ttCutoffs = 0;
+
+    for (const auto & worker : _workers)
+    {
+        _results.nodesExpanded += worker->getResults().nodesExpanded;
+        _results.ttProbes += worker->getResults().ttProbes;
+        _results.ttHits += worker->getResults().ttHits;
+        _results.ttCutoffs += worker->getResults().ttCutoffs;
+    }
+
+    _results.timedOut = _shared->hasPendingTasks();
+    _results.solved = !_results.timedOut;
+
+    // what's left is the queued tasks and the tasks the workers stopped in
+    _results.lowerBound = _shared->queuedLowerBound();
+    for (const auto & worker : _workers)
+    {
+        if (worker->getResults().timedOut)
+        {
+            _results.lowerBound = std::min(_results.lowerBound, worker->getResults().lowerBound);
+        }
+    }
+    _results.lowerBound = std::min(_results.lowerBound, _results.upperBound);
+    _results.timeElapsed = _searchTimer.getElapsedTimeInMilliSec();
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Common.h"
+#include "DFBB_BuildOrderStackSearch.h"
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+namespace BOSS
+{
+
+// What the workers of a parallel search share: the best solution so far, whose makespan bounds
+// every worker's search, and a queue of tasks per worker. A worker takes its own tasks from the
+// front and steals other workers' tasks from the back. A worker which runs out of tasks waits,
+// and the busy workers split off the untried children of their shallowest open node for it.
+class DFBB_SharedSearchData
+{
+    class TaskQueue
+    {
+    public:
+        std::mutex                          mutex;
+        std::deque<DFBB_SearchTask>         tasks;
+    };
+
+    std::vector<std::unique_ptr<TaskQueue>> _queues;
+    std::atomic<int>                        _queuedTasks;
+    std::atomic<int>                        _pendingTasks;          // queued or being searched
+    std::atomic<int>                        _idleWorkers;
+    std::atomic<bool>                       _stopped;
+
+public:
+
+    std::atomic<int>                        upperBound;
+    std::chrono::steady_clock::time_point   searchStart;            // of the current search() call
+    std::mutex                              resultsMutex;           // guards results
+    DFBB_BuildOrderSearchResults            results;
+
+    DFBB_SharedSearchData(size_t workers, int initialUpperBound);
+
+    void push(size_t worker, std::vector<DFBB_SearchTask> & tasks);
+    bool pop(size_t worker, DFBB_SearchTask & task);
+    bool isIdleWorkerWaiting() const;
+    bool hasPendingTasks() const;
+
+    // the smallest lower bound of the tasks nobody has started on
+    int queuedLowerBound();
+
+    // a worker without a task waits here until it gets one, and gets false once there is nothing left
+    // to search or the search was stopped
+    bool waitForTask(size_t worker, DFBB_SearchTask & task);
+    void finishTask();
+
+    // stops the waiting workers, when a worker times out; the unfinished tasks stay pending for the next search() call
+    void stop();
+    void restart();
+};
+
+// Runs DFBB_BuildOrderStackSearch on DFBB_BuildOrderSearchParameters::numThreads threads.
+// The tree is split a few levels below the root into tasks, each worker searches its tasks with
+// its own stack and transposition table, and idle workers steal or are given more.
+// With one thread it is the plain DFBB_BuildOrderStackSearch, run on the calling thread.
+class DFBB_BuildOrderParallelSearch
+{
+    DFBB_BuildOrderSearchParameters                         _params;
+    DFBB_BuildOrderSearchResults                            _results;
+
+    Timer                                                   _searchTimer;
+    std::chrono::steady_clock::time_point                   _searchStart;           // Timer isn't safe to read from the workers
+
+    std::unique_ptr<DFBB_SharedSearchData>                  _shared;
+    std::vector<std::unique_ptr<DFBB_BuildOrderStackSearch>> _workers;
+
+    bool                                                    _firstSearch;
+    double                                                  _timeSearched;          // in the earlier search() calls
+
+    void                                startSearch();
+    void                                runWorker(size_t worker);
+    void                                collectResults();
+    void                                collectSharedResults();
+
+public:
+
+    DFBB_BuildOrderParallelSearch(const DFBB_BuildOrderSearchParameters & p);
+
+    void setTimeLimit(double ms);
+    void search();
+    const DFBB_BuildOrderSearchResults & getResults() const;
+};
+
+}
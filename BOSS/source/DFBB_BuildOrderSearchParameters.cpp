@@ -12,6 +12,8 @@ DFBB_BuildOrderSearchParameters::DFBB_BuildOrderSearchParameters(const RaceID &
     , supplyBoundingThreshold(1)
     , useLandmarkLowerBoundHeuristic(true)
     , useResourceLowerBoundHeuristic(true)
+    , transpositionTableBits(16)
+    , numThreads(1)
     , searchTimeLimit(0)
     , initialUpperBound(0)
     , repetitionValues(Constants::MAX_ACTIONS, 1)
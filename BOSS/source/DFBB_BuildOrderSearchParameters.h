@@ -71,6 +71,18 @@ public:
     bool useLandmarkLowerBoundHeuristic;
     bool useResourceLowerBoundHeuristic;
 
+    //      Size of the transposition table, as a power of two
+    //      The table stores states the search has reached, so that it can prune states which were
+    //          already reached through a different ordering of the same actions, with at least as
+    //          many resources. Each entry takes 24 bytes. Set to zero to search without the table.
+    size_t transpositionTableBits;
+
+    //      Number of threads to search on
+    //      With more than one, DFBB_BuildOrderParallelSearch splits the tree into subtrees which
+    //          are searched in parallel, sharing the upper bound. The makespan found is the same,
+    //          but the build order may be a different one of the same length.
+    size_t numThreads;
+
     //      Search time limit measured in milliseconds
     //      If searchTimeLimit is set to a value greater than zero, the search will effectively
     //          time out and the best solution so far will be used in the results. This is
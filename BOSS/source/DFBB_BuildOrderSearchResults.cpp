@@ -7,14 +7,29 @@ DFBB_BuildOrderSearchResults::DFBB_BuildOrderSearchResults()
     , timedOut(false)
     , solutionFound(false)
     , upperBound(0)
+    , lowerBound(0)
     , nodesExpanded(0)
+    , ttProbes(0)
+    , ttHits(0)
+    , ttCutoffs(0)
     , timeElapsed(0)
+    , timeFirstSolution(0)
 {
 }
 
+double DFBB_BuildOrderSearchResults::ttHitRate() const
+{
+    return ttProbes ? (double)ttHits / ttProbes : 0;
+}
+
+double DFBB_BuildOrderSearchResults::ttCutoffRate() const
+{
+    return ttProbes ? (double)ttCutoffs / ttProbes : 0;
+}
+
 void DFBB_BuildOrderSearchResults::printResults(bool pbo) const
 {
-    printf("%12d%14llu%12.2lf       ",upperBound,nodesExpanded,timeElapsed);
+    printf("%12d%14llu%12.2lf%8.1lf%%%8.1lf%%       ",upperBound,nodesExpanded,timeElapsed,100*ttHitRate(),100*ttCutoffRate());
 
     if (pbo)
     {
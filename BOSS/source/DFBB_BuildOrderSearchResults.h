@@ -19,16 +19,25 @@ public:
     bool                        solutionFound;  // did we find any solution
 	
 	int					        upperBound;		// upper bound of first node
+	int					        lowerBound;		// no solution in the part of the tree left to search is shorter than this
 	
 	unsigned long long 	        nodesExpanded;	// number of nodes expanded in the search
+
+	unsigned long long          ttProbes;       // transposition table lookups
+	unsigned long long          ttHits;         // lookups which found a state with the same key
+	unsigned long long          ttCutoffs;      // lookups which pruned a dominated state
 	
 	double 				        timeElapsed;	// time elapsed in milliseconds
+	double                      timeFirstSolution;  // milliseconds into the search, over all its calls, when the first solution was found
 
     GameState                   finalState;
 	
 	DFBB_BuildOrderSearchResults();
 	DFBB_BuildOrderSearchResults(bool s, int len, unsigned long long n, double t, std::vector<ActionType> solution);
 		
+	double                      ttHitRate() const;
+	double                      ttCutoffRate() const;
+
 	void printResults(bool pbo = true) const;
 	void printBuildOrder() const;
 };
@@ -6,8 +6,10 @@ DFBB_BuildOrderSmartSearch::DFBB_BuildOrderSmartSearch(const RaceID race)
     : _race(race)
     , _params(race)
     , _goal(race)
-    , _stackSearch(race)
+    , _search(race)
     , _searchTimeLimit(30)
+    , _numThreads(1)
+    , _initialUpperBound(0)
 {
 }
 
@@ -16,10 +18,10 @@ void DFBB_BuildOrderSmartSearch::doSearch()
     BOSS_ASSERT(_initialState.getRace() != Races::None, "Must set initial state before performing search");
 
     // if we are resuming a search
-    if (_stackSearch.getResults().timedOut)
+    if (_search.getResults().timedOut)
     {
-        _stackSearch.setTimeLimit(_searchTimeLimit);
-        _stackSearch.search();
+        _search.setTimeLimit(_searchTimeLimit);
+        _search.search();
     }
     else
     {
@@ -33,13 +35,15 @@ void DFBB_BuildOrderSmartSearch::doSearch()
         _params.supplyBoundingThreshold     = 1.5;
         _params.relevantActions             = _relevantActions;
         _params.searchTimeLimit             = _searchTimeLimit;
+        _params.numThreads                  = _numThreads;
+        _params.initialUpperBound           = _initialUpperBound;
 
         // BWAPI::Broodwar->printf("Constructing new search object time limit is %lf", _params.searchTimeLimit);
-        _stackSearch = DFBB_BuildOrderStackSearch(_params);
-        _stackSearch.search();
+        _search = DFBB_BuildOrderParallelSearch(_params);
+        _search.search();
     }
 
-    _results = _stackSearch.getResults();
+    _results = _search.getResults();
 
     if (_results.solved && !_results.solutionFound)
     {
@@ -198,18 +202,14 @@ void DFBB_BuildOrderSmartSearch::recurseOverStrictDependencies(const ActionType
         return;
     }
 
-    PrerequisiteSet recursivePrerequisites = actionType.getRecursivePrerequisites();
-
-    for (size_t a(0); a < recursivePrerequisites.size(); ++a)
+    for (const ActionType & prerequisite : actionType.getRecursivePrerequisites())
     {
-        const ActionType & actionType = recursivePrerequisites.getActionType(a);
-
-        if (actionType.isResourceDepot() ||actionType.isWorker() || actionType.isSupplyProvider() || actionType.isRefinery())
+        if (prerequisite.isResourceDepot() || prerequisite.isWorker() || prerequisite.isSupplyProvider() || prerequisite.isRefinery())
         {
             continue;
         }
 
-        _goal.setGoalMax(actionType, std::max((UnitCountType)1, _goal.getGoalMax(actionType)));
+        _goal.setGoalMax(prerequisite, std::max((UnitCountType)1, _goal.getGoalMax(prerequisite)));
     }
 }
 
@@ -307,6 +307,17 @@ void DFBB_BuildOrderSmartSearch::setTimeLimit(int n)
     _searchTimeLimit = n;
 }
 
+void DFBB_BuildOrderSmartSearch::setNumThreads(size_t n)
+{
+    _numThreads = n;
+}
+
+// the completion time of a build order known to achieve the goal, so that DFBB only looks for one at least as good
+void DFBB_BuildOrderSmartSearch::setInitialUpperBound(int frame)
+{
+    _initialUpperBound = frame;
+}
+
 void DFBB_BuildOrderSmartSearch::search()
 {
     doSearch();
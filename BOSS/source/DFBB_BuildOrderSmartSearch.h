@@ -2,7 +2,7 @@
 
 #include "Common.h"
 #include "GameState.h"
-#include "DFBB_BuildOrderStackSearch.h"
+#include "DFBB_BuildOrderParallelSearch.h"
 #include "Timer.hpp"
 
 namespace BOSS
@@ -19,10 +19,12 @@ class DFBB_BuildOrderSmartSearch
 	GameState					        _initialState;
 	
 	int 							    _searchTimeLimit;
+    size_t                              _numThreads;
+    int                                 _initialUpperBound;
 
 	Timer							    _searchTimer;
 
-    DFBB_BuildOrderStackSearch          _stackSearch;
+    DFBB_BuildOrderParallelSearch       _search;
 
     DFBB_BuildOrderSearchResults        _results;
 	
@@ -47,6 +49,8 @@ public:
 	void setState(const GameState & state);
 	void print();
 	void setTimeLimit(int n);
+    void setNumThreads(size_t n);
+	void setInitialUpperBound(int frame);
 	
 	void search();
 
@@ -1,9 +1,14 @@
 #include "DFBB_BuildOrderStackSearch.h"
+#include "DFBB_BuildOrderParallelSearch.h"
 
 using namespace BOSS;
 
 DFBB_BuildOrderStackSearch::DFBB_BuildOrderStackSearch(const DFBB_BuildOrderSearchParameters & p)
     : _params(p)
+    , _lowerBound(p.goal)
+    , _shared(nullptr)
+    , _worker(0)
+    , _taskBuildOrderSize(0)
     , _depth(0)
     , _firstSearch(true)
     , _wasInterrupted(false)
@@ -12,6 +17,120 @@ DFBB_BuildOrderStackSearch::DFBB_BuildOrderStackSearch(const DFBB_BuildOrderSear
     
 }
 
+DFBB_BuildOrderStackSearch::DFBB_BuildOrderStackSearch(const DFBB_BuildOrderSearchParameters & p, DFBB_SharedSearchData * shared, size_t worker)
+    : _params(p)
+    , _lowerBound(p.goal)
+    , _shared(shared)
+    , _worker(worker)
+    , _taskBuildOrderSize(0)
+    , _depth(0)
+    , _firstSearch(false)
+    , _wasInterrupted(false)
+    , _stack(100, StackData())
+{
+    // the parallel search sets the upper bound, and the table is kept across the tasks of this worker
+    _results.upperBound = _shared->upperBound;
+    _transpositionTable.resize(_params.transpositionTableBits);
+}
+
+void DFBB_BuildOrderStackSearch::startTask(const DFBB_SearchTask & task)
+{
+    _stack[0].state = task.state;
+    _depth = 0;
+    _buildOrder = task.buildOrder;
+    _taskBuildOrderSize = task.buildOrder.size();
+
+    _results.solved = false;
+    _results.timedOut = false;
+    _wasInterrupted = false;
+}
+
+// does what a DFBB node does for its children, but collects them as tasks instead of searching them
+void DFBB_BuildOrderStackSearch::expandTask(const DFBB_SearchTask & task, std::vector<DFBB_SearchTask> & children)
+{
+    _results.nodesExpanded++;
+    updateUpperBound();
+
+    const FrameCountType heuristicTime = task.state.getCurrentFrame() + _lowerBound.get(task.state);
+
+    ActionSet legalActions;
+    generateLegalActions(task.state, legalActions);
+    for (const ActionType & action : legalActions)
+    {
+        addChildTask(task.state, task.buildOrder, action, heuristicTime, children);
+    }
+}
+
+void DFBB_BuildOrderStackSearch::addChildTask(const GameState & state, const BuildOrder & buildOrder, const ActionType & action, FrameCountType heuristicTime, std::vector<DFBB_SearchTask> & tasks)
+{
+    // the same bound as in DFBB
+    FrameCountType actionFinishTime = state.whenCanPerform(action) + action.buildTime();
+
+    if (std::max(actionFinishTime, heuristicTime) > _results.upperBound)
+    {
+        return;
+    }
+
+    DFBB_SearchTask child;
+    child.state = state;
+    child.buildOrder = buildOrder;
+    child.lowerBound = std::max(actionFinishTime, heuristicTime);
+
+    UnitCountType repetitions = getRepetitions(state, action);
+    for (UnitCountType r(0); r < repetitions && child.state.isLegal(action); ++r)
+    {
+        child.buildOrder.add(action);
+        child.state.doAction(action);
+    }
+
+    if (_params.goal.isAchievedBy(child.state))
+    {
+        updateResults(child.state, child.buildOrder);
+    }
+    else
+    {
+        tasks.push_back(child);
+    }
+}
+
+// gives the untried children of the shallowest node which has any to the workers which ran out of tasks
+void DFBB_BuildOrderStackSearch::donateTasks()
+{
+    size_t buildOrderSize = _taskBuildOrderSize;
+
+    for (size_t d(0); d < _depth; ++d)
+    {
+        StackData & node = _stack[d];
+
+        if (node.currentChildIndex + 1 < node.legalActions.size())
+        {
+            BuildOrder buildOrder;
+            for (size_t i(0); i < buildOrderSize; ++i)
+            {
+                buildOrder.add(_buildOrder[i]);
+            }
+
+            std::vector<ActionType> untried;
+            for (size_t a(node.currentChildIndex + 1); a < node.legalActions.size(); ++a)
+            {
+                untried.push_back(node.legalActions[a]);
+            }
+
+            std::vector<DFBB_SearchTask> tasks;
+            for (const ActionType & action : untried)
+            {
+                node.legalActions.remove(action);
+                addChildTask(node.state, buildOrder, action, node.heuristicTime, tasks);
+            }
+
+            _shared->push(_worker, tasks);
+            return;
+        }
+
+        buildOrderSize += node.completedRepetitions;
+    }
+}
+
 void DFBB_BuildOrderStackSearch::setTimeLimit(double ms)
 {
     _params.searchTimeLimit = ms;
@@ -32,27 +151,18 @@ void DFBB_BuildOrderStackSearch::search()
             _results.upperBound += 1;
 
             _stack[0].state = _params.initialState;
+            _transpositionTable.resize(_params.transpositionTableBits);
             _firstSearch = false;
             //BWAPI::Broodwar->printf("Upper bound is %d", _results.upperBound);
             std::cout << "Upper bound is: " << _results.upperBound << std::endl;
         }
 
-        try 
-        {
-            // search on the initial state
-            DFBB();
+        // search on the initial state, or resume where the last call ran out of time
+        _wasInterrupted = false;
+        DFBB();
 
-            _results.timedOut = false;
-        }
-        catch (int e) 
-        {
-            if (e == DFBB_TIMEOUT_EXCEPTION)
-            {
-                //BWAPI::Broodwar->printf("I timed out!");
-                _results.timedOut = true;
-            }
-        }
-        
+        _results.timedOut = _wasInterrupted;
+        _results.lowerBound = calculateLowerBound();
         double ms = _searchTimer.getElapsedTimeInMilliSec();
         _results.solved = !_results.timedOut;
         _results.timeElapsed = ms;
@@ -71,10 +181,8 @@ void DFBB_BuildOrderStackSearch::generateLegalActions(const GameState & state, A
     const ActionType & worker = ActionTypes::GetWorker(state.getRace());
     
     // add all legal relevant actions that are in the goal
-    for (size_t a(0); a < _params.relevantActions.size(); ++a)
+    for (const ActionType & actionType : _params.relevantActions)
     {
-        const ActionType & actionType = _params.relevantActions[a];
-        const std::string & actionName = actionType.getName();
         const size_t numTotal = state.getUnitData().getNumTotal(actionType);
 
         if (state.isLegal(actionType))
@@ -97,7 +205,7 @@ void DFBB_BuildOrderStackSearch::generateLegalActions(const GameState & state, A
                 continue;
             }
             
-            legalActions.add(_params.relevantActions[a]);
+            legalActions.add(actionType);
         }
     }
 
@@ -120,9 +228,8 @@ void DFBB_BuildOrderStackSearch::generateLegalActions(const GameState & state, A
         ActionSet legalEqualWorker;
         FrameCountType workerReady = state.whenCanPerform(worker);
 
-        for (size_t a(0); a < legalActions.size(); ++a)
+        for (const ActionType & actionType : legalActions)
         {
-            const ActionType & actionType = legalActions[a];
             const FrameCountType whenCanPerformAction = state.whenCanPerform(actionType);
             if (whenCanPerformAction < workerReady)
             {
@@ -177,23 +284,112 @@ bool DFBB_BuildOrderStackSearch::isTimeOut()
     return (_params.searchTimeLimit && (_results.nodesExpanded % 200 == 0) && (_searchTimer.getElapsedTimeInMilliSec() > _params.searchTimeLimit));
 }
 
-void DFBB_BuildOrderStackSearch::updateResults(const GameState & state)
+// returns true if the state was already reached in a way that's at least as good, so it can be pruned
+bool DFBB_BuildOrderStackSearch::isTransposition(const GameState & state)
+{
+    if (!_transpositionTable.isEnabled())
+    {
+        return false;
+    }
+
+    bool found = false;
+    bool dominated = _transpositionTable.probe(state, found);
+
+    _results.ttProbes++;
+    _results.ttHits += found ? 1 : 0;
+    _results.ttCutoffs += dominated ? 1 : 0;
+
+    return dominated;
+}
+
+// the smallest makespan that the part of the tree which is left to search could still have: the node
+// the search stopped at, and the untried children of the nodes above it, bounded the way DFBB bounds
+// them before it searches them. once the search is done it's the makespan of the best solution.
+int DFBB_BuildOrderStackSearch::calculateLowerBound()
+{
+    if (!_wasInterrupted)
+    {
+        return _results.upperBound;
+    }
+
+    int lowerBound = _results.upperBound;
+    for (size_t d(0); d <= _depth; ++d)
+    {
+        const StackData & node = _stack[d];
+
+        // the node the search stopped at may not have been bounded yet
+        if (d == _depth)
+        {
+            lowerBound = std::min(lowerBound, (int)(node.state.getCurrentFrame() + _lowerBound.get(node.state)));
+            break;
+        }
+
+        for (size_t a(node.currentChildIndex + 1); a < node.legalActions.size(); ++a)
+        {
+            const ActionType & action = node.legalActions[a];
+            const FrameCountType actionFinishTime = node.state.whenCanPerform(action) + action.buildTime();
+
+            lowerBound = std::min(lowerBound, (int)std::max(actionFinishTime, node.heuristicTime));
+        }
+    }
+
+    return lowerBound;
+}
+
+void DFBB_BuildOrderStackSearch::updateResults(const GameState & state, const BuildOrder & buildOrder)
 {
     FrameCountType finishTime = state.getLastActionFinishTime();
 
+    // the workers of a parallel search keep the best solution in the shared data
+    if (_shared)
+    {
+        std::lock_guard<std::mutex> lock(_shared->resultsMutex);
+
+        if (finishTime < _shared->upperBound)
+        {
+            if (!_shared->results.solutionFound)
+            {
+                _shared->results.timeFirstSolution = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _shared->searchStart).count();
+            }
+
+            _shared->upperBound = finishTime;
+            _shared->results.upperBound = finishTime;
+            _shared->results.solutionFound = true;
+            _shared->results.finalState = state;
+            _shared->results.buildOrder = buildOrder;
+        }
+
+        _results.upperBound = _shared->upperBound;
+        return;
+    }
+
     // new best solution
     if (finishTime < _results.upperBound)
     {
+        if (!_results.solutionFound)
+        {
+            _results.timeFirstSolution = _searchTimer.getElapsedTimeInMilliSec();
+        }
+
         _results.timeElapsed = _searchTimer.getElapsedTimeInMilliSec();
         _results.upperBound = finishTime;
         _results.solutionFound = true;
         _results.finalState = state;
-        _results.buildOrder = _buildOrder;
+        _results.buildOrder = buildOrder;
 
         _results.printResults(true);
     }
 }
 
+// picks up better solutions found by the other workers of a parallel search
+void DFBB_BuildOrderStackSearch::updateUpperBound()
+{
+    if (_shared)
+    {
+        _results.upperBound = std::min(_results.upperBound, _shared->upperBound.load());
+    }
+}
+
 #define ACTION_TYPE     _stack[_depth].currentActionType
 #define STATE           _stack[_depth].state
 #define CHILD_STATE     _stack[_depth+1].state
@@ -201,6 +397,7 @@ void DFBB_BuildOrderStackSearch::updateResults(const GameState & state)
 #define LEGAL_ACTINS    _stack[_depth].legalActions
 #define REPETITIONS     _stack[_depth].repetitionValue
 #define COMPLETED_REPS  _stack[_depth].completedRepetitions
+#define HEURISTIC_TIME  _stack[_depth].heuristicTime
 
 #define DFBB_CALL_RETURN  if (_depth == 0) { return; } else { --_depth; goto SEARCH_RETURN; }
 #define DFBB_CALL_RECURSE { ++_depth; goto SEARCH_BEGIN; }
@@ -209,16 +406,37 @@ void DFBB_BuildOrderStackSearch::updateResults(const GameState & state)
 void DFBB_BuildOrderStackSearch::DFBB()
 {
     FrameCountType actionFinishTime = 0;
-    FrameCountType heuristicTime = 0;
     FrameCountType maxHeuristic = 0;
 
 SEARCH_BEGIN:
 
     _results.nodesExpanded++;
 
+    // the stack holds everything needed to pick up the search again, so running out of time just
+    // leaves this node to be searched first by the next call
     if (isTimeOut())
     {
-        throw DFBB_TIMEOUT_EXCEPTION;
+        _wasInterrupted = true;
+        return;
+    }
+
+    if (isTransposition(STATE))
+    {
+        DFBB_CALL_RETURN;
+    }
+
+    updateUpperBound();
+
+    // the bound only depends on the state, so it's worked out once for all of the children
+    HEURISTIC_TIME = STATE.getCurrentFrame() + _lowerBound.get(STATE);
+    if (HEURISTIC_TIME > _results.upperBound)
+    {
+        DFBB_CALL_RETURN;
+    }
+
+    if (_shared && _shared->isIdleWorkerWaiting())
+    {
+        donateTasks();
     }
 
     generateLegalActions(STATE, LEGAL_ACTINS);
@@ -227,8 +445,7 @@ SEARCH_BEGIN:
         ACTION_TYPE = LEGAL_ACTINS[CHILD_NUM];
 
         actionFinishTime = STATE.whenCanPerform(ACTION_TYPE) + ACTION_TYPE.buildTime();
-        heuristicTime    = STATE.getCurrentFrame() + Tools::GetLowerBound(STATE, _params.goal);
-        maxHeuristic     = (actionFinishTime > heuristicTime) ? actionFinishTime : heuristicTime;
+        maxHeuristic     = (actionFinishTime > HEURISTIC_TIME) ? actionFinishTime : HEURISTIC_TIME;
 
         if (maxHeuristic > _results.upperBound)
         {
@@ -256,7 +473,7 @@ SEARCH_BEGIN:
 
         if (_params.goal.isAchievedBy(CHILD_STATE))
         {
-            updateResults(CHILD_STATE);
+            updateResults(CHILD_STATE, _buildOrder);
         }
         else
         {
@@ -4,15 +4,33 @@
 #include "ActionType.h"
 #include "DFBB_BuildOrderSearchResults.h"
 #include "DFBB_BuildOrderSearchParameters.h"
+#include "DFBB_TranspositionTable.h"
+#include "DFBB_LowerBound.h"
 #include "Timer.hpp"
 #include "Tools.h"
 #include "BuildOrder.h"
 
-#define DFBB_TIMEOUT_EXCEPTION 1
-
 namespace BOSS
 {
 
+class DFBB_SharedSearchData;
+
+// A subtree of the search: the state at its root and the build order which reaches it from the initial state
+class DFBB_SearchTask
+{
+public:
+
+    GameState           state;
+    BuildOrder          buildOrder;
+    FrameCountType      lowerBound;         // the bound DFBB checked before it would have searched the subtree
+
+    DFBB_SearchTask()
+        : lowerBound(0)
+    {
+    
+    }
+};
+
 class StackData
 {
 public:
@@ -23,11 +41,13 @@ public:
     ActionType          currentActionType;
     UnitCountType       repetitionValue;
     UnitCountType       completedRepetitions;
+    FrameCountType      heuristicTime;          // the lower bound on the makespan of any build order through this node
     
     StackData()
         : currentChildIndex(0)
         , repetitionValue(1)
         , completedRepetitions(0)
+        , heuristicTime(0)
     {
     
     }
@@ -41,15 +61,27 @@ class DFBB_BuildOrderStackSearch
     Timer                               _searchTimer;
     BuildOrder                          _buildOrder;
 
+    DFBB_TranspositionTable             _transpositionTable;
+    DFBB_LowerBound                     _lowerBound;
+
+    DFBB_SharedSearchData *             _shared;                      // set if this is a worker of a parallel search
+    size_t                              _worker;
+    size_t                              _taskBuildOrderSize;          // the length of the build order to the root of the current task
+
     std::vector<StackData>              _stack;
     size_t                              _depth;
 
     bool                                _firstSearch;
 
-    bool                                _wasInterrupted;
+    bool                                _wasInterrupted;              // the last search() ran out of time, and the next one resumes where it stopped
     
-    void                                updateResults(const GameState & state);
+    void                                updateResults(const GameState & state, const BuildOrder & buildOrder);
+    void                                updateUpperBound();
+    void                                addChildTask(const GameState & state, const BuildOrder & buildOrder, const ActionType & action, FrameCountType heuristicTime, std::vector<DFBB_SearchTask> & tasks);
+    void                                donateTasks();
     bool                                isTimeOut();
+    bool                                isTransposition(const GameState & state);
+    int                                 calculateLowerBound();
     void                                calculateRecursivePrerequisites(const ActionType & action, ActionSet & all);
     void                                generateLegalActions(const GameState & state, ActionSet & legalActions);
 	std::vector<ActionType>             getBuildOrder(GameState & state);
@@ -59,6 +91,11 @@ class DFBB_BuildOrderStackSearch
 public:
 	
 	DFBB_BuildOrderStackSearch(const DFBB_BuildOrderSearchParameters & p);
+	DFBB_BuildOrderStackSearch(const DFBB_BuildOrderSearchParameters & p, DFBB_SharedSearchData * shared, size_t worker);
+
+    // for the workers of a parallel search: start searching the subtree of a task, or split it into its children
+    void startTask(const DFBB_SearchTask & task);
+    void expandTask(const DFBB_SearchTask & task, std::vector<DFBB_SearchTask> & children);
 	
     void setTimeLimit(double ms);
 	void search();
@@ -0,0 +1,369 @@
+#include "DFBB_LowerBound.h"
+#include "Zobrist.h"
+
+using namespace BOSS;
+
+namespace
+{
+    // the prerequisite chains of a search come in a few thousand combinations at most, this only
+    // keeps a runaway search from growing the table without bound
+    const size_t MaxEntries = 1 << 16;
+
+    // the bound for a goal DFBB can't reach, with room to add frames to it
+    const FrameCountType Unreachable = 1 << 24;
+
+    // how many of the zerg buildings morphed from this one there are, since a lair or hive is also a hatchery
+    // and a greater spire is also a spire, like in BuildOrderSearchGoal::isAchievedBy
+    int GetNumMorphed(const UnitData & units, const ActionType & action)
+    {
+        static const ActionType & Hatchery      = ActionTypes::GetActionType("Zerg_Hatchery");
+        static const ActionType & Lair          = ActionTypes::GetActionType("Zerg_Lair");
+        static const ActionType & Hive          = ActionTypes::GetActionType("Zerg_Hive");
+        static const ActionType & Spire         = ActionTypes::GetActionType("Zerg_Spire");
+        static const ActionType & GreaterSpire  = ActionTypes::GetActionType("Zerg_Greater_Spire");
+
+        if (action.getRace() != Races::Zerg)
+        {
+            return 0;
+        }
+
+        if (action == Hatchery)
+        {
+            return units.getNumTotal(Lair) + units.getNumTotal(Hive);
+        }
+        else if (action == Lair)
+        {
+            return units.getNumTotal(Hive);
+        }
+        else if (action == Spire)
+        {
+            return units.getNumTotal(GreaterSpire);
+        }
+
+        return 0;
+    }
+}
+
+bool DFBB_LowerBound::Key::operator == (const Key & rhs) const
+{
+    return wanted == rhs.wanted && completed == rhs.completed && inProgress == rhs.inProgress;
+}
+
+size_t DFBB_LowerBound::KeyHash::operator () (const Key & key) const
+{
+    return (size_t)Zobrist::Mix(key.wanted ^ Zobrist::Mix(key.completed ^ Zobrist::Mix(key.inProgress)));
+}
+
+DFBB_LowerBound::DFBB_LowerBound(const BuildOrderSearchGoal & goal)
+    : _goal(goal)
+{
+}
+
+FrameCountType DFBB_LowerBound::get(const GameState & state)
+{
+    const UnitData & units = state.getUnitData();
+    const RaceID race = state.getRace();
+    const size_t numActions = ActionTypes::GetAllActionTypes(race).size();
+
+    BOSS_ASSERT(numActions <= 8 * sizeof(ActionMask), "Too many action types for the lower bound masks: %d", (int)numActions);
+
+    // what the state has of each action type, and what the goal units still to be bought cost
+    Key key;
+    key.wanted = 0;
+    key.completed = 0;
+    key.inProgress = 0;
+
+    ResourceCountType minerals = 0;
+    ResourceCountType gas = 0;
+
+    for (ActionID a(0); a < numActions; ++a)
+    {
+        const ActionType & action = ActionTypes::GetActionType(race, a);
+        const ActionMask bit = ActionMask(1) << a;
+        const int morphed = GetNumMorphed(units, action);
+
+        // a building being morphed from this one is counted as this one completed
+        if (units.getNumCompleted(action) + morphed > 0)
+        {
+            key.completed |= bit;
+        }
+        else if (units.getNumInProgress(action) > 0)
+        {
+            key.inProgress |= bit;
+        }
+
+        const int goal = _goal.getGoal(action);
+        const int total = units.getNumTotal(action) + morphed;
+        if (goal > total)
+        {
+            key.wanted |= bit;
+
+            const int purchases = (goal - total + action.numProduced() - 1) / action.numProduced();
+            minerals += purchases * action.mineralPrice();
+            gas += purchases * action.gasPrice();
+        }
+    }
+
+    if (key.wanted == 0)
+    {
+        return 0;
+    }
+
+    auto it = _entries.find(key);
+    if (it == _entries.end())
+    {
+        if (_entries.size() >= MaxEntries)
+        {
+            _entries.clear();
+        }
+
+        it = _entries.emplace(key, Entry()).first;
+        calculateEntry(race, key, it->second);
+    }
+
+    const Entry & entry = it->second;
+
+    // the chains which end at an action in progress end when it finishes
+    FrameCountType prerequisiteBound = entry.chain;
+    for (const auto & above : entry.chainAbove)
+    {
+        const FrameCountType remaining = units.getFinishTime(ActionTypes::GetActionType(race, above.first)) - state.getCurrentFrame();
+        prerequisiteBound = std::max(prerequisiteBound, above.second + remaining);
+    }
+
+    // the last purchase can't be made before everything is paid for, and takes at least the shortest build time
+    minerals += entry.prerequisiteMinerals - state.getMinerals();
+    gas += entry.prerequisiteGas - state.getGas();
+
+    const FrameCountType resourceBound = std::max(whenMineralsMined(state, minerals), whenGasMined(state, gas)) + entry.shortestBuildTime;
+
+    return std::max(prerequisiteBound, resourceBound);
+}
+
+void DFBB_LowerBound::calculateEntry(const RaceID race, const Key & key, Entry & entry) const
+{
+    entry.chain = 0;
+    entry.chainAbove.clear();
+    entry.prerequisiteMinerals = 0;
+    entry.prerequisiteGas = 0;
+    entry.shortestBuildTime = std::numeric_limits<FrameCountType>::max();
+
+    std::vector<FrameCountType> longestAbove(ActionTypes::GetAllActionTypes(race).size(), -1);
+    ActionMask toBuild = 0;
+
+    for (ActionID a(0); a < longestAbove.size(); ++a)
+    {
+        if (key.wanted & (ActionMask(1) << a))
+        {
+            walkPrerequisites(ActionTypes::GetActionType(race, a), key, 0, longestAbove, toBuild, entry);
+        }
+    }
+
+    for (ActionID a(0); a < longestAbove.size(); ++a)
+    {
+        const ActionType & action = ActionTypes::GetActionType(race, a);
+        const ActionMask bit = ActionMask(1) << a;
+
+        if ((toBuild | key.wanted) & bit)
+        {
+            entry.shortestBuildTime = std::min(entry.shortestBuildTime, action.buildTime());
+        }
+
+        // the goal units are paid for by count in get()
+        if ((toBuild & ~key.wanted) & bit)
+        {
+            entry.prerequisiteMinerals += action.mineralPrice();
+            entry.prerequisiteGas += action.gasPrice();
+        }
+    }
+}
+
+// the same walk as Tools::CalculatePrerequisitesLowerBound, except that the chains ending at an action in
+// progress are kept by action, and that an action is only walked again if it's reached with a longer chain above it
+void DFBB_LowerBound::walkPrerequisites(const ActionType & action, const Key & key, FrameCountType timeAbove, std::vector<FrameCountType> & longestAbove, ActionMask & toBuild, Entry & entry) const
+{
+    const ActionMask bit = ActionMask(1) << action.ID();
+
+    if (key.completed & bit)
+    {
+        return;
+    }
+
+    if (timeAbove <= longestAbove[action.ID()])
+    {
+        return;
+    }
+
+    longestAbove[action.ID()] = timeAbove;
+
+    if (key.inProgress & bit)
+    {
+        for (auto & above : entry.chainAbove)
+        {
+            if (above.first == action.ID())
+            {
+                above.second = timeAbove;
+                return;
+            }
+        }
+
+        entry.chainAbove.push_back(std::pair<ActionID, FrameCountType>(action.ID(), timeAbove));
+        return;
+    }
+
+    toBuild |= bit;
+
+    const FrameCountType time = timeAbove + action.buildTime();
+    entry.chain = std::max(entry.chain, time);
+
+    for (const ActionType & prerequisite : action.getPrerequisites())
+    {
+        walkPrerequisites(prerequisite, key, time, longestAbove, toBuild, entry);
+    }
+}
+
+// the most of an action type DFBB can ever have, since it only makes goal units, up to their goal and goal max
+int DFBB_LowerBound::getMaxTotal(const UnitData & units, const ActionType & action) const
+{
+    const int goal = _goal.getGoal(action);
+    const int goalMax = _goal.getGoalMax(action);
+    const int limit = (goal && goalMax) ? std::min(goal, goalMax) : std::max(goal, goalMax);
+
+    return std::max((int)units.getNumTotal(action), limit);
+}
+
+// the first frame from now by which the state could have mined this many more minerals
+FrameCountType DFBB_LowerBound::whenMineralsMined(const GameState & state, ResourceCountType minerals) const
+{
+    if (minerals <= 0)
+    {
+        return 0;
+    }
+
+    const UnitData & units = state.getUnitData();
+    const RaceID race = state.getRace();
+    const ActionType & worker = ActionTypes::GetWorker(race);
+    const ActionType & depot = ActionTypes::GetResourceDepot(race);
+
+    const FrameCountType workerTime = worker.buildTime();
+    const FrameCountType depotTime = depot.buildTime();
+    const FrameCountType larvaTime = (FrameCountType)Constants::ZERG_LARVA_TIMER;
+
+    // the gas workers stay on gas, the workers in progress are counted as done
+    const int workers = units.getNumMineralWorkers() + units.getNumBuildingWorkers() + units.getNumInProgress(worker);
+    const int maxWorkers = std::max(workers, getMaxTotal(units, worker) - units.getNumGasWorkers());
+
+    // the depots in progress are counted as done, the new ones as done as soon as they could be
+    const int producers = race == Races::Zerg ? units.getHatcheryData().size() + units.getNumInProgress(depot) : units.getNumTotal(depot);
+    const int newProducers = getMaxTotal(units, depot) - units.getNumTotal(depot);
+    const int larva = race == Races::Zerg ? units.getHatcheryData().numLarva() : 0;
+
+    ResourceCountType mined = 0;
+    FrameCountType frame = 0;
+    while (true)
+    {
+        // the workers made by this frame, and the next frame another one could be done
+        int made = 0;
+        FrameCountType next = Unreachable;
+
+        if (race == Races::Zerg)
+        {
+            // every larva is made into a drone as soon as it spawns, a new hatchery comes with one
+            if (frame < workerTime)
+            {
+                next = (larva + producers + newProducers > 0) ? workerTime : Unreachable;
+            }
+            else
+            {
+                const FrameCountType spawned = frame - workerTime;
+                made = larva + producers * (spawned / larvaTime + 1);
+
+                if (producers > 0)
+                {
+                    next = workerTime + (spawned / larvaTime + 1) * larvaTime;
+                }
+
+                if (newProducers > 0)
+                {
+                    if (spawned < depotTime)
+                    {
+                        next = std::min(next, workerTime + depotTime);
+                    }
+                    else
+                    {
+                        made += newProducers * ((spawned - depotTime) / larvaTime + 2);
+                        next = std::min(next, workerTime + depotTime + ((spawned - depotTime) / larvaTime + 1) * larvaTime);
+                    }
+                }
+            }
+        }
+        else
+        {
+            made = producers * (frame / workerTime);
+
+            if (producers > 0)
+            {
+                next = (frame / workerTime + 1) * workerTime;
+            }
+
+            if (newProducers > 0)
+            {
+                if (frame < depotTime)
+                {
+                    next = std::min(next, depotTime);
+                }
+                else
+                {
+                    made += newProducers * ((frame - depotTime) / workerTime);
+                    next = std::min(next, depotTime + ((frame - depotTime) / workerTime + 1) * workerTime);
+                }
+            }
+        }
+
+        const int mining = std::min(maxWorkers, workers + made);
+        const ResourceCountType rate = Constants::MPWPF * mining;
+
+        // no more workers can be added, so the rest is mined at this rate
+        if (mining == maxWorkers || next == Unreachable)
+        {
+            return rate > 0 ? frame + (minerals - mined + rate - 1) / rate : Unreachable;
+        }
+
+        if (rate > 0 && mined + rate * (next - frame) >= minerals)
+        {
+            return frame + (minerals - mined + rate - 1) / rate;
+        }
+
+        mined += rate * (next - frame);
+        frame = next;
+    }
+}
+
+// the first frame from now by which the state could have mined this much more gas
+FrameCountType DFBB_LowerBound::whenGasMined(const GameState & state, ResourceCountType gas) const
+{
+    if (gas <= 0)
+    {
+        return 0;
+    }
+
+    const UnitData & units = state.getUnitData();
+    const ActionType & refinery = ActionTypes::GetRefinery(state.getRace());
+    const FrameCountType refineryTime = refinery.buildTime();
+
+    // three workers on each refinery, with the ones in progress counted as done, and the new ones as soon as they could be
+    const ResourceCountType rate = Constants::GPWPF * 3 * units.getNumTotal(refinery);
+    const ResourceCountType maxRate = Constants::GPWPF * 3 * getMaxTotal(units, refinery);
+
+    if (rate > 0 && rate * refineryTime >= gas)
+    {
+        return (gas + rate - 1) / rate;
+    }
+
+    if (maxRate == 0)
+    {
+        return Unreachable;
+    }
+
+    return refineryTime + (gas - rate * refineryTime + maxRate - 1) / maxRate;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Common.h"
+#include "GameState.h"
+#include "BuildOrderSearchGoal.h"
+
+#include <limits>
+#include <unordered_map>
+
+namespace BOSS
+{
+
+// Admissible lower bounds on the frames left until a goal can be achieved, for DFBB. Two bounds are
+// combined, and the larger one is returned:
+//
+// The prerequisite bound is the longest chain of build times from a goal unit down through the
+// prerequisites we don't have, the same value Tools::GetLowerBound finds. It only depends on which
+// goal units are still wanted and which prerequisites are completed or in progress, so the chain is
+// worked out once per combination of those and kept, and only the remaining times of the actions in
+// progress are added for each state.
+//
+// The resource bound is when enough minerals and gas for everything still to be bought can have been
+// mined, plus the shortest build time among those purchases. The income is taken as if every worker
+// producer (a depot for protoss and terran, a larva for zerg) made workers nonstop from now, and as
+// if all but the gas workers mined minerals. DFBB only makes goal units, up to their goal and goal
+// max, which caps the workers, and the depots and refineries that can be added. The new ones are
+// taken to be done as soon as one could be built.
+class DFBB_LowerBound
+{
+    typedef unsigned long long ActionMask;     // bit i is the action type with ID i
+
+    class Key
+    {
+    public:
+        ActionMask          wanted;         // goal units we don't have enough of
+        ActionMask          completed;
+        ActionMask          inProgress;     // in progress and none completed
+
+        bool operator == (const Key & rhs) const;
+    };
+
+    class KeyHash
+    {
+    public:
+        size_t operator () (const Key & key) const;
+    };
+
+    class Entry
+    {
+    public:
+        FrameCountType      chain;                  // the longest chain which doesn't end at an action in progress
+        std::vector<std::pair<ActionID, FrameCountType>> chainAbove;   // build times of the longest chain above each action in progress
+        ResourceCountType   prerequisiteMinerals;   // price of the prerequisites which aren't goal units
+        ResourceCountType   prerequisiteGas;
+        FrameCountType      shortestBuildTime;      // of the goal units and prerequisites still to be bought
+    };
+
+    BuildOrderSearchGoal                        _goal;
+    std::unordered_map<Key, Entry, KeyHash>     _entries;
+
+    void                    calculateEntry(const RaceID race, const Key & key, Entry & entry) const;
+    void                    walkPrerequisites(const ActionType & action, const Key & key, FrameCountType timeAbove, std::vector<FrameCountType> & longestAbove, ActionMask & toBuild, Entry & entry) const;
+
+    int                     getMaxTotal(const UnitData & units, const ActionType & action) const;
+    FrameCountType          whenMineralsMined(const GameState & state, ResourceCountType minerals) const;
+    FrameCountType          whenGasMined(const GameState & state, ResourceCountType gas) const;
+
+public:
+
+    DFBB_LowerBound(const BuildOrderSearchGoal & goal);
+
+    // frames from the state's current frame
+    FrameCountType          get(const GameState & state);
+};
+
+}
@@ -0,0 +1,50 @@
+#include "DFBB_TranspositionTable.h"
+
+using namespace BOSS;
+
+DFBB_TranspositionTable::DFBB_TranspositionTable()
+{
+}
+
+void DFBB_TranspositionTable::resize(size_t bits)
+{
+    _entries.assign(bits > 0 ? (size_t(1) << bits) : 0, Entry());
+}
+
+bool DFBB_TranspositionTable::isEnabled() const
+{
+    return !_entries.empty();
+}
+
+bool DFBB_TranspositionTable::probe(const GameState & state, bool & found)
+{
+    const HashType key = state.getHash();
+    Entry & entry = _entries[key & (_entries.size() - 1)];
+
+    const FrameCountType frame = state.getCurrentFrame();
+    const ResourceCountType minerals = state.getMinerals();
+    const ResourceCountType gas = state.getGas();
+
+    found = entry.frame >= 0 && entry.key == key;
+
+    if (found && entry.frame <= frame)
+    {
+        // what the stored state would have by the time this one was reached
+        const long long elapsed = frame - entry.frame;
+        const long long storedMinerals = entry.minerals + elapsed * (long long)state.getMineralsPerFrame();
+        const long long storedGas = entry.gas + elapsed * (long long)state.getGasPerFrame();
+
+        if (storedMinerals >= minerals && storedGas >= gas)
+        {
+            return true;
+        }
+    }
+
+    // replace whatever was there, the most recent states are the most likely to be reached again
+    entry.key = key;
+    entry.frame = frame;
+    entry.minerals = minerals;
+    entry.gas = gas;
+
+    return false;
+}
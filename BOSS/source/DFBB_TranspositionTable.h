@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Common.h"
+#include "GameState.h"
+
+namespace BOSS
+{
+
+// Duplicate detection for DFBB. The search reaches the same units and actions in progress through
+// different orderings of the same actions, for example probe-pylon-probe and probe-probe-pylon.
+// A state whose key matches a stored state that was reached no later, and that can have at least as
+// many minerals and gas by the time this one was reached, can't lead to a better build order, so its
+// subtree is pruned.
+//
+// Two states with the same key have the same actions in progress with the same finish times, so
+// nothing finishes while the earlier one waits for the later one's frame, and its income stays the
+// same meanwhile. That is what makes the comparison of resources a matter of adding up income.
+class DFBB_TranspositionTable
+{
+    class Entry
+    {
+    public:
+        HashType            key;
+        FrameCountType      frame;          // -1 if the entry is empty
+        ResourceCountType   minerals;
+        ResourceCountType   gas;
+
+        Entry()
+            : key(0)
+            , frame(-1)
+            , minerals(0)
+            , gas(0)
+        {
+        }
+    };
+
+    std::vector<Entry>      _entries;       // a power of two, indexed by the low bits of the key
+
+public:
+
+    DFBB_TranspositionTable();
+
+    // allocates 2^bits entries and clears them
+    void resize(size_t bits);
+    bool isEnabled() const;
+
+    // returns true if the state is dominated by a stored state and can be pruned, otherwise stores it
+    // found is set if there was a state with the same key, whether it dominates or not
+    bool probe(const GameState & state, bool & found);
+};
+
+}
@@ -10,6 +10,7 @@ GameState::GameState(const RaceID r)
     , _lastActionFrame      (0)
     , _minerals             (0)
     , _gas                  (0)
+    , _incomeActions        (0)
 {
     
 }
@@ -22,6 +23,7 @@ GameState::GameState(BWAPI::GameWrapper & game, BWAPI::PlayerInterface * self, c
     , _units                (Races::GetRaceID(self->getRace()))
     , _minerals             (self->minerals() * Constants::RESOURCE_SCALE)
     , _gas                  (self->gas() * Constants::RESOURCE_SCALE)
+    , _incomeActions        (0)
 { 
     // we will count the worker jobs as we add units
     UnitCountType mineralWorkerCount    = 0;
@@ -227,6 +229,8 @@ void GameState::setStartingState()
     }
 
     _units.setCurrentSupply(8);
+
+    clearIncome();
 }
 
 const RaceID GameState::getRace() const
@@ -336,14 +340,10 @@ bool GameState::isLegal(const ActionType & action) const
 }
 
 // do an action, action must be legal for this not to break
-std::vector<ActionType> GameState::doAction(const ActionType & action)
+void GameState::doAction(const ActionType & action)
 {
     BOSS_ASSERT(action.getRace() == _race, "Race of action does not match race of the state");
-
-    _actionsPerformed.push_back(ActionPerformed());
-    _actionsPerformed[_actionsPerformed.size()-1].actionType = action;
-
-    BOSS_ASSERT(isLegal(action), "Trying to perform an illegal action: %s %s", action.getName().c_str(), getActionsPerformedString().c_str());
+    BOSS_ASSERT(isLegal(action), "Trying to perform an illegal action: %s %s", action.getName().c_str(), toString().c_str());
     
     // set the actionPerformed
     _actionPerformed = action;
@@ -356,11 +356,7 @@ std::vector<ActionType> GameState::doAction(const ActionType & action)
 
     BOSS_ASSERT(ffTime >= 0 && ffTime < 1000000, "FFTime is very strange: %d", ffTime);
 
-    auto actionsFinished = fastForward(ffTime);
-
-    _actionsPerformed[_actionsPerformed.size()-1].actionQueuedFrame = _currentFrame;
-    _actionsPerformed[_actionsPerformed.size()-1].gasWhenQueued = _gas;
-    _actionsPerformed[_actionsPerformed.size()-1].mineralsWhenQueued = _minerals;
+    fastForward(ffTime);
 
     // how much time has elapsed since the last action was queued?
     FrameCountType elapsed(_currentFrame - _lastActionFrame);
@@ -415,11 +411,11 @@ std::vector<ActionType> GameState::doAction(const ActionType & action)
         }
      }
 
-	return actionsFinished;
+    clearIncome();
 }
 
 // fast forwards the current state to time toFrame
-std::vector<ActionType> GameState::fastForward(const FrameCountType toFrame)
+void GameState::fastForward(const FrameCountType toFrame)
 {
     // fast forward the building timers to the current frame
     FrameCountType previousFrame = _currentFrame;
@@ -431,8 +427,6 @@ std::vector<ActionType> GameState::fastForward(const FrameCountType toFrame)
     ResourceCountType   moreGas             = 0;
     ResourceCountType   moreMinerals        = 0;
 
-
-	std::vector<ActionType> actionsFinished;
     // while we still have units in progress
     while ((_units.getNumActionsInProgress() > 0) && (_units.getNextActionFinishTime() <= toFrame))
     {
@@ -448,7 +442,7 @@ std::vector<ActionType> GameState::fastForward(const FrameCountType toFrame)
         lastActionFinished 	= _units.getNextActionFinishTime();
 
         // finish the action, which updates mineral and gas rates if required
-		actionsFinished.push_back(_units.finishNextActionInProgress());
+		_units.finishNextActionInProgress();
     }
 
     // update resources from the last action finished to toFrame
@@ -468,7 +462,7 @@ std::vector<ActionType> GameState::fastForward(const FrameCountType toFrame)
         _units.getHatcheryData().fastForward(previousFrame, toFrame);
     }
 
-	return actionsFinished;
+    clearIncome();
 }
 
 // returns the time at which all resources to perform an action will be available
@@ -590,38 +584,27 @@ const FrameCountType GameState::whenSupplyReady(const ActionType & action) const
         return getCurrentFrame();
     }
 
-    FrameCountType whenSupplyReady = _currentFrame;
-
-    if (supplyNeeded > 0)
+    if (_units.getNumActionsInProgress() == 0)
     {
-        FrameCountType min = 99999;
+        return _currentFrame;
+    }
 
-        // if we don't have the resources, this action would only be legal if there is an
-        // overlord in progress, so check to see when the first overlord will finish
-        for (int i(0); i<_units.getNumActionsInProgress(); ++i)
+    // if we don't have the supply, this action would only be legal if there is a supply provider
+    // in progress, so the first one to finish which provides the supply we need is when it's ready.
+    // the vector is sorted in descending order, so the first one found from the back finishes first
+    for (size_t i(_units.getNumActionsInProgress()); i > 0; --i)
+    {
+        if (_units.getActionInProgressByIndex(i-1).supplyProvided() > supplyNeeded)
         {
-            // so, if the unit provides the supply we need
-            if (_units.getActionInProgressByIndex(i).supplyProvided() > supplyNeeded)
-            {
-                // set 'min' to the min of these times
-                min = (_units.getFinishTimeByIndex(i) < min) ? _units.getFinishTimeByIndex(i) : min;
-            }
-
-            // then set supply time to min
-            whenSupplyReady = min;
+            return _units.getFinishTimeByIndex(i-1);
         }
     }
 
-    return whenSupplyReady;
+    return 99999;
 }
 
 const FrameCountType GameState::whenPrerequisitesReady(const ActionType & action) const
 {
-    if (action == ActionTypes::GetActionType("Protoss_Dark_Templar"))
-    {
-        int a = 6;
-    }
-
     FrameCountType preReqReadyTime = _currentFrame;
 
     // if a building builds this action
@@ -713,185 +696,117 @@ const FrameCountType GameState::whenMineralsReady(const ActionType & action) con
     {
         return getCurrentFrame();
     }
-    
-    UnitCountType currentMineralWorkers     = _units.getNumMineralWorkers();
-    UnitCountType currentGasWorkers         = _units.getNumGasWorkers();
-    FrameCountType lastActionFinishFrame    = _currentFrame;
-    FrameCountType addedTime                = 0;
-    ResourceCountType addedMinerals         = 0;
-    ResourceCountType difference            = action.mineralPrice() - _minerals;
-
-    // loop through each action in progress, adding the minerals we would gather from each interval
-    for (size_t i(0); i<_units.getNumActionsInProgress(); ++i)
-    {
-        // the vector is sorted in descending order
-        size_t progressIndex = _units.getNumActionsInProgress() - i - 1;
 
-        // the time elapsed and the current minerals per frame
-        FrameCountType elapsed = _units.getFinishTimeByIndex(progressIndex) - lastActionFinishFrame;
-        ResourceCountType mineralsPerFrame = (currentMineralWorkers * Constants::MPWPF);
-
-        // the amount of minerals that would be added this time step
-        ResourceCountType tempAdd = elapsed * mineralsPerFrame;
-
-        // if this amount isn't enough, update the amount added for this interval
-        if (addedMinerals + tempAdd < difference)
-        {
-            addedMinerals += tempAdd;
-            addedTime += elapsed;
-        }
-        else
-        {
-            // otherwise we can just break out and update at the end
-            break;
-        }
-
-        // if it was a drone or extractor update the temp variables
-        const ActionType & actionPerformed = _units.getActionInProgressByIndex(progressIndex);
-
-        // finishing a building as terran gives you a mineral worker back
-        if (actionPerformed.isBuilding() && !actionPerformed.isAddon() && (getRace() == Races::Terran))
-        {
-            currentMineralWorkers++;
-        }
-
-        if (actionPerformed.isWorker())
-        {
-            currentMineralWorkers++;
-        }
-        else if (actionPerformed.isRefinery())
-        {
-            BOSS_ASSERT(currentMineralWorkers > 3, "Not enough mineral workers \n");
-            currentMineralWorkers -= 3; 
-            currentGasWorkers += 3;
-        }
-
-
-        // update the last action
-        lastActionFinishFrame = _units.getFinishTimeByIndex(progressIndex);
-    }
+    return whenIncomeReaches(action.mineralPrice() - _minerals, false);
+}
 
-    // if we still haven't added enough minerals, add more time
-    if (addedMinerals < difference)
+const FrameCountType GameState::whenGasReady(const ActionType & action) const
+{
+    if (_gas >= action.gasPrice())
     {
-        BOSS_ASSERT(currentMineralWorkers > 0, "Shouldn't have 0 mineral workers");
-
-       FrameCountType finalTimeToAdd;
-	   if (currentMineralWorkers != 0)
-		{
-			finalTimeToAdd = (difference - addedMinerals) / (currentMineralWorkers * Constants::MPWPF);
-		}
-		else
-		{
-			finalTimeToAdd = 1000000;
-		}
-        addedMinerals += finalTimeToAdd * currentMineralWorkers * Constants::MPWPF;
-        addedTime     += finalTimeToAdd;
-
-        // the last operation could have added one frame too little due to integer division so we need to check
-        if (addedMinerals < difference)
-        {
-            addedTime += 1;
-            addedMinerals += currentMineralWorkers * Constants::MPWPF;
-        }
+        return getCurrentFrame();
     }
-    
-    BOSS_ASSERT(addedMinerals >= difference, "Mineral prediction error");
 
-    // for some reason if i don't return +1, i mine 1 less mineral in the interval
-    return _currentFrame + addedTime;
+    return whenIncomeReaches(action.gasPrice() - _gas, true);
 }
 
-const FrameCountType GameState::whenGasReady(const ActionType & action) const
+void GameState::clearIncome()
 {
-    if (_gas >= action.gasPrice())
+    _income.clear();
+    _incomeActions = 0;
+}
+
+// adds the income up to the next frame actions in progress finish, with the worker jobs changing as they
+// finish: a worker mines minerals, a refinery takes 3 workers off minerals, and finishing a terran
+// building gives its worker back. The first step is the income from the current frame.
+void GameState::addIncomeStep() const
+{
+    IncomeStep step;
+    if (_income.empty())
     {
-        return getCurrentFrame();
+        step.frame          = _currentFrame;
+        step.minerals       = 0;
+        step.gas            = 0;
+        step.mineralWorkers = _units.getNumMineralWorkers();
+        step.gasWorkers     = _units.getNumGasWorkers();
     }
-    
-    UnitCountType currentMineralWorkers     = _units.getNumMineralWorkers();
-    UnitCountType currentGasWorkers         = _units.getNumGasWorkers();
-    FrameCountType lastActionFinishFrame    = _currentFrame;
-    FrameCountType addedTime                = 0;
-    ResourceCountType addedGas              = 0;
-    ResourceCountType difference            = action.gasPrice() - _gas;
-
-    // loop through each action in progress, adding the minerals we would gather from each interval
-    for (size_t i(0); i<_units.getNumActionsInProgress(); ++i)
+    else
     {
         // the vector is sorted in descending order
-        size_t progressIndex = _units.getNumActionsInProgress() - i - 1;
-
-        // the time elapsed and the current minerals per frame
-        FrameCountType elapsed = _units.getFinishTimeByIndex(progressIndex) - lastActionFinishFrame;
-        ResourceCountType gasPerFrame = (currentGasWorkers * Constants::GPWPF);
+        const FrameCountType finishTime = _units.getFinishTimeByIndex(_units.getNumActionsInProgress() - _incomeActions - 1);
 
-        // the amount of minerals that would be added this time step
-        ResourceCountType tempAdd = elapsed * gasPerFrame;
+        step                 = _income.back();
+        step.minerals       += (finishTime - step.frame) * step.mineralWorkers * Constants::MPWPF;
+        step.gas            += (finishTime - step.frame) * step.gasWorkers * Constants::GPWPF;
+        step.frame           = finishTime;
+    }
 
-        // if this amount isn't enough, update the amount added for this interval
-        if (addedGas + tempAdd < difference)
-        {
-            addedGas += tempAdd;
-            addedTime += elapsed;
-        }
-        else
+    // every action which has finished by the step changes the workers
+    for (; _incomeActions < _units.getNumActionsInProgress(); ++_incomeActions)
+    {
+        const size_t progressIndex = _units.getNumActionsInProgress() - _incomeActions - 1;
+        if (_units.getFinishTimeByIndex(progressIndex) > step.frame)
         {
-            // otherwise we can just break out and update at the end
             break;
         }
 
-        // if it was a drone or extractor update the temp variables
-        const ActionType & actionPerformed = _units.getActionInProgressByIndex(progressIndex);
+        const ActionType & action = _units.getActionInProgressByIndex(progressIndex);
 
-        // finishing a building as terran gives you a mineral worker back
-        if (actionPerformed.isBuilding() && !actionPerformed.isAddon() && (getRace() == Races::Terran))
+        if (action.isBuilding() && !action.isAddon() && (getRace() == Races::Terran))
         {
-            currentMineralWorkers++;
+            step.mineralWorkers++;
         }
 
-        if (actionPerformed.isWorker())
+        if (action.isWorker())
         {
-            currentMineralWorkers++;
+            step.mineralWorkers++;
         }
-        else if (actionPerformed.isRefinery())
+        else if (action.isRefinery())
         {
-            BOSS_ASSERT(currentMineralWorkers > 3, "Not enough mineral workers");
-            currentMineralWorkers -= 3; currentGasWorkers += 3;
+            step.mineralWorkers -= 3;
+            step.gasWorkers += 3;
         }
+    }
+
+    _income.push_back(step);
+}
 
-        // update the last action
-        lastActionFinishFrame = _units.getFinishTimeByIndex(progressIndex);
+// the first frame by which the income adds up to amount
+const FrameCountType GameState::whenIncomeReaches(const ResourceCountType amount, const bool gas) const
+{
+    if (_income.empty())
+    {
+        addIncomeStep();
     }
 
-    // if we still haven't added enough minerals, add more time
-    if (addedGas < difference)
+    while (_incomeActions < _units.getNumActionsInProgress() && (gas ? _income.back().gas : _income.back().minerals) < amount)
     {
-		BOSS_ASSERT(currentGasWorkers > 0, "Shouldn't have 0 gas workers");
-		FrameCountType finalTimeToAdd;
-		if (currentGasWorkers != 0)
-		{
-			finalTimeToAdd = (difference - addedGas) / (currentGasWorkers * Constants::GPWPF);
-		}
-		else
-		{
-			finalTimeToAdd = 1000000;
-		}
-        addedGas    += finalTimeToAdd * currentGasWorkers * Constants::GPWPF;
-        addedTime   += finalTimeToAdd;
+        addIncomeStep();
+    }
 
-        // the last operation could have added one frame too little due to integer division so we need to check
-        if (addedGas < difference)
+    // the last step which hasn't mined the amount yet, the amount is reached during it
+    size_t low = 0;
+    size_t high = _income.size();
+    while (high - low > 1)
+    {
+        const size_t mid = (low + high) / 2;
+        if ((gas ? _income[mid].gas : _income[mid].minerals) < amount)
         {
-            addedTime += 1;
-            addedGas += currentGasWorkers * Constants::GPWPF;
+            low = mid;
+        }
+        else
+        {
+            high = mid;
         }
     }
-    
-    BOSS_ASSERT(addedGas >= difference, "Gas prediction error");
 
-    // for some reason if i don't return +1, i mine 1 less mineral in the interval
-    return _currentFrame + addedTime;
+    const IncomeStep & step = _income[low];
+    const ResourceCountType perFrame = gas ? step.gasWorkers * Constants::GPWPF : step.mineralWorkers * Constants::MPWPF;
+    const ResourceCountType needed = amount - (gas ? step.gas : step.minerals);
+
+    BOSS_ASSERT(perFrame > 0, "Shouldn't have 0 workers mining %s", gas ? "gas" : "minerals");
+
+    return step.frame + (needed + perFrame - 1) / perFrame;
 }
 
 const FrameCountType GameState::getCurrentFrame() const
@@ -985,6 +900,12 @@ const UnitData & GameState::getUnitData() const
     return _units;
 }
 
+// the key of everything but the frame and the resources, which the transposition table compares instead
+const HashType GameState::getHash() const
+{
+    return _units.getHash();
+}
+
 const BuildingData & GameState::getBuildingData() const
 {
     return _units.getBuildingData();
@@ -1012,6 +933,7 @@ void GameState::addCompletedAction(const ActionType & action, const size_t num)
         _units.addCompletedAction(action, false);
         _units.setCurrentSupply(_units.getCurrentSupply() + action.supplyRequired());
     }
+    clearIncome();
 }
 
 void GameState::removeCompletedAction(const ActionType & action, const size_t num)
@@ -1021,6 +943,7 @@ void GameState::removeCompletedAction(const ActionType & action, const size_t nu
 		_units.setCurrentSupply(_units.getCurrentSupply() - action.supplyRequired());
 		_units.removeCompletedAction(action);
 	}
+    clearIncome();
 }
 
 const std::string GameState::toString() const
@@ -1079,18 +1002,6 @@ const std::string GameState::toString() const
     return ss.str();
 }
 
-const std::string GameState::getActionsPerformedString() const
-{
-    std::stringstream ss;
-    ss << std::endl;
-    for (size_t a(0); a<_actionsPerformed.size(); ++a)
-    {
-        ss << (int)_actionsPerformed[a].actionQueuedFrame << " " << (int)_actionsPerformed[a].mineralsWhenQueued << " " << (int)_actionsPerformed[a].gasWhenQueued << " " << _actionsPerformed[a].actionType.getName() << std::endl;
-    }
-
-    return ss.str();
-}
-
 std::string GameState::whyIsNotLegal(const ActionType & action) const
 {
     std::stringstream ss;
@@ -17,21 +17,16 @@ namespace BOSS
 typedef std::pair<ResourceCountType, ResourceCountType>     ResourcePair;
 typedef std::pair<FrameCountType, FrameCountType>           FramePair;
 
-class ActionPerformed
+// the mining rates from a frame until the next action in progress finishes, and what has been mined
+// from the current frame up to that frame
+class IncomeStep
 {
 public:
-    ActionType          actionType;
-    FrameCountType      actionQueuedFrame;
-    ResourceCountType   mineralsWhenQueued;
-    ResourceCountType   gasWhenQueued;
-
-    ActionPerformed()
-        : actionQueuedFrame(0)
-        , mineralsWhenQueued(0)
-        , gasWhenQueued(0)
-    {
-    
-    }
+    FrameCountType              frame;
+    ResourceCountType           minerals;
+    ResourceCountType           gas;
+    int                         mineralWorkers;
+    int                         gasWorkers;
 };
 
 class GameState 
@@ -48,7 +43,15 @@ class GameState
     ResourceCountType           _minerals; 			        // current mineral count
     ResourceCountType           _gas;						// current gas count
 
-    std::vector<ActionPerformed>   _actionsPerformed;
+    // income is piecewise linear between the frames the actions in progress finish. The steps are worked
+    // out as far as the prices asked about need, once per state, after which when minerals or gas will be
+    // ready is a lookup. A state is only used by one search thread, so they can be kept as a cache.
+    mutable Vec<IncomeStep, Constants::MAX_PROGRESS + 1>    _income;
+    mutable size_t              _incomeActions;             // actions in progress the steps have got to
+
+    void                        clearIncome();
+    void                        addIncomeStep()                                                         const;
+    const FrameCountType        whenIncomeReaches(const ResourceCountType amount, const bool gas)       const;
 
     const FrameCountType        raceSpecificWhenReady(const ActionType & a) const;
     void                        fixZergUnitMasks();
@@ -71,8 +74,8 @@ public:
     GameState(BWAPI::GameWrapper & game, BWAPI::PlayerInterface * player, const std::vector<BWAPI::UnitType> & buildingsQueued);
 #endif
 
-	std::vector<ActionType>     doAction(const ActionType & action);
-    std::vector<ActionType>     fastForward(const FrameCountType toFrame) ;
+	void                        doAction(const ActionType & action);
+    void                        fastForward(const FrameCountType toFrame);
     void                        finishNextActionInProgress();
 
     const FrameCountType        getCurrentFrame()                                                       const;
@@ -96,6 +99,7 @@ public:
     const RaceID                getRace()                       const;
 
     const UnitData &            getUnitData()                   const;
+    const HashType              getHash()                       const;
 
     const ResourceCountType     getMinerals(const int frame)    const;
     const ResourceCountType     getGas(const int frame)         const;
@@ -103,7 +107,6 @@ public:
     const ResourceCountType     getFinishTimeGas()              const;
 
     const std::string           toString()                      const;
-    const std::string           getActionsPerformedString()     const;
     const BuildingData &        getBuildingData()               const;
     const HatcheryData &        getHatcheryData()               const;
 
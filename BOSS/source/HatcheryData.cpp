@@ -12,18 +12,14 @@ Hatchery::Hatchery()
 {
 }
 
-void Hatchery::fastForward(const FrameCountType & currentFrame, const FrameCountType & toFrame)
+// returns how many of the larva spawned the hatchery had room for
+UnitCountType Hatchery::addLarva(const UnitCountType & larvaSpawned)
 {
-    if (_numLarva == 3)
-    {
-        return;
-    }
-
-    UnitCountType  larvaToAdd   = (toFrame / Constants::ZERG_LARVA_TIMER) - (currentFrame / Constants::ZERG_LARVA_TIMER);
-
-    larvaToAdd                  = std::min(larvaToAdd, (UnitCountType)(3 - _numLarva));
+    const UnitCountType larvaToAdd = std::min(larvaSpawned, (UnitCountType)(3 - _numLarva));
 
     _numLarva += larvaToAdd;
+
+    return larvaToAdd;
 }
 
 void Hatchery::useLarva()
@@ -39,6 +35,7 @@ const UnitCountType & Hatchery::numLarva() const
 }
 
 HatcheryData::HatcheryData()
+    : _numLarva(0)
 {
 
 }
@@ -46,18 +43,28 @@ HatcheryData::HatcheryData()
 void HatcheryData::addHatchery(const UnitCountType & numLarva)
 {
     _hatcheries.push_back(Hatchery(numLarva));
+    _numLarva += numLarva;
 }
 
 void HatcheryData::removeHatchery()
 {
+    _numLarva -= _hatcheries.back().numLarva();
 	_hatcheries.pop_back();
 }
 
 void HatcheryData::fastForward(const FrameCountType & currentFrame, const FrameCountType & toFrame)
 {
+    const UnitCountType larvaSpawned = (toFrame / Constants::ZERG_LARVA_TIMER) - (currentFrame / Constants::ZERG_LARVA_TIMER);
+
+    // no larva timer went off, or every hatchery is full
+    if (larvaSpawned == 0 || _numLarva == 3 * _hatcheries.size())
+    {
+        return;
+    }
+
     for (size_t i(0); i < _hatcheries.size(); ++i)
     {
-        _hatcheries[i].fastForward(currentFrame, toFrame);
+        _numLarva += _hatcheries[i].addLarva(larvaSpawned);
     }
 }
 
@@ -78,6 +85,7 @@ void HatcheryData::useLarva()
     if (maxLarvaIndex != -1)
     {
         _hatcheries[maxLarvaIndex].useLarva();
+        _numLarva--;
     }
     else
     {
@@ -99,14 +107,7 @@ const FrameCountType HatcheryData::nextLarvaFrameAfter(const FrameCountType & cu
 
 const UnitCountType HatcheryData::numLarva() const
 {
-    UnitCountType sumLarva = 0;
-
-    for (size_t i(0); i < _hatcheries.size(); ++i)
-    {
-        sumLarva += _hatcheries[i].numLarva();
-    }
-
-    return sumLarva;
+    return _numLarva;
 }
 
 const UnitCountType HatcheryData::size() const
@@ -24,14 +24,18 @@ public:
 
        
     void                    useLarva();
-    void                    fastForward(const FrameCountType & currentFrame, const FrameCountType & toFrame);
+    UnitCountType           addLarva(const UnitCountType & larvaSpawned);
 
     const UnitCountType &   numLarva() const;
 };
 
+// Every hatchery spawns a larva on the same global timer, every ZERG_LARVA_TIMER frames, until it has 3.
+// So the larva spawned between two frames is worked out once from the frames, not per hatchery, and
+// the total larva is kept up to date instead of being added up for every action asked about.
 class HatcheryData
 {
     Vec<Hatchery, Constants::MAX_HATCHERIES> _hatcheries;
+    UnitCountType                            _numLarva;
 
 public:
 
@@ -74,9 +74,8 @@ const BuildOrder & NaiveBuildOrderSearch::solve()
 
     // Add the required units to a preliminary build order
     BuildOrder buildOrder;
-    for (size_t a(0); a < requiredToBuild.size(); ++a)
+    for (const ActionType & type : requiredToBuild)
     {
-        const ActionType & type = requiredToBuild.getActionType(a);
         buildOrder.add(type);
     }
 
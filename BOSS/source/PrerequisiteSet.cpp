@@ -2,69 +2,67 @@
 
 using namespace BOSS;
 
-ActionCountPair::ActionCountPair()
-    : _count(0)
+PrerequisiteSet::PrerequisiteSet()
+    : _counts()
 {
 
 }
 
-ActionCountPair::ActionCountPair(const ActionType & action, const UnitCountType count)
-    : _action(action)
-    , _count(count)
+const size_t PrerequisiteSet::size() const
 {
+    return _actions.size();
 }
 
-const ActionType & ActionCountPair::getAction() const
+const bool PrerequisiteSet::isEmpty() const
 {
-    return _action;
+    return _actions.isEmpty();
 }
 
-const UnitCountType & ActionCountPair::getCount() const
+const bool PrerequisiteSet::contains(const ActionType & action) const
 {
-    return _count;       
+    return _actions.contains(action);
 }
 
-PrerequisiteSet::PrerequisiteSet()
+ActionType PrerequisiteSet::getActionType(const UnitCountType index) const
 {
-
+    return _actions[index];
 }
 
-const size_t PrerequisiteSet::size() const
+const UnitCountType & PrerequisiteSet::getActionTypeCount(const UnitCountType index) const
 {
-    return _actionCounts.size();
+    return _counts[_actions[index].ID()];
 }
 
-const bool PrerequisiteSet::isEmpty() const
+const UnitCountType & PrerequisiteSet::getCount(const ActionType & action) const
 {
-    return size() == 0;
+    BOSS_ASSERT(contains(action), "Action is not in the PrerequisiteSet: %s", action.getName().c_str());
+
+    return _counts[action.ID()];
 }
 
-const bool PrerequisiteSet::contains(const ActionType & action) const
+const ActionSet & PrerequisiteSet::getActions() const
 {
-    for (size_t i(0); i<_actionCounts.size(); ++i)
-    {
-        if (getActionType(i) == action)
-        {
-            return true;
-        }
-    }
-
-    return false;
+    return _actions;
 }
 
-const ActionType & PrerequisiteSet::getActionType(const UnitCountType index) const
+ActionSet::const_iterator PrerequisiteSet::begin() const
 {
-    return _actionCounts[index].getAction();
+    return _actions.begin();
 }
 
-const UnitCountType & PrerequisiteSet::getActionTypeCount(const UnitCountType index) const
+ActionSet::const_iterator PrerequisiteSet::end() const
 {
-    return _actionCounts[index].getCount();
+    return _actions.end();
 }
     
 void PrerequisiteSet::add(const ActionType & action, const UnitCountType count)
 {
-    _actionCounts.push_back(ActionCountPair(action, count));
+    if (!contains(action) || _counts[action.ID()] < count)
+    {
+        _counts[action.ID()] = count;
+    }
+
+    _actions.add(action);
 }
 
 void PrerequisiteSet::addUnique(const ActionType & action, const UnitCountType count)
@@ -77,45 +75,30 @@ void PrerequisiteSet::addUnique(const ActionType & action, const UnitCountType c
 
 void PrerequisiteSet::addUnique(const PrerequisiteSet & set)
 {
-    for (size_t i(0); i<set.size(); ++i)
+    for (const ActionType & action : set)
     {
-        addUnique(set.getActionType(i), set.getActionTypeCount(i));
+        addUnique(action, set.getCount(action));
     }
 }
 
 void PrerequisiteSet::remove(const ActionType & action)
 {
-    for (size_t i(0); i<_actionCounts.size(); ++i)
-    {
-        if (_actionCounts[i].getAction() == action)
-        {
-            _actionCounts.remove(i);
-            return;
-        }
-    }
+    _actions.remove(action);
 }
 
 void PrerequisiteSet::remove(const PrerequisiteSet & set)
 {
-    if (isEmpty())
-    {
-        return;
-    }
-
-    for (size_t i(0); i < set.size(); ++i)
-    {
-        remove(set.getActionType(i));
-    }
+    _actions.remove(set._actions);
 }
 
 const std::string PrerequisiteSet::toString() const
 {
     std::stringstream ss;
     
-    for (size_t i(0); i<size(); ++i)
+    for (const ActionType & action : *this)
     {
-        ss << "    Prereq:   " << (int)getActionTypeCount(i) << " " << getActionType(i).getName() << "\n";
+        ss << "    Prereq:   " << (int)getCount(action) << " " << action.getName() << "\n";
     }
 
     return ss.str();
-}
\ No newline at end of file
+}
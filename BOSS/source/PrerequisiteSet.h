@@ -2,31 +2,18 @@
 
 #include "Common.h"
 #include "Constants.h"
-#include "Array.hpp"
 #include "ActionType.h"
+#include "ActionSet.h"
 
 namespace BOSS
 {
 
-class ActionCountPair
-{
-    ActionType      _action;
-    UnitCountType   _count;
-
-public:
-
-    ActionCountPair();
-
-    ActionCountPair(const ActionType & action, const UnitCountType count);
-
-    const ActionType & getAction() const;
-
-    const UnitCountType & getCount() const;
-};
-
+// The actions which another action requires, and how many of each. The actions are an ActionSet, so
+// they are in order of ID, and the counts are kept by action ID beside it.
 class PrerequisiteSet
 {
-	Vec<ActionCountPair, Constants::MAX_ACTION_TYPES> _actionCounts;
+    ActionSet       _actions;
+    UnitCountType   _counts[Constants::MAX_ACTION_TYPES];
 
 public:
 
@@ -35,9 +22,15 @@ public:
     const size_t size() const;
     const bool isEmpty() const;
     const bool contains(const ActionType & action) const;
-    const ActionType & getActionType(const UnitCountType index) const;
+    ActionType getActionType(const UnitCountType index) const;
     const UnitCountType & getActionTypeCount(const UnitCountType index) const;
-    
+    const UnitCountType & getCount(const ActionType & action) const;
+    const ActionSet & getActions() const;
+
+    ActionSet::const_iterator begin() const;
+    ActionSet::const_iterator end() const;
+
+    // adding an action which is already in the set keeps the larger count
     void add(const ActionType & action, const UnitCountType count = 1);
     void addUnique(const ActionType & action, const UnitCountType count = 1);
     void addUnique(const PrerequisiteSet & set);
@@ -47,4 +40,4 @@ public:
     const std::string toString() const;
 };
 
-}
\ No newline at end of file
+}
@@ -84,9 +84,8 @@ BuildOrder Tools::GetNaiveBuildOrderAddWorkersOld(const GameState & state, const
 
     // Add the required units to a preliminary build order
     BuildOrder buildOrder;
-    for (size_t a(0); a < requiredToBuild.size(); ++a)
+    for (const ActionType & type : requiredToBuild)
     {
-        const ActionType & type = requiredToBuild.getActionType(a);
         buildOrder.add(type);
         buildOrderActionTypeCount[type.ID()]++;
     }
@@ -369,9 +368,9 @@ void Tools::CalculatePrerequisitesRequiredToBuild(const GameState & state, const
     const ActionType & refinery = ActionTypes::GetRefinery(state.getRace());
     if (!needed.contains(refinery) && (state.getUnitData().getNumCompleted(refinery) == 0) && !added.contains(refinery))
     {
-        for (size_t n(0); n<needed.size(); ++n)
+        for (const ActionType & neededType : needed)
         {
-            if (needed.getActionType(n).gasPrice() > 0)
+            if (neededType.gasPrice() > 0)
             {
                 allNeeded.add(refinery);
                 break;
@@ -379,9 +378,8 @@ void Tools::CalculatePrerequisitesRequiredToBuild(const GameState & state, const
         }
     }
 
-    for (size_t n(0); n<allNeeded.size(); ++n)
+    for (const ActionType & neededType : allNeeded)
     {
-        const ActionType & neededType = allNeeded.getActionType(n);
 
         // if we already have the needed type completed we can skip it
         if (added.contains(neededType) || state.getUnitData().getNumCompleted(neededType) > 0)
@@ -406,9 +404,8 @@ void Tools::CalculatePrerequisitesRequiredToBuild(const GameState & state, const
 FrameCountType Tools::CalculatePrerequisitesLowerBound(const GameState & state, const PrerequisiteSet & needed, FrameCountType timeSoFar, int depth)
 {
     FrameCountType max = 0;
-    for (size_t n(0); n<needed.size(); ++n)
+    for (const ActionType & neededType : needed)
     {
-        const ActionType & neededType = needed.getActionType(n);
         FrameCountType thisActionTime = 0;
 
         // if we already have the needed type completed we can skip it
@@ -10,10 +10,18 @@ UnitData::UnitData(const RaceID race)
     , _mineralWorkers(0)
     , _gasWorkers(0)
     , _buildingWorkers(0)
+    , _hash(0)
 {
 
 }
 
+// keeps the key up to date with the number of completed units
+void UnitData::setNumCompleted(const ActionType & action, const UnitCountType & num)
+{
+    _hash += Zobrist::Completed(action.ID(), num) - Zobrist::Completed(action.ID(), _numUnits[action.ID()]);
+    _numUnits[action.ID()] = num;
+}
+
 const RaceID UnitData::getRace() const
 {
     return _race;
@@ -37,7 +45,7 @@ const FrameCountType UnitData::getWhenBuildingCanBuild(const ActionType & action
 // only used for adding existing buildings from a BWAPI Game * object
 void UnitData::addCompletedBuilding(const ActionType & action, const FrameCountType timeUntilFree, const ActionType & constructing, const ActionType & addon, int numLarva)
 {
-    _numUnits[action.ID()] += action.numProduced();
+    setNumCompleted(action, _numUnits[action.ID()] + action.numProduced());
 
     _maxSupply += action.supplyProvided();
 
@@ -66,7 +74,7 @@ void UnitData::addCompletedAction(const ActionType & action, bool wasBuilt)
     const static ActionType Lair = ActionTypes::GetActionType("Zerg_Lair");
     const static ActionType Hive = ActionTypes::GetActionType("Zerg_Hive");
 
-    _numUnits[action.ID()] += wasBuilt ? action.numProduced() : 1;
+    setNumCompleted(action, _numUnits[action.ID()] + (wasBuilt ? action.numProduced() : 1));
 
     if (wasBuilt)
     {
@@ -115,7 +123,7 @@ void UnitData::removeCompletedAction(const ActionType & action)
 	const static ActionType Lair = ActionTypes::GetActionType("Zerg_Lair");
 	const static ActionType Hive = ActionTypes::GetActionType("Zerg_Hive");
 
-	_numUnits[action.ID()] -= action.numProduced();
+	setNumCompleted(action, _numUnits[action.ID()] - action.numProduced());
 
 
 		// a lair or hive from a hatchery don't produce additional supply
@@ -167,6 +175,7 @@ void UnitData::addActionInProgress(const ActionType & action, const FrameCountTy
 
 	// add it to the actions in progress
 	_progress.addAction(action, finishTime);
+    _hash += Zobrist::InProgress(action.ID(), finishTime);
     
     if (!action.isMorphed())
     {
@@ -196,6 +205,19 @@ const SupplyCountType UnitData::getMaxSupply() const
     return _maxSupply;
 }
 
+// the worker jobs and the larva are cheap to add up, so they are added here instead of being kept in _hash
+const HashType UnitData::getHash() const
+{
+    HashType hash = _hash + Zobrist::Workers(_mineralWorkers, _gasWorkers, _buildingWorkers);
+
+    for (size_t i(0); i < _hatcheryData.size(); ++i)
+    {
+        hash += Zobrist::Larva(i, _hatcheryData.getHatchery(i).numLarva());
+    }
+
+    return hash;
+}
+
 void UnitData::setBuildingWorker()
 {
     BOSS_ASSERT(_mineralWorkers > 0, "Tried to build without a worker");
@@ -238,7 +260,7 @@ void UnitData::setBuildingWorkers(const UnitCountType & buildingWorkers)
 void UnitData::morphUnit(const ActionType & from, const ActionType & to, const FrameCountType & completionFrame)
 {
     BOSS_ASSERT(getNumCompleted(from) > 0, "Must have the unit type to morph it");
-    _numUnits[from.ID()]--;
+    setNumCompleted(from, _numUnits[from.ID()] - 1);
     _currentSupply -= from.supplyRequired();
 
     if (from.isWorker())
@@ -274,6 +296,7 @@ ActionType UnitData::finishNextActionInProgress()
 	addCompletedAction(action);
 			
 	// pop it from the progress vector
+    _hash -= Zobrist::InProgress(action.ID(), _progress.nextActionFinishTime());
 	_progress.popNextAction();
 			
 	if (getRace() == Races::Terran)
@@ -321,10 +344,9 @@ const bool UnitData::hasPrerequisites(const PrerequisiteSet & required) const
     static const ActionType & Spire         = ActionTypes::GetActionType("Zerg_Spire");
     static const ActionType & GreaterSpire  = ActionTypes::GetActionType("Zerg_Greater_Spire");
 
-    for (size_t a(0); a<required.size(); ++a)
+    for (const ActionType & type : required)
     {
-        const ActionType & type = required.getActionType(a);
-        const size_t & req = required.getActionTypeCount(a);
+        const size_t req = required.getCount(type);
         size_t have = getNumTotal(type);
 
         // special check for zerg moprhed buildings
@@ -411,9 +433,8 @@ const PrerequisiteSet UnitData::getPrerequistesInProgress(const ActionType & act
 {
     PrerequisiteSet inProgress;
 
-    for (size_t a(0); a<action.getPrerequisites().size(); ++a)
+    for (const ActionType & actionType : action.getPrerequisites())
     {
-        const ActionType & actionType = action.getPrerequisites().getActionType(a);
         if (getNumInProgress(actionType) > 0 && getNumCompleted(actionType) == 0)
         {
             inProgress.add(actionType);
@@ -6,6 +6,7 @@
 #include "ActionType.h"
 #include "ActionInProgress.h"
 #include "HatcheryData.h"
+#include "Zobrist.h"
 
 namespace BOSS
 {
@@ -27,6 +28,10 @@ class UnitData
     ActionsInProgress	                _progress;					
     BuildingData		                _buildings;
 
+    HashType                            _hash;                      // Zobrist key of the completed units and the actions in progress
+
+    void                    setNumCompleted(const ActionType & action, const UnitCountType & num);
+
 public:
 
     UnitData(const RaceID race);
@@ -64,6 +69,7 @@ public:
 
     const SupplyCountType   getCurrentSupply() const;
     const SupplyCountType   getMaxSupply() const;
+    const HashType          getHash() const;
     
     void                    setCurrentSupply(const UnitCountType & supply);
     void                    setBuildingWorker();
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "BaseTypes.h"
+
+namespace BOSS
+{
+    // Zobrist keys for the parts of a search state. A state's key is the sum of the keys of its parts,
+    // which makes it a hash of a multiset (two identical actions in progress don't cancel out like they
+    // would with xor) that can be kept up to date by adding a part's key when it appears and subtracting
+    // it when it goes. The keys are mixed from the part's value instead of drawn from a random table,
+    // since finish times have no fixed range.
+    namespace Zobrist
+    {
+        // the splitmix64 finalizer
+        inline HashType Mix(HashType x)
+        {
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+            return x ^ (x >> 31);
+        }
+
+        enum PartType { CompletedPart = 1, InProgressPart, WorkersPart, LarvaPart };
+
+        inline HashType Part(PartType type, HashType a, HashType b)
+        {
+            return Mix((HashType(type) << 56) ^ (a << 32) ^ (b & 0xffffffffULL) ^ 0x9e3779b97f4a7c15ULL);
+        }
+
+        inline HashType Completed(ActionID action, UnitCountType count)
+        {
+            return Part(CompletedPart, action, count);
+        }
+
+        inline HashType InProgress(ActionID action, FrameCountType finishTime)
+        {
+            return Part(InProgressPart, action, (unsigned int)finishTime);
+        }
+
+        inline HashType Workers(UnitCountType mineral, UnitCountType gas, UnitCountType building)
+        {
+            return Part(WorkersPart, mineral, (HashType(gas) << 16) | building);
+        }
+
+        inline HashType Larva(size_t hatchery, UnitCountType count)
+        {
+            return Part(LarvaPart, hatchery, count);
+        }
+    }
+}
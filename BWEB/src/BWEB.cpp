@@ -37,16 +37,7 @@ namespace BWEB
 		const auto tile(unit->getTilePosition());
 		auto type(unit->getType());
 
-		for (auto x = tile.x; x < tile.x + type.tileWidth(); x++)
-		{
-			for (auto y = tile.y; y < tile.y + type.tileHeight(); y++)
-			{
-				TilePosition t(x, y);
-				if (!t.isValid()) continue;
-				usedTiles.insert(t);
-                usedTilesGrid[x][y] = true;
-			}
-		}
+		occupancy.set(Layers::Used, tile, type.tileWidth(), type.tileHeight());
 	}
 
 	void Map::onUnitMorph(const Unit unit)
@@ -61,16 +52,7 @@ namespace BWEB
 		const auto tile(unit->getTilePosition());
 		auto type(unit->getType());
 
-		for (auto x = tile.x; x < tile.x + type.tileWidth(); x++)
-		{
-			for (auto y = tile.y; y < tile.y + type.tileHeight(); y++)
-			{
-				TilePosition t(x, y);
-				if (!t.isValid()) continue;
-				usedTiles.erase(t);
-				usedTilesGrid[x][y] = false;
-			}
-		}
+		occupancy.reset(Layers::Used | Layers::Planned, tile, type.tileWidth(), type.tileHeight());
 	}
 
 	void Map::findMain()
@@ -207,7 +189,7 @@ namespace BWEB
 				TilePosition t(x, y);
 				//if (visited[UnitTypes::Protoss_Gateway].location[t.x][t.y] == 1)
 				//	Broodwar->drawBoxMap(Position(t), Position(t) + Position(33, 33), Colors::Yellow, false);
-				if (reserveGrid[x][y] >= 1)
+				if (occupancy.test(Layers::Reserve, t))
 					Broodwar->drawBoxMap(Position(t), Position(t) + Position(33, 33), Colors::Black, false);
 			}
 		}
@@ -290,6 +272,9 @@ namespace BWEB
 	{
 		// Placeable is valid if buildable and not overlapping neutrals
 		// Note: Must check neutrals due to the terrain below them technically being buildable
+		if (occupancy.any(Layers::Used | Layers::Reserve, location, type.tileWidth(), type.tileHeight()))
+			return false;
+
 		const auto creepCheck = type.requiresCreep() ? true : false;	
 		for (auto x = location.x; x < location.x + type.tileWidth(); x++){
 
@@ -302,8 +287,6 @@ namespace BWEB
 			for (auto y = location.y; y < location.y + type.tileHeight(); y++)	{
 				TilePosition tile(x, y);
 				if (!tile.isValid() || !Broodwar->isBuildable(tile)) return false;
-				if (usedTilesGrid[x][y]) return false;
-				if (reserveGrid[x][y] > 0) return false;
 				if (type.isResourceDepot() && !Broodwar->canBuildHere(tile, type)) return false;
                 if (Broodwar->hasCreep(tile)) return false;
 			}
@@ -314,13 +297,7 @@ namespace BWEB
 
 	void Map::addOverlap(const TilePosition t, const int w, const int h)
 	{
-		for (auto x = t.x; x < t.x + w; x++)
-		{
-			for (auto y = t.y; y < t.y + h; y++)
-			{
-				overlapGrid[x][y] = 1;
-			}
-		}
+		occupancy.set(Layers::Overlap, t, w, h);
 	}
 
 	Map* Map::BWEBInstance = nullptr;
@@ -1,5 +1,7 @@
 #pragma once
 #pragma warning(disable : 4351)
+#include <atomic>
+#include <chrono>
 #include <set>
 
 #include <BWAPI.h>
@@ -7,6 +9,7 @@
 #include "Station.h"
 #include "Block.h"
 #include "Wall.h"
+#include "Occupancy.h"
 
 namespace BWEB
 {
@@ -54,6 +57,16 @@ namespace BWEB
 		void insertTechBlock(BWAPI::Race, TilePosition, bool, bool);
 		map<const BWEM::Area *, int> typePerArea;
 
+		// State of the block search, so it can stop at a deadline and resume where it stopped (Cf. continueBlocks)
+		struct BlockSearch
+		{
+			BWAPI::Race race;
+			vector<int> heights, widths;
+			vector<TilePosition> tiles;		// Buildable tiles, closest to the natural choke first
+			int blockTiles = 0, height = 0;
+			size_t next = 0;
+		} blockSearch;
+
 		// Walls
 		bool isWallTight(UnitType, TilePosition);
 		bool isPoweringWall(TilePosition);
@@ -64,8 +77,6 @@ namespace BWEB
 		bool identicalPiece(TilePosition, UnitType, TilePosition, UnitType);
 		void findCurrentHole(bool ignoreOverlap = false);
 		void addWallDefenses(const vector<UnitType>& type, Wall& wall);
-		int reserveGrid[256][256] = {};
-		int testGrid[256][256] = {};
 
 		double bestWallScore = 0.0, closest = DBL_MAX;
 		TilePosition currentHole, startTile, endTile;
@@ -96,6 +107,9 @@ namespace BWEB
 		bool parentSame{}, currentSame{};
 		double currentPathSize{};
 
+		// Parallel wall search: with more than one thread, each thread searches on its own copy of the map, so the search state above is private to it
+		int wallSearchThreads = 1;
+
 		// Map
 		void findMain(), findMainChoke(), findNatural(), findNaturalChoke();
 		Position mainPosition, naturalPosition;
@@ -104,7 +118,6 @@ namespace BWEB
 		const BWEM::Area * mainArea{};
 		const BWEM::ChokePoint * naturalChoke{};
 		const BWEM::ChokePoint * mainChoke{};
-		set<TilePosition> usedTiles;
 		void addOverlap(TilePosition, int, int);
 		bool isPlaceable(UnitType, TilePosition);
 
@@ -122,8 +135,9 @@ namespace BWEB
 		Map(BWEM::Map& map);
 		void draw(), onStart(), onUnitDiscover(Unit), onUnitDestroy(Unit), onUnitMorph(Unit);
 		static Map &Instance();
-		int overlapGrid[256][256] = {};
-		bool usedTilesGrid[256][256] = {};
+
+		/// What takes up each tile of the map, see Layers
+		Occupancy occupancy;
 
 		/// This is just put here so AStar can use it for now
 		UnitType overlapsCurrentWall(TilePosition tile, int width = 1, int height = 1);
@@ -199,8 +213,8 @@ namespace BWEB
 		/// Returns the TilePosition of the main
 		TilePosition getMain() const { return mainTile; }
 
-		/// Returns the set of used TilePositions
-		set<TilePosition>& getUsedTiles() { return usedTiles; }
+		/// Returns the occupancy of the map's tiles
+		Occupancy& getOccupancy() { return occupancy; }
 
 		/// <summary> <para> Given a vector of UnitTypes, an Area and a Chokepoint, finds an optimal wall placement, returns true if a valid BWEB::Wall was created. </para>
 		/// <para> Note: Highly recommend that only Terran walls attempt to be walled tight, as most Protoss and Zerg wallins have gaps to allow your units through.</para>
@@ -214,12 +228,20 @@ namespace BWEB
 		/// <param name="requireTight"> Optional parameter to ensure that the Wall must be walltight. </param>
 		void createWall(vector<UnitType>& buildings, const BWEM::Area * area, const BWEM::ChokePoint * choke, UnitType tight = UnitTypes::None, const vector<UnitType>& defenses = {}, bool reservePath = false, bool requireTight = false);
 
+		/// <summary> Sets the number of threads createWall may use to search for the wall placement (1 by default). The resulting wall is the same either way. </summary>
+		/// <param name="threads"> The number of threads, the calling thread included. </param>
+		void setWallSearchThreads(int threads) { wallSearchThreads = max(1, threads); }
+
 		/// <summary> Adds a UnitType to a currently existing BWEB::Wall. </summary>
 		/// <param name="type"> The UnitType you want to place at the BWEB::Wall. </param>
 		/// <param name="area"> The BWEB::Wall you want to add to. </param>
 		/// <param name="tight"> (Optional) Decides whether this addition to the BWEB::Wall intends to be walled around a specific UnitType. Defaults to none. </param>
 		void addToWall(UnitType type, Wall& wall, UnitType tight = UnitTypes::None);
 
+		/// <summary> Adds a BWEB::Block and marks its tiles in the Block layer. Add blocks with this rather than to the vector, so overlapsBlocks sees them. </summary>
+		/// <param name="block"> The BWEB::Block to add. </param>
+		void addBlock(const Block& block);
+
 		/// <summary> Erases any blocks at the specified TilePosition. </summary>
 		/// <param name="here"> The TilePosition that you want to delete any BWEB::Block that exists here. </param>
 		void eraseBlock(TilePosition here);
@@ -229,6 +251,13 @@ namespace BWEB
 		void findBlocks(BWAPI::Race);
 		void findBlocks();
 
+		/// <summary> Places the start block and starts a search for the other blocks, which continueBlocks carries out. Use instead of findBlocks to spread the search over several frames. </summary>
+		void startBlocks(BWAPI::Race);
+
+		/// <summary> Continues the block search started by startBlocks until it is done or the deadline passes. Returns true when it is done. </summary>
+		/// <param name="deadline"> When to stop searching. </param>
+		bool continueBlocks(chrono::steady_clock::time_point deadline = chrono::steady_clock::time_point::max());
+
 		vector<TilePosition> findPath(BWEM::Map&, BWEB::Map&, const TilePosition, const TilePosition, bool inSameArea = false, bool ignoreUsedTiles = false, bool ignoreOverlap = false, bool ignoreWalls = false, bool diagonal = false);
 	};
 
@@ -4,23 +4,12 @@ namespace BWEB
 {
 	bool Map::overlapsStations(const TilePosition here)
 	{
-		for (auto& station : Stations())
-		{
-			const auto tile = station.BWEMBase()->Location();
-			if (here.x >= tile.x && here.x < tile.x + 4 && here.y >= tile.y && here.y < tile.y + 3) return true;
-			for (auto& defense : station.DefenseLocations())
-				if (here.x >= defense.x && here.x < defense.x + 2 && here.y >= defense.y && here.y < defense.y + 2) return true;
-		}
-		return false;
+		return occupancy.test(Layers::Station, here);
 	}
 
 	bool Map::overlapsBlocks(const TilePosition here)
 	{
-		for (auto& block : Blocks())
-		{
-			if (here.x >= block.Location().x && here.x < block.Location().x + block.width() && here.y >= block.Location().y && here.y < block.Location().y + block.height()) return true;
-		}
-		return false;
+		return occupancy.test(Layers::Block, here);
 	}
 
 	bool Map::overlapsMining(TilePosition here)
@@ -60,36 +49,12 @@ namespace BWEB
 
 	bool Map::overlapsWalls(const TilePosition here)
 	{
-		const auto x = here.x;
-		const auto y = here.y;
-
-		for (auto& wall : getWalls())
-		{
-			for (const auto tile : wall.smallTiles())
-				if (x >= tile.x && x < tile.x + 2 && y >= tile.y && y < tile.y + 2) return true;
-			for (const auto tile : wall.mediumTiles())
-				if (x >= tile.x && x < tile.x + 3 && y >= tile.y && y < tile.y + 2) return true;
-			for (const auto tile : wall.largeTiles())
-				if (x >= tile.x && x < tile.x + 4 && y >= tile.y && y < tile.y + 3) return true;
-
-			for (auto& defense : wall.getDefenses())
-				if (here.x >= defense.x && here.x < defense.x + 2 && here.y >= defense.y && here.y < defense.y + 2) return true;
-		}
-		return false;
+		return occupancy.test(Layers::Wall, here);
 	}
 
 	bool Map::overlapsAnything(const TilePosition here, const int width, const int height, bool ignoreBlocks)
 	{
-		for (auto x = here.x; x < here.x + width; x++) {
-			for (auto y = here.y; y < here.y + height; y++) {
-				TilePosition t(x, y);
-				if (!t.isValid())
-					continue;
-				if (overlapGrid[x][y] > 0)
-					return true;
-			}
-		}
-		return false;
+		return occupancy.any(Layers::Overlap, here, width, height);
 	}
 
 	bool Map::isWalkable(const TilePosition here)
@@ -41,9 +41,7 @@ namespace BWEB
 		const auto & defenseLocations = getClosestStation(mainTile)->DefenseLocations();
 
 		// Temporarily remove the nexus from the overlap grid while we find the start block
-		for (auto x = mainTile.x; x < mainTile.x + 4; x++)
-			for (auto y = mainTile.y; y < mainTile.y + 3; y++)
-				overlapGrid[x][y] = 0;
+		occupancy.reset(Layers::Overlap, mainTile, 4, 3);
 
 		TilePosition tileBest = BWAPI::TilePositions::Invalid;
 		int poweredDefensesBest = 0;
@@ -86,9 +84,7 @@ namespace BWEB
 		}
 
 		// Restore the overlap grid for the nexus
-		for (auto x = mainTile.x; x < mainTile.x + 4; x++)
-			for (auto y = mainTile.y; y < mainTile.y + 3; y++)
-				overlapGrid[x][y] = 0;
+		occupancy.reset(Layers::Overlap, mainTile, 4, 3);
 		
 		if (tileBest.isValid())
 		{
@@ -136,49 +132,76 @@ namespace BWEB
 		findBlocks(player->getRace());
 	}
 	void Map::findBlocks(BWAPI::Race race)
+	{
+		startBlocks(race);
+		continueBlocks();
+	}
+
+	void Map::startBlocks(BWAPI::Race race)
 	{
 		findStartBlock(race);
-		vector<int> heights;
-		vector<int> widths;
-		multimap<double, TilePosition> tilesByPathDist;
 
+		auto& search = blockSearch;
+		search = BlockSearch();
+		search.race = race;
+
+		vector<pair<double, TilePosition>> tilesByPathDist;
 		for (int x = 0; x < Broodwar->mapWidth(); x++) {
 			for (int y = 0; y < Broodwar->mapHeight(); y++) {
 				TilePosition t(x, y);
 				Position p(t);
 				if (t.isValid() && Broodwar->isBuildable(t)) {
 					double dist = naturalChoke ? p.getDistance(Position(naturalChoke->Center())) : p.getDistance(mainPosition);						
-					tilesByPathDist.insert(make_pair(dist, t));
+					tilesByPathDist.push_back(make_pair(dist, t));
 				}
 			}
 		}
+		stable_sort(tilesByPathDist.begin(), tilesByPathDist.end(), [](const pair<double, TilePosition>& a, const pair<double, TilePosition>& b) { return a.first < b.first; });
+		for (auto& t : tilesByPathDist)
+			search.tiles.push_back(t.second);
 
 		if (race == Races::Protoss) {
-			heights.insert(heights.end(), { 2, 4, 5, 6, 7, 8 });
-			widths.insert(widths.end(), { 2, 4, 5, 8, 9, 10, 13, 17, 18 });
+			search.heights.insert(search.heights.end(), { 2, 4, 5, 6, 7, 8 });
+			search.widths.insert(search.widths.end(), { 2, 4, 5, 8, 9, 10, 13, 17, 18 });
 		}
 		else if (race == Races::Terran) {
-			heights.insert(heights.end(), { 2, 4, 5, 6 });
-			widths.insert(widths.end(), { 3, 6, 10 });
+			search.heights.insert(search.heights.end(), { 2, 4, 5, 6 });
+			search.widths.insert(search.widths.end(), { 3, 6, 10 });
 		}
 
 		// Consider large blocks first
-        for (int tiles = 108; tiles >= 4; tiles--) {
-            for (int height = 8; height >= 2; height--) {
-                if (tiles % height != 0) continue;
-                int width = tiles / height;
-				for (auto& t : tilesByPathDist) {
-					TilePosition tile(t.second);
-					if (find(heights.begin(), heights.end(), height) == heights.end() || find(widths.begin(), widths.end(), width) == widths.end())
-						continue;
-
-					if (canAddBlock(tile, width, height)) {
-						insertBlock(race, tile, width, height);
+		search.blockTiles = 108;
+		search.height = 8;
+	}
+
+	bool Map::continueBlocks(const chrono::steady_clock::time_point deadline)
+	{
+		auto& search = blockSearch;
+		if (search.blockTiles < 4)
+			return true;
+
+		for (; search.blockTiles >= 4; search.blockTiles--, search.height = 8) {
+			for (; search.height >= 2; search.height--, search.next = 0) {
+				if (search.blockTiles % search.height != 0) continue;
+				const auto width = search.blockTiles / search.height;
+				if (find(search.heights.begin(), search.heights.end(), search.height) == search.heights.end() || find(search.widths.begin(), search.widths.end(), width) == search.widths.end())
+					continue;
+
+				for (; search.next < search.tiles.size(); search.next++) {
+					if (chrono::steady_clock::now() >= deadline)
+						return false;
+
+					const auto tile = search.tiles[search.next];
+					if (canAddBlock(tile, width, search.height)) {
+						insertBlock(search.race, tile, width, search.height);
 					}
 				}
 			}
 		}
 
+		search.tiles.clear();
+		search.tiles.shrink_to_fit();
+
         int totalBlocks = 0;
         int totalSmall = 0;
         int totalMedium = 0;
@@ -191,6 +214,7 @@ namespace BWEB
             totalLarge += block.LargeTiles().size();
         }
         Log().Get() << "Found " << totalBlocks << " blocks. Small tiles: " << totalSmall << ", medium tiles: " << totalMedium << ", large tiles: " << totalLarge;
+		return true;
 	}
 
 	bool Map::canAddBlock(const TilePosition here, const int width, const int height)
@@ -202,17 +226,20 @@ namespace BWEB
 		TilePosition four(here.x + width - 1, here.y + height - 1);
 
 		if (!one.isValid() || !two.isValid() || !three.isValid() || !four.isValid()) return false;
-		if (!mapBWEM.GetTile(one).Buildable() || overlapsAnything(one)) return false;
-		if (!mapBWEM.GetTile(two).Buildable() || overlapsAnything(two)) return false;
-		if (!mapBWEM.GetTile(three).Buildable() || overlapsAnything(three)) return false;
-		if (!mapBWEM.GetTile(four).Buildable() || overlapsAnything(four)) return false;
+		if (!mapBWEM.GetPackedTile(one).Buildable() || overlapsAnything(one)) return false;
+		if (!mapBWEM.GetPackedTile(two).Buildable() || overlapsAnything(two)) return false;
+		if (!mapBWEM.GetPackedTile(three).Buildable() || overlapsAnything(three)) return false;
+		if (!mapBWEM.GetPackedTile(four).Buildable() || overlapsAnything(four)) return false;
 
 		// Check if a block of specified size would overlap any bases, resources or other blocks
+		if (occupancy.any(Layers::Overlap, here - TilePosition(1, 1), width + 2, height + 2))
+			return false;
+
 		for (auto x = here.x - 1; x < here.x + width + 1; x++) {
 			for (auto y = here.y - 1; y < here.y + height + 1; y++) {
 
 				TilePosition t(x, y);
-				if (!t.isValid() || !mapBWEM.GetTile(t).Buildable() || overlapGrid[x][y] > 0 || overlapsMining(t))
+				if (!t.isValid() || !mapBWEM.GetPackedTile(t).Buildable() || overlapsMining(t))
 					return false;
 			}
 		}
@@ -423,7 +450,7 @@ namespace BWEB
 			}
 			else return;
 		}
-		blocks.push_back(newBlock);
+		addBlock(newBlock);
 		addOverlap(here, width, height);
 	}
 
@@ -453,7 +480,7 @@ namespace BWEB
 					newBlock.insertSmall(here + TilePosition(6, 3));
 					newBlock.insertMedium(here + TilePosition(0, 3));
 					newBlock.insertMedium(here + TilePosition(3, 3));
-					blocks.push_back(newBlock);
+					addBlock(newBlock);
 				}
 				else
 				{
@@ -464,7 +491,7 @@ namespace BWEB
 					newBlock.insertSmall(here + TilePosition(6, 0));
 					newBlock.insertMedium(here + TilePosition(0, 0));
 					newBlock.insertMedium(here + TilePosition(3, 0));
-					blocks.push_back(newBlock);
+					addBlock(newBlock);
 				}
 			}
 			else
@@ -478,7 +505,7 @@ namespace BWEB
 					newBlock.insertSmall(here + TilePosition(0, 3));
 					newBlock.insertMedium(here + TilePosition(2, 3));
 					newBlock.insertMedium(here + TilePosition(5, 3));
-					blocks.push_back(newBlock);
+					addBlock(newBlock);
 				}
 				else
 				{
@@ -489,7 +516,7 @@ namespace BWEB
 					newBlock.insertSmall(here + TilePosition(0, 0));
 					newBlock.insertMedium(here + TilePosition(2, 0));
 					newBlock.insertMedium(here + TilePosition(5, 0));
-					blocks.push_back(newBlock);
+					addBlock(newBlock);
 				}
 			}
 		}
@@ -501,7 +528,7 @@ namespace BWEB
 			newBlock.insertSmall(here + TilePosition(4, 1));
 			newBlock.insertMedium(here + TilePosition(0, 3));
 			newBlock.insertMedium(here + TilePosition(3, 3));
-			blocks.push_back(newBlock);
+			addBlock(newBlock);
 		}
 	}
 
@@ -523,10 +550,16 @@ namespace BWEB
 			newBlock.insertSmall(here + TilePosition(0, 2));
 			newBlock.insertMedium(here + TilePosition(2, 0));
 			newBlock.insertMedium(here + TilePosition(2, 2));
-			blocks.push_back(newBlock);
+			addBlock(newBlock);
 		}
 	}
 
+	void Map::addBlock(const Block& block)
+	{
+		blocks.push_back(block);
+		occupancy.set(Layers::Block, block.Location(), block.width(), block.height());
+	}
+
 	void Map::eraseBlock(const TilePosition here)
 	{
 		for (auto it = blocks.begin(); it != blocks.end(); ++it)
@@ -534,6 +567,7 @@ namespace BWEB
 			auto&  block = *it;
 			if (here.x >= block.Location().x && here.x < block.Location().x + block.width() && here.y >= block.Location().y && here.y < block.Location().y + block.height())
 			{
+				occupancy.reset(Layers::Block, block.Location(), block.width(), block.height());
 				blocks.erase(it);
 				// Remove overlap
 				return;
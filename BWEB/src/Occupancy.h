@@ -0,0 +1,96 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <BWAPI.h>
+
+namespace BWEB
+{
+	// What takes up a tile. A tile can be in several layers at once, and every query takes a combination of layers
+	namespace Layers
+	{
+		enum : unsigned
+		{
+			Used = 1 << 0,		// Buildings on the map
+			Planned = 1 << 1,	// Buildings the bot is about to place
+			Overlap = 1 << 2,	// Tiles BWEB doesn't place its own buildings on: blocks, walls, stations, mining
+			Reserve = 1 << 3,	// Tiles that are kept free of any building, such as the path through a wall
+			Block = 1 << 4,
+			Station = 1 << 5,
+			Wall = 1 << 6
+		};
+
+		const int Count = 7;
+	}
+
+	// Tile occupancy of the whole map, as one bit plane per layer.
+	// A row of a plane is four 64 bit words, so a rectangle costs one masked word operation per row and word it touches.
+	class Occupancy
+	{
+		static const int Size = 256;
+		static const int WordsPerRow = Size / 64;
+
+		uint64_t planes[Layers::Count][Size][WordsPerRow];
+
+		// Calls f(layer, y, word, mask) for every word of the given layers covering the rectangle, clipped to the map, until f returns true
+		template <class F>
+		static bool forEachWord(unsigned layers, BWAPI::TilePosition here, int width, int height, F f)
+		{
+			const auto left = std::max(0, here.x), right = std::min(int(Size), here.x + width);
+			const auto top = std::max(0, here.y), bottom = std::min(int(Size), here.y + height);
+			if (left >= right || top >= bottom)
+				return false;
+
+			for (auto layer = 0; layer < Layers::Count; layer++) {
+				if (!(layers & (1u << layer)))
+					continue;
+
+				for (auto word = left / 64; word <= (right - 1) / 64; word++) {
+					const auto first = std::max(left, word * 64) - word * 64;
+					const auto count = std::min(right, word * 64 + 64) - word * 64 - first;
+					const auto mask = (count == 64 ? ~uint64_t(0) : (uint64_t(1) << count) - 1) << first;
+
+					for (auto y = top; y < bottom; y++) {
+						if (f(layer, y, word, mask))
+							return true;
+					}
+				}
+			}
+			return false;
+		}
+
+	public:
+		Occupancy() { clear(); }
+
+		void clear(unsigned layers = ~0u) {
+			for (auto layer = 0; layer < Layers::Count; layer++) {
+				if (layers & (1u << layer))
+					std::fill(&planes[layer][0][0], &planes[layer][0][0] + Size * WordsPerRow, uint64_t(0));
+			}
+		}
+
+		void set(unsigned layers, BWAPI::TilePosition here, int width = 1, int height = 1) {
+			forEachWord(layers, here, width, height, [&](int layer, int y, int word, uint64_t mask) { planes[layer][y][word] |= mask; return false; });
+		}
+
+		void reset(unsigned layers, BWAPI::TilePosition here, int width = 1, int height = 1) {
+			forEachWord(layers, here, width, height, [&](int layer, int y, int word, uint64_t mask) { planes[layer][y][word] &= ~mask; return false; });
+		}
+
+		/// Returns true if any tile of the rectangle is in any of the given layers
+		bool any(unsigned layers, BWAPI::TilePosition here, int width = 1, int height = 1) const {
+			return forEachWord(layers, here, width, height, [&](int layer, int y, int word, uint64_t mask) { return (planes[layer][y][word] & mask) != 0; });
+		}
+
+		/// Returns true if the tile is in any of the given layers
+		bool test(unsigned layers, BWAPI::TilePosition here) const {
+			if (here.x < 0 || here.y < 0 || here.x >= Size || here.y >= Size)
+				return false;
+
+			for (auto layer = 0; layer < Layers::Count; layer++) {
+				if ((layers & (1u << layer)) && (planes[layer][here.y][here.x / 64] >> (here.x % 64) & 1))
+					return true;
+			}
+			return false;
+		}
+	};
+}
@@ -24,8 +24,8 @@ namespace BWEB
 
 		const auto collision = [](BWEB::Map& bweb, const TilePosition tile, bool ignoreUsedTiles, bool ignoreOverlap, bool ignoreWalls) {
 			return !tile.isValid()
-                || (!ignoreUsedTiles && bweb.usedTilesGrid[tile.x][tile.y])
-				|| (!ignoreOverlap && bweb.overlapGrid[tile.x][tile.y] > 0)
+                || (!ignoreUsedTiles && bweb.occupancy.test(Layers::Used, tile))
+				|| (!ignoreOverlap && bweb.occupancy.test(Layers::Overlap, tile))
 				|| !bweb.isWalkable(tile)
 				|| (!ignoreWalls && bweb.overlapsCurrentWall(tile) != UnitTypes::None);
 		};
@@ -49,6 +49,9 @@ namespace BWEB
 				const Station newStation(genCenter, stationDefenses(base.Location(), h, v), &base);
 				stations.push_back(newStation);
 				addOverlap(base.Location(), 4, 3);
+				occupancy.set(Layers::Station, base.Location(), 4, 3);
+				for (auto& defense : newStation.DefenseLocations())
+					occupancy.set(Layers::Station, defense, 2, 2);
 
 				TilePosition start(genCenter);
 				for (int x = start.x - 4; x < start.x + 4; x++) {
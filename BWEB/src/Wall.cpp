@@ -1,5 +1,6 @@
 #include "Wall.h"
 #include <tuple>
+#include <memory>
 
 namespace BWEB
 {
@@ -51,7 +52,7 @@ namespace BWEB
 
 			for (auto& tile : currentPath) {
 				if (reservePath)
-					reserveGrid[tile.x][tile.y] = 1;
+					occupancy.set(Layers::Reserve, tile);
 
 				if (!newWall.getDoor().isValid()) {
 					TilePosition left = tile + TilePosition(-1, 0);
@@ -82,6 +83,14 @@ namespace BWEB
 
 			// Push wall into the vector
 			walls.push_back(newWall);
+			for (const auto tile : newWall.smallTiles())
+				occupancy.set(Layers::Wall, tile, 2, 2);
+			for (const auto tile : newWall.mediumTiles())
+				occupancy.set(Layers::Wall, tile, 3, 2);
+			for (const auto tile : newWall.largeTiles())
+				occupancy.set(Layers::Wall, tile, 4, 3);
+			for (auto& defense : newWall.getDefenses())
+				occupancy.set(Layers::Wall, defense, 2, 2);
 		}
 	}
 
@@ -120,12 +129,60 @@ namespace BWEB
 		else
 			sort(buildings.begin(), buildings.end());
 
+		vector<vector<UnitType>> permutations;
 		do {
-			currentWall.clear();
-			typeIterator = buildings.begin();
-			checkPiece(start);
+			permutations.push_back(buildings);
 		} while (next_permutation(buildings.begin(), find(buildings.begin(), buildings.end(), UnitTypes::Protoss_Pylon)));
 
+		// Each task is what the sequential search did for one permutation and one tile of the first piece around the choke center
+		const auto side = 2 * chokeWidth;
+		const auto taskCount = int(permutations.size()) * side * side;
+		atomic<int> nextTask(0);
+		vector<unique_ptr<Map>> workers(wallSearchThreads);
+		vector<int> workerBestTask(wallSearchThreads, -1);
+
+		BWEM::utils::parallel_for(wallSearchThreads, wallSearchThreads, [&](int w) {
+			// A single thread searches on this map, more threads each need a copy
+			if (wallSearchThreads > 1)
+				workers[w] = make_unique<Map>(*this);
+			auto& worker = workers[w] ? *workers[w] : *this;
+
+			for (auto task = nextTask++; task < taskCount; task = nextTask++) {
+				const auto previousScore = worker.bestWallScore;
+				const TilePosition t(start.x - chokeWidth + (task % (side * side)) / side, start.y - chokeWidth + task % side);
+
+				worker.buildings = permutations[task / (side * side)];
+				worker.currentWall.clear();
+				worker.typeIterator = worker.buildings.begin();
+				worker.parentSame = false, worker.currentSame = false;
+				if (t.isValid() && worker.testPiece(t) && (worker.isWallTight(*worker.typeIterator, t) || *worker.typeIterator == UnitTypes::Protoss_Pylon))
+					worker.placePiece(t);
+
+				if (worker.bestWallScore > previousScore)
+					workerBestTask[w] = task;
+			}
+		});
+
+		// Keep the best wall, and on equal scores the one the sequential search would have found first
+		auto bestTask = -1;
+		for (auto w = 0; w < int(workers.size()); w++) {
+			if (!workers[w])
+				continue;
+
+			auto& worker = *workers[w];
+			if (workerBestTask[w] >= 0 && (worker.bestWallScore > bestWallScore || (worker.bestWallScore == bestWallScore && workerBestTask[w] < bestTask)))
+				bestWall = worker.bestWall, bestWallScore = worker.bestWallScore, bestTask = workerBestTask[w];
+
+			// Also keep the placements found impossible, for the next walls
+			for (auto& node : worker.visited) {
+				auto& v = visited[node.first];
+				for (auto x = 0; x < 256; x++) {
+					for (auto y = 0; y < 256; y++)
+						v.location[x][y] = max(v.location[x][y], node.second.location[x][y]);
+				}
+			}
+		}
+
 		return !bestWall.empty();
 	}
 
@@ -370,6 +427,7 @@ namespace BWEB
 			currentWall[tileBest] = building;
 			wall.insertDefense(tileBest);
 			addOverlap(tileBest, 2, 2);
+			occupancy.set(Layers::Wall, tileBest, 2, 2);
 		}
 
 		for (auto& defense : wall.getDefenses()) {
@@ -489,7 +547,7 @@ namespace BWEB
 			const auto x = right.x;
 			WalkPosition w(x, y);
 			TilePosition t(w);
-			if (R && (!w.isValid() || !Broodwar->isWalkable(w) /*|| overlapGrid[t.x][t.y] > 0*/))
+			if (R && (!w.isValid() || !Broodwar->isWalkable(w) /*|| occupancy.test(Layers::Overlap, t)*/))
 				return true;
 			if (!requireTight && !isWalkable(t))
 				return true;
@@ -499,7 +557,7 @@ namespace BWEB
 			const auto x = left.x;
 			WalkPosition w(x, y);
 			TilePosition t(w);
-			if (L && (!w.isValid() || !Broodwar->isWalkable(w) /*|| overlapGrid[t.x][t.y] > 0*/))
+			if (L && (!w.isValid() || !Broodwar->isWalkable(w) /*|| occupancy.test(Layers::Overlap, t)*/))
 				return true;
 			if (!requireTight && !isWalkable(t))
 				return true;
@@ -509,7 +567,7 @@ namespace BWEB
 			const auto y = top.y;
 			WalkPosition w(x, y);
 			TilePosition t(w);
-			if (T && (!w.isValid() || !Broodwar->isWalkable(w) /*|| overlapGrid[t.x][t.y] > 0*/))
+			if (T && (!w.isValid() || !Broodwar->isWalkable(w) /*|| occupancy.test(Layers::Overlap, t)*/))
 				return true;
 			if (!requireTight && !isWalkable(t))
 				return true;
@@ -519,7 +577,7 @@ namespace BWEB
 			const auto y = bottom.y;
 			WalkPosition w(x, y);
 			TilePosition t(w);
-			if (B && (!w.isValid() || !Broodwar->isWalkable(w) /*|| overlapGrid[t.x][t.y] > 0*/))
+			if (B && (!w.isValid() || !Broodwar->isWalkable(w) /*|| occupancy.test(Layers::Overlap, t)*/))
 				return true;
 			if (!requireTight && !isWalkable(t))
 				return true;
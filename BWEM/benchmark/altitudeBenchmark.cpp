@@ -0,0 +1,166 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the BWEM Library.
+// BWEM is free software, licensed under the MIT/X11 License.
+// A copy of the license is provided with the library in the LICENSE file.
+// Copyright (c) 2015, 2017, Igor Dimitrijevic
+//
+//////////////////////////////////////////////////////////////////////////
+
+// Compares the altitude algorithms of altitude.h, on walkability dumps or on generated maps.
+// It doesn't need BWAPI:
+//
+//		g++ -std=c++14 -O2 -pthread -I../include altitudeBenchmark.cpp ../src/altitude.cpp ../src/utils.cpp -o altitudeBenchmark
+//		./altitudeBenchmark [dump...]
+//
+// A dump is a text file with one line per row of MiniTiles, and one character per MiniTile:
+// '1' if it is walkable (BWAPI::Game::isWalkable), '0' otherwise.
+// Every unwalkable MiniTile is taken as Sea; deciding between Seas and Lakes barely changes the timings.
+// Without arguments, the benchmark runs on generated maps.
+
+#include "altitude.h"
+#include "utils.h"
+
+#include <cstdio>
+#include <random>
+#include <thread>
+
+using namespace std;
+using namespace BWEM;
+using namespace BWEM::detail;
+using namespace BWEM::utils;
+
+
+struct WalkabilityMap
+{
+	string			name;
+	int				width = 0;
+	int				height = 0;
+	vector<bool>	Walkable;
+};
+
+
+static bool loadDump(const string & fileName, WalkabilityMap & map)
+{
+	ifstream in(fileName);
+	if (!in) return false;
+
+	map.name = fileName;
+	string line;
+	while (getline(in, line))
+	{
+		if (!line.empty() && (line.back() == '\r')) line.pop_back();
+		if (line.empty()) continue;
+		if (map.width && ((int)line.size() != map.width)) return false;
+
+		map.width = line.size();
+		for (char c : line) map.Walkable.push_back(c == '1');
+		++map.height;
+	}
+
+	return map.height > 0;
+}
+
+
+// Open ground with random unwalkable blobs, roughly like cliffs and doodads.
+static WalkabilityMap generateMap(int widthInTiles, int heightInTiles, int blobs, unsigned seed)
+{
+	WalkabilityMap map;
+	map.name = "generated " + to_string(widthInTiles) + "x" + to_string(heightInTiles) + " (" + to_string(blobs) + " blobs)";
+	map.width = widthInTiles * 4;
+	map.height = heightInTiles * 4;
+	map.Walkable.assign(map.width * map.height, true);
+
+	mt19937 random(seed);
+	for (int i = 0 ; i < blobs ; ++i)
+	{
+		const int cx = random() % map.width;
+		const int cy = random() % map.height;
+		const int r = 2 + random() % 24;
+		for (int y = max(0, cy - r) ; y < min(map.height, cy + r) ; ++y)
+		for (int x = max(0, cx - r) ; x < min(map.width, cx + r) ; ++x)
+			if (squaredNorm(x - cx, y - cy) <= r*r)
+				map.Walkable[y * map.width + x] = false;
+	}
+
+	return map;
+}
+
+
+static void benchmark(const WalkabilityMap & map, int threads)
+{
+	const int width = map.width;
+	const int height = map.height;
+
+	// Same inputs as MapImpl::ComputeAltitude : seaside MiniTiles are Sea ones next to some walkable one.
+	vector<bool> SeaSide(width * height, false);
+	vector<bool> Missing(width * height, false);
+	for (int y = 0 ; y < height ; ++y)
+	for (int x = 0 ; x < width ; ++x)
+	{
+		const int i = y * width + x;
+		Missing[i] = map.Walkable[i];
+		if (!map.Walkable[i])
+			for (auto delta : {make_pair(0, -1), make_pair(-1, 0), make_pair(+1, 0), make_pair(0, +1)})
+			{
+				const int nx = x + delta.first;
+				const int ny = y + delta.second;
+				if ((0 <= nx) && (nx < width) && (0 <= ny) && (ny < height) && map.Walkable[ny * width + nx])
+					SeaSide[i] = true;
+			}
+	}
+
+	Timer timer;
+	const vector<altitude_t> Sweep = ComputeAltitudeBySweep(width, height, SeaSide, Missing);
+	const double sweepTime = timer.ElapsedMilliseconds();
+
+	timer.Reset();
+	const vector<altitude_t> Transform = ComputeAltitudeByDistanceTransform(width, height, SeaSide, Missing);
+	const double transformTime = timer.ElapsedMilliseconds();
+
+	timer.Reset();
+	const vector<altitude_t> ParallelTransform = ComputeAltitudeByDistanceTransform(width, height, SeaSide, Missing, threads);
+	const double parallelTransformTime = timer.ElapsedMilliseconds();
+
+	int differences = 0;
+	int maxDifference = 0;
+	for (int i = 0 ; i < width * height ; ++i)
+		if (Sweep[i] != Transform[i])
+		{
+			++differences;
+			maxDifference = max(maxDifference, abs(Sweep[i] - Transform[i]));
+		}
+
+	printf("%-40s %5dx%-5d sweep %9.1f ms   transform %7.1f ms   transform(%d threads) %7.1f ms   x%-7.1f differences %d (max %d px)%s\n",
+		map.name.c_str(), width, height, sweepTime, transformTime, threads, parallelTransformTime,
+		sweepTime / max(transformTime, 0.001), differences, maxDifference,
+		(Transform == ParallelTransform) ? "" : "   PARALLEL MISMATCH");
+}
+
+
+int main(int argc, char * argv[])
+{
+	const int threads = max(1, (int)thread::hardware_concurrency());
+
+	vector<WalkabilityMap> Maps;
+	for (int i = 1 ; i < argc ; ++i)
+	{
+		WalkabilityMap map;
+		if (loadDump(argv[i], map))
+			Maps.push_back(map);
+		else
+			fprintf(stderr, "could not read %s\n", argv[i]);
+	}
+
+	if (argc == 1)
+		for (int size : {64, 96, 128, 192, 256})
+		{
+			Maps.push_back(generateMap(size, size, size * size / 64, size));
+			Maps.push_back(generateMap(size, size, size / 16, size + 1));		// large open map
+		}
+
+	for (const WalkabilityMap & map : Maps)
+		benchmark(map, threads);
+
+	return 0;
+}
@@ -0,0 +1,44 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the BWEM Library.
+// BWEM is free software, licensed under the MIT/X11 License.
+// A copy of the license is provided with the library in the LICENSE file.
+// Copyright (c) 2015, 2017, Igor Dimitrijevic
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+
+#include <vector>
+#include "defs.h"
+
+
+namespace BWEM {
+namespace detail {
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                          //
+//                                  Altitude computation
+//                                                                                          //
+//////////////////////////////////////////////////////////////////////////////////////////////
+//
+// The algorithms behind MapImpl::ComputeAltitude.
+// They don't depend on BWAPI, so that they can be benchmarked on walkability dumps.
+//
+// The MiniTiles are given row by row (width * height of them):
+//	- SeaSide[i] tells whether altitudes are to be computed from MiniTile i.
+//	  The MiniTiles just outside the Map are considered seaside too.
+//	- Missing[i] tells whether the altitude of MiniTile i is to be computed.
+// The altitude of a missing MiniTile is its distance to the nearest seaside MiniTile, in pixels (Cf. MiniTile::Altitude()).
+// Both return the altitudes of the missing MiniTiles, and 0 for the other ones.
+
+// Very rarely, the sweep prunes the seaside MiniTile nearest to some MiniTile and overestimates its altitude.
+std::vector<altitude_t> ComputeAltitudeBySweep(int width, int height, const std::vector<bool> & SeaSide, const std::vector<bool> & Missing);
+
+// Separable distance transform (Felzenszwalb & Huttenlocher) : one pass over the columns then one over the rows.
+// The rows and the columns are spread over the given number of threads.
+std::vector<altitude_t> ComputeAltitudeByDistanceTransform(int width, int height, const std::vector<bool> & SeaSide, const std::vector<bool> & Missing, int threads = 1);
+
+
+}} // namespace BWEM::detail
@@ -140,7 +140,7 @@ public:
 	void							AddTileInformation(const BWAPI::TilePosition t, const Tile & tile);
 	void							OnMineralDestroyed(const Mineral * pMineral);
 	void							PostCollectInformation();
-	std::vector<int>				ComputeDistances(const ChokePoint * pStartCP, const std::vector<const ChokePoint *> & TargetCPs) const;
+	std::vector<int>				ComputeDistances(const ChokePoint * pStartCP, const std::vector<const ChokePoint *> & TargetCPs, bool concurrent = false) const;
 	void							UpdateAccessibleNeighbours();
 	void							SetGroupId(groupId gid)	{ bwem_assert(gid >= 1); m_groupId = gid; }
 	void							CreateBases();
@@ -153,6 +153,7 @@ private:
 	int								ComputeBaseLocationScore(BWAPI::TilePosition location) const;
 	bool							ValidateBaseLocation(BWAPI::TilePosition location, std::vector<Mineral *> & BlockingMinerals) const;
 	std::vector<int>				ComputeDistances(BWAPI::TilePosition start, const std::vector<BWAPI::TilePosition> & Targets) const;
+	std::vector<int>				ComputeDistancesConcurrently(BWAPI::TilePosition start, const std::vector<BWAPI::TilePosition> & Targets) const;
 
 	detail::Graph * const			m_pGraph;
 	id								m_id;
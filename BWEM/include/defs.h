@@ -11,6 +11,7 @@
 #pragma once
 
 #include <cstdint>
+#include <stdexcept>
 #include <string>
 #if BWEM_TRACE
 #include <iostream>
@@ -57,6 +58,13 @@ public:
 
 typedef int16_t altitude_t;		// type of the altitudes, in pixels
 
+// How Map::Initialize computes the altitudes (Cf. Map::SetAltitudeAlgorithm).
+enum class altitude_algorithm_t
+{
+	sweep,				// the original algorithm : sweeps the seaside MiniTiles with all the possible deltas by ascending length
+	distance_transform	// exact Euclidean distance transform, in linear time
+};
+
 
 
 
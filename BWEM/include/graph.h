@@ -108,12 +108,24 @@ public:
 
 	void								ComputeChokePointDistanceMatrix();
 
+	// Incremental alternative to ComputeChokePointDistanceMatrix, used when a blocking Neutral has been destroyed.
+	// Only recomputes the distances that may go through the ChokePoints of ModifiedAreas.
+	void								UpdateChokePointDistanceMatrix(const vector<const Area *> & ModifiedAreas);
+
+	// Alternative to ComputeChokePointDistanceMatrix, used when loading a cached analysis.
+	void								SetChokePointDistanceMatrix(vector<vector<int>> && Distances, vector<vector<CPPath>> && Paths);
+	const vector<vector<int>> &			ChokePointDistanceMatrix() const	{ return m_ChokePointDistanceMatrix; }
+	const vector<vector<CPPath>> &		PathsBetweenChokePoints() const		{ return m_PathsBetweenChokePoints; }
+
 	void								CollectInformation();
 	void								CreateBases();
 
 private:
 	template<class Context>
 	void								ComputeChokePointDistances(const Context * pContext);
+	template<class Context>
+	void								ApplyChokePointDistances(const Context * pContext, const ChokePoint * pStart, const vector<const ChokePoint *> & Targets, const vector<int> & DistanceToTargets);
+	void								ComputeAreaChokePointDistancesInParallel();
 	vector<int>							ComputeDistances(const ChokePoint * pStartCP, const vector<const ChokePoint *> & TargetCPs) const;
 	void								SetDistance(const ChokePoint * cpA, const ChokePoint * cpB, int value);
 	void								UpdateGroupIds();
@@ -62,6 +62,33 @@ public:
 	// A good place to do this is in ExampleAIModule::onStart()
 	virtual void						Initialize(BWAPI::Game *game) = 0;
 
+	// Sets the number of threads Initialize() may use (1 by default).
+	// With more than one thread, the data-parallel steps of the analysis are split between them.
+	// The resulting analysis is identical either way.
+	virtual void						SetInitializationThreads(int threads) = 0;
+
+	// Enables caching of the analysis, keyed by the map hash.
+	// Initialize() then loads a previous analysis from readDirectory (or else from writeDirectory) if there is one,
+	// and otherwise saves the analysis it computes to writeDirectory.
+	virtual void						SetCacheDirectories(const std::string & readDirectory, const std::string & writeDirectory) = 0;
+
+	// Selects how Initialize() computes the altitudes (altitude_algorithm_t::sweep by default).
+	// The distance transform is exact and runs in linear time, which makes a difference on large open maps.
+	// Both give the same altitudes, except for the rare MiniTiles whose altitude the sweep overestimates.
+	virtual void						SetAltitudeAlgorithm(altitude_algorithm_t algorithm) = 0;
+
+	// Selects the compact storage of the Tiles and MiniTiles (off by default), used from the next call to Initialize().
+	// By default Tiles() and MiniTiles() are stored row by row. In compact storage, the map is cut into squares of 8 x 8 Tiles,
+	// stored one after the other, and the Tiles, PackedTiles and MiniTiles of each square are stored in Z-order (Morton order).
+	// Then the 16 MiniTiles of a Tile share one cache line, and positions close to each other are mostly close in memory,
+	// which benefits the spatially local queries (GetArea, GetNearestArea, BreadthFirstSearch...).
+	// The analysis is the same either way.
+	virtual void						SetCompactStorage(bool compact) = 0;
+	bool								CompactStorage() const		{ return m_compactStorage; }
+
+	// Returns the name and duration in milliseconds of each step of the last call to Initialize().
+	virtual const std::vector<std::pair<std::string, double>> &	InitializationTimings() const = 0;
+
 	// Will return true once Initialize() has been called.
 	bool								Initialized() const			{ return m_size != 0; }
 
@@ -108,10 +135,13 @@ public:
 	virtual int							ChokePointCount() const = 0;
 
 	// Returns a Tile, given its position.
-	const Tile &						GetTile(const BWAPI::TilePosition & p, utils::check_t checkMode = utils::check_t::check) const	{ bwem_assert((checkMode == utils::check_t::no_check) || Valid(p)); utils::unused(checkMode); return m_Tiles[Size().x * p.y + p.x]; }
+	const Tile &						GetTile(const BWAPI::TilePosition & p, utils::check_t checkMode = utils::check_t::check) const	{ bwem_assert((checkMode == utils::check_t::no_check) || Valid(p)); utils::unused(checkMode); return m_Tiles[TileIndex(p)]; }
 
 	// Returns a MiniTile, given its position.
-	const MiniTile &					GetMiniTile(const BWAPI::WalkPosition & p, utils::check_t checkMode = utils::check_t::check) const	{ bwem_assert((checkMode == utils::check_t::no_check) || Valid(p)); utils::unused(checkMode); return m_MiniTiles[WalkSize().x * p.y + p.x]; }
+	const MiniTile &					GetMiniTile(const BWAPI::WalkPosition & p, utils::check_t checkMode = utils::check_t::check) const	{ bwem_assert((checkMode == utils::check_t::no_check) || Valid(p)); utils::unused(checkMode); return m_MiniTiles[MiniTileIndex(p)]; }
+
+	// Returns the bit-packed copy of a Tile's most queried information, given its position (Cf. PackedTile).
+	const PackedTile &					GetPackedTile(const BWAPI::TilePosition & p, utils::check_t checkMode = utils::check_t::check) const	{ bwem_assert((checkMode == utils::check_t::no_check) || Valid(p)); utils::unused(checkMode); return m_PackedTiles[TileIndex(p)]; }
 
 	// Returns a Tile or a MiniTile, given its position.
 	// Provided as a support of generic algorithms.
@@ -119,11 +149,23 @@ public:
 	const typename utils::TileOfPosition<TPosition>::type & GetTTile(const TPosition & p, utils::check_t checkMode = utils::check_t::check) const;
 
 	// Provides access to the internal array of Tiles.
+	// In compact storage, the array is in the order given by TileIndex, and includes some padding Tiles (Cf. SetCompactStorage).
 	const std::vector<Tile> &			Tiles() const									{ return m_Tiles; }
 
 	// Provides access to the internal array of MiniTiles.
+	// In compact storage, the array is in the order given by MiniTileIndex, and includes some padding MiniTiles (Cf. SetCompactStorage).
 	const std::vector<MiniTile> &		MiniTiles() const								{ return m_MiniTiles; }
 
+	// Returns the index in Tiles() of the Tile at position p.
+	int									TileIndex(const BWAPI::TilePosition & p) const
+																						{ return m_compactStorage ? (((p.y >> 3) * m_blocksPerRow + (p.x >> 3)) << 6) | utils::mortonCode(p.x & 7, p.y & 7)
+																												  : Size().x * p.y + p.x; }
+
+	// Returns the index in MiniTiles() of the MiniTile at position p.
+	int									MiniTileIndex(const BWAPI::WalkPosition & p) const
+																						{ return m_compactStorage ? (((p.y >> 5) * m_blocksPerRow + (p.x >> 5)) << 10) | utils::mortonCode(p.x & 31, p.y & 31)
+																												  : WalkSize().x * p.y + p.x; }
+
 	// Returns whether the position p is valid.
 	bool								Valid(const BWAPI::TilePosition & p) const		{ return (0 <= p.x) && (p.x < Size().x) && (0 <= p.y) && (p.y < Size().y); }
 	bool								Valid(const BWAPI::WalkPosition & p) const		{ return (0 <= p.x) && (p.x < WalkSize().x) && (0 <= p.y) && (p.y < WalkSize().y); }
@@ -228,8 +270,12 @@ protected:
 
 	BWAPI::Position				m_center;
 	std::vector<Tile>			m_Tiles;
+	std::vector<PackedTile>		m_PackedTiles;
 	std::vector<MiniTile>		m_MiniTiles;
 
+	bool						m_compactStorage = false;
+	int							m_blocksPerRow = 0;		// in compact storage, the number of squares of 8 x 8 Tiles in each row
+
 private:
 	static std::unique_ptr<Map>	m_gInstance;
 
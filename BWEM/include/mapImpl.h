@@ -56,6 +56,14 @@ public:
 
 	void						Initialize(BWAPI::Game *) override;
 
+	void						SetInitializationThreads(int threads) override			{ m_initializationThreads = max(1, threads); }
+	int							InitializationThreads() const							{ return m_initializationThreads; }
+	const vector<pair<string, double>> &	InitializationTimings() const override	{ return m_InitializationTimings; }
+	void						SetCacheDirectories(const string & readDirectory, const string & writeDirectory) override
+																						{ m_cacheReadDirectory = readDirectory; m_cacheWriteDirectory = writeDirectory; }
+	void						SetAltitudeAlgorithm(altitude_algorithm_t algorithm) override	{ m_altitudeAlgorithm = algorithm; }
+	void						SetCompactStorage(bool compact) override				{ m_compactStorage = compact; }
+
 	bool						AutomaticPathUpdate() const override					{ return m_automaticPathUpdate; }
 	void						EnableAutomaticPathAnalysis() const override			{ m_automaticPathUpdate = true; }
 
@@ -126,11 +134,25 @@ private:
 	void						SetAreaIdInTiles();
 	void						SetAreaIdInTile(BWAPI::TilePosition t);
 	void						SetAltitudeInTile(BWAPI::TilePosition t);
+	void						UpdatePackedTile(BWAPI::TilePosition t)				{ m_PackedTiles[TileIndex(t)].Set(GetTile(t, check_t::no_check)); }
+
+	// Analysis cache (Cf. mapCache.cpp)
+	struct CacheHeader;
+	unique_ptr<MappedFile>		OpenCache(BWAPI::Game *) const;
+	void						LoadAltitude(const MappedFile & Cache);
+	void						LoadAreas(const MappedFile & Cache);
+	bool						LoadChokePointDistanceMatrix(const MappedFile & Cache);
+	void						SaveCache(BWAPI::Game *) const;
 
 
 	altitude_t							m_maxAltitude;
 
 	mutable bool						m_automaticPathUpdate = false;
+	int									m_initializationThreads = 1;
+	string								m_cacheReadDirectory;
+	string								m_cacheWriteDirectory;
+	altitude_algorithm_t				m_altitudeAlgorithm = altitude_algorithm_t::sweep;
+	vector<pair<string, double>>		m_InitializationTimings;
 
 	class Graph							m_Graph;
 	vector<unique_ptr<Mineral>>			m_Minerals;
@@ -18,6 +18,8 @@
 #include <limits>
 #include <fstream>
 #include <sstream>
+#include <chrono>
+#include <functional>
 
 #include "defs.h"
 
@@ -53,6 +55,15 @@ inline int scalar_product(int ax, int ay, int bx, int by)
 }
 
 
+// Returns the Z-order (Morton) code of (x, y), that is their bits interleaved (x in the even bits).
+// x and y must be in 0..255.
+inline int mortonCode(int x, int y)
+{
+	auto spread = [](int v) { v = (v | (v << 4)) & 0x0F0F; v = (v | (v << 2)) & 0x3333; return (v | (v << 1)) & 0x5555; };
+	return spread(x) | (spread(y) << 1);
+}
+
+
 // Returns whether the line segments [a, b] and [c, d] intersect.
 bool intersect(int ax, int ay, int bx, int by, int cx, int cy, int dx, int dy);
 
@@ -177,6 +188,60 @@ struct compare2nd
 };
 
 
+// Calls body(i) for each i in [0, count), spreading the calls over the given number of threads (the calling thread included).
+// Each call must only write data that no other call touches.
+void parallel_for(int count, int threads, const std::function<void(int)> & body);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                          //
+//                                  class MappedFile
+//                                                                                          //
+//////////////////////////////////////////////////////////////////////////////////////////////
+//
+//  Read-only memory mapping of a whole file.
+//  Data() is nullptr if the file could not be opened or mapped.
+//
+
+class MappedFile
+{
+public:
+							MappedFile(const std::string & fileName);
+							~MappedFile();
+
+	const char *			Data() const				{ return m_data; }
+	size_t					Size() const				{ return m_size; }
+
+							MappedFile(const MappedFile &) = delete;
+	MappedFile &			operator=(const MappedFile &) = delete;
+
+private:
+	const char *			m_data = nullptr;
+	size_t					m_size = 0;
+	void *					m_handle = nullptr;		// platform specific
+};
+
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                          //
+//                                  class Timer
+//                                                                                          //
+//////////////////////////////////////////////////////////////////////////////////////////////
+//
+
+class Timer
+{
+public:
+							Timer()						{ Reset(); }
+
+	void					Reset()						{ m_start = std::chrono::steady_clock::now(); }
+	double					ElapsedMilliseconds() const	{ return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count(); }
+
+private:
+	std::chrono::steady_clock::time_point	m_start;
+};
+
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 //                                                                                          //
 //                                  class Markable
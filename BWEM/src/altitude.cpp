@@ -0,0 +1,185 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the BWEM Library.
+// BWEM is free software, licensed under the MIT/X11 License.
+// A copy of the license is provided with the library in the LICENSE file.
+// Copyright (c) 2015, 2017, Igor Dimitrijevic
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "altitude.h"
+#include "utils.h"
+
+using namespace std;
+
+
+namespace BWEM {
+
+using namespace utils;
+
+namespace detail {
+
+const int altitude_scale = 8;	// 8 provides a pixel definition for altitude_t, since altitudes are computed from miniTiles which are 8x8 pixels
+
+
+static altitude_t altitudeFromSquaredNorm(int squaredNorm)
+{
+	return altitude_t(0.5 + sqrt(double(squaredNorm)) * altitude_scale);
+}
+
+
+vector<altitude_t> ComputeAltitudeBySweep(int width, int height, const vector<bool> & SeaSide, const vector<bool> & Missing)
+{
+	vector<altitude_t> Altitudes(width * height, 0);
+	for (int i = 0 ; i < width * height ; ++i)
+		if (Missing[i]) Altitudes[i] = -1;
+
+	// 1) Fill in and sort DeltasByAscendingAltitude
+	const int range = max(width, height) / 2 + 3;		// should suffice for maps with no Sea.
+
+	struct Delta { int dx; int dy; altitude_t altitude; };
+	vector<Delta> DeltasByAscendingAltitude;
+
+	for (int dy = 0 ; dy <= range ; ++dy)
+	for (int dx = dy ; dx <= range ; ++dx)			// Only consider 1/8 of possible deltas. Other ones obtained by symmetry.
+		if (dx || dy)
+			DeltasByAscendingAltitude.push_back(Delta{dx, dy, altitudeFromSquaredNorm(squaredNorm(dx, dy))});
+
+	sort(DeltasByAscendingAltitude.begin(), DeltasByAscendingAltitude.end(),
+		[](const Delta & a, const Delta & b){ return a.altitude < b.altitude; });
+
+
+	// 2) Fill in ActiveSeaSideList, which basically contains all the seaside miniTiles (from which altitudes are to be computed)
+	//    It also includes extra border-miniTiles which are considered as seaside miniTiles too.
+	struct ActiveSeaSide { int x; int y; altitude_t lastAltitudeGenerated; };
+	vector<ActiveSeaSide> ActiveSeaSideList;
+
+	for (int y = -1 ; y <= height ; ++y)
+	for (int x = -1 ; x <= width ; ++x)
+	{
+		const bool valid = (0 <= x) && (x < width) && (0 <= y) && (y < height);
+		if (!valid || SeaSide[y * width + x])
+			ActiveSeaSideList.push_back(ActiveSeaSide{x, y, 0});
+	}
+
+	// 3) Dijkstra's algorithm
+	for (const Delta & d : DeltasByAscendingAltitude)
+	{
+		for (int i = 0 ; i < (int)ActiveSeaSideList.size() ; ++i)
+		{
+			ActiveSeaSide & Current = ActiveSeaSideList[i];
+			if (d.altitude - Current.lastAltitudeGenerated >= 2 * altitude_scale)		// optimization : once a seaside miniTile verifies this condition,
+				fast_erase(ActiveSeaSideList, i--);										// we can throw it away as it will not generate min altitudes anymore
+			else
+				for (auto delta : {	make_pair(d.dx, d.dy), make_pair(-d.dx, d.dy), make_pair(d.dx, -d.dy), make_pair(-d.dx, -d.dy),
+									make_pair(d.dy, d.dx), make_pair(-d.dy, d.dx), make_pair(d.dy, -d.dx), make_pair(-d.dy, -d.dx)})
+				{
+					const int x = Current.x + delta.first;
+					const int y = Current.y + delta.second;
+					if ((0 <= x) && (x < width) && (0 <= y) && (y < height))
+					{
+						altitude_t & altitude = Altitudes[y * width + x];
+						if (altitude == -1)
+							altitude = Current.lastAltitudeGenerated = d.altitude;
+					}
+				}
+		}
+	}
+
+	return Altitudes;
+}
+
+
+// Lower envelope of the parabolas y = (x - q)^2 + f[q] (Cf. Felzenszwalb & Huttenlocher, "Distance Transforms of Sampled Functions").
+// Reads f[q * stride] and writes d[q * stride] for q in [0, n). Infinite values of f are skipped.
+// v and z are scratch space of at least n and n + 1 elements.
+static void distanceTransform1D(const int * f, int * d, int n, int stride, int infinity, vector<int> & v, vector<double> & z)
+{
+	auto intersection = [f, stride](int p, int q)
+		{ return ((f[q * stride] + q*q) - (f[p * stride] + p*p)) / (2.0 * (q - p)); };
+
+	int k = -1;
+	for (int q = 0 ; q < n ; ++q)
+	{
+		if (f[q * stride] >= infinity) continue;
+
+		if (k == -1)
+		{
+			k = 0;
+			v[0] = q;
+			z[0] = -numeric_limits<double>::infinity();
+			z[1] = +numeric_limits<double>::infinity();
+			continue;
+		}
+
+		double s = intersection(v[k], q);
+		while (s <= z[k])
+			s = intersection(v[--k], q);		// z[0] is -infinity, so k stays >= 0
+
+		++k;
+		v[k] = q;
+		z[k] = s;
+		z[k+1] = +numeric_limits<double>::infinity();
+	}
+
+	if (k == -1)
+	{
+		for (int q = 0 ; q < n ; ++q)
+			d[q * stride] = infinity;
+		return;
+	}
+
+	k = 0;
+	for (int q = 0 ; q < n ; ++q)
+	{
+		while (z[k+1] < q) ++k;
+		d[q * stride] = (q - v[k]) * (q - v[k]) + f[v[k] * stride];
+	}
+}
+
+
+vector<altitude_t> ComputeAltitudeByDistanceTransform(int width, int height, const vector<bool> & SeaSide, const vector<bool> & Missing, int threads)
+{
+	// Works on the Map plus a border of one MiniTile, which is seaside.
+	const int W = width + 2;
+	const int H = height + 2;
+	const int infinity = numeric_limits<int>::max() / 2;
+
+	vector<int> SquaredDistances(W * H, infinity);
+	for (int y = 0 ; y < H ; ++y)
+	for (int x = 0 ; x < W ; ++x)
+	{
+		const bool border = (x == 0) || (x == W-1) || (y == 0) || (y == H-1);
+		if (border || SeaSide[(y-1) * width + (x-1)])
+			SquaredDistances[y * W + x] = 0;
+	}
+
+	// 1) Columns : squared distance to the nearest seaside MiniTile in the same column
+	vector<int> ColumnDistances(W * H);
+	parallel_for(W, threads, [&](int x)
+	{
+		vector<int> v(H);
+		vector<double> z(H + 1);
+		distanceTransform1D(&SquaredDistances[x], &ColumnDistances[x], H, W, infinity, v, z);
+	});
+
+	// 2) Rows : combines the column distances into the squared Euclidean distance.
+	//    Only the rows of the Map are needed.
+	parallel_for(height, threads, [&](int y)
+	{
+		vector<int> v(W);
+		vector<double> z(W + 1);
+		distanceTransform1D(&ColumnDistances[(y+1) * W], &SquaredDistances[(y+1) * W], W, 1, infinity, v, z);
+	});
+
+	vector<altitude_t> Altitudes(width * height, 0);
+	for (int y = 0 ; y < height ; ++y)
+	for (int x = 0 ; x < width ; ++x)
+		if (Missing[y * width + x])
+			Altitudes[y * width + x] = altitudeFromSquaredNorm(SquaredDistances[(y+1) * W + (x+1)]);
+
+	return Altitudes;
+}
+
+
+}} // namespace BWEM::detail
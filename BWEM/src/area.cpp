@@ -111,7 +111,8 @@ void Area::AddChokePoints(Area * pArea, vector<ChokePoint> * pChokePoints)
 
 
 
-vector<int> Area::ComputeDistances(const ChokePoint * pStartCP, const vector<const ChokePoint *> & TargetCPs) const
+// With concurrent set, the Tiles are left untouched so that several Areas can be processed at the same time.
+vector<int> Area::ComputeDistances(const ChokePoint * pStartCP, const vector<const ChokePoint *> & TargetCPs, bool concurrent) const
 {
 	bwem_assert(!contains(TargetCPs, pStartCP));
 
@@ -125,7 +126,7 @@ vector<int> Area::ComputeDistances(const ChokePoint * pStartCP, const vector<con
 								[this](const Tile & tile, TilePosition) { return tile.AreaId() == Id(); },	// findCond
 								[](const Tile &,          TilePosition) { return true; }));					// visitCond
 
-	return ComputeDistances(start, Targets);
+	return concurrent ? ComputeDistancesConcurrently(start, Targets) : ComputeDistances(start, Targets);
 }
 
 
@@ -209,6 +210,86 @@ vector<int> Area::ComputeDistances(TilePosition start, const vector<TilePosition
 }
 
 
+// Same as ComputeDistances, but the per-Tile search data is kept in local buffers instead of
+// Tile::m_internalData and the Tile marks, which are shared by all the searches.
+// Explores the Tiles in the same order, so the Distances are identical.
+vector<int> Area::ComputeDistancesConcurrently(TilePosition start, const vector<TilePosition> & Targets) const
+{
+	const Map * pMap = GetMap();
+	vector<int> Distances(Targets.size());
+
+	const int width = pMap->Size().x;
+	vector<int> InternalData(pMap->Size().x * pMap->Size().y, 0);
+	vector<bool> Marked(pMap->Size().x * pMap->Size().y, false);
+
+	multimap<int, TilePosition> ToVisit;	// a priority queue holding the tiles to visit ordered by their distance to start.
+	ToVisit.emplace(0, start);
+
+	int remainingTargets = Targets.size();
+	while (!ToVisit.empty())
+	{
+		int currentDist = ToVisit.begin()->first;
+		TilePosition current = ToVisit.begin()->second;
+		bwem_assert(InternalData[current.y * width + current.x] == currentDist);
+		ToVisit.erase(ToVisit.begin());
+		InternalData[current.y * width + current.x] = 0;
+		Marked[current.y * width + current.x] = true;
+
+		for (int i = 0 ; i < (int)Targets.size() ; ++i)
+			if (current == Targets[i])
+			{
+				Distances[i] = int(0.5 + currentDist * 32 / 10000.0);
+				--remainingTargets;
+			}
+		if (!remainingTargets) break;
+
+		for (TilePosition delta : {	TilePosition(-1, -1), TilePosition(0, -1), TilePosition(+1, -1),
+									TilePosition(-1,  0),                      TilePosition(+1,  0),
+									TilePosition(-1, +1), TilePosition(0, +1), TilePosition(+1, +1)})
+		{
+			const bool diagonalMove = (delta.x != 0) && (delta.y != 0);
+			const int newNextDist = currentDist + (diagonalMove ? 14142 : 10000);
+
+			TilePosition next = current + delta;
+			if (pMap->Valid(next))
+			{
+				const int iNextTile = next.y * width + next.x;
+				if (!Marked[iNextTile])
+				{
+					if (InternalData[iNextTile])	// next already in ToVisit
+					{
+						if (newNextDist < InternalData[iNextTile])		// nextNewDist < nextOldDist
+						{	// To update next's distance, we need to remove-insert it from ToVisit:
+							auto range = ToVisit.equal_range(InternalData[iNextTile]);
+							auto iNext = find_if(range.first, range.second, [next]
+								(const pair<int, TilePosition> & e) { return e.second == next; });
+							bwem_assert(iNext != range.second);
+
+							ToVisit.erase(iNext);
+							InternalData[iNextTile] = newNextDist;
+							ToVisit.emplace(newNextDist, next);
+						}
+					}
+					else
+					{
+						const Tile & nextTile = pMap->GetTile(next, check_t::no_check);
+						if ((nextTile.AreaId() == Id()) || (nextTile.AreaId() == -1))
+						{
+							InternalData[iNextTile] = newNextDist;
+							ToVisit.emplace(newNextDist, next);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	bwem_assert(!remainingTargets);
+
+	return Distances;
+}
+
+
 void Area::UpdateAccessibleNeighbours()
 {
 	m_AccessibleNeighbours.clear();
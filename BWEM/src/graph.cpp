@@ -80,7 +80,7 @@ const Area * Graph::GetArea(WalkPosition w) const
 
 const Area * Graph::GetArea(TilePosition t) const
 {
-	Area::id id = GetMap()->GetTile(t).AreaId();
+	Area::id id = GetMap()->GetPackedTile(t).AreaId();
 	return id > 0 ? GetArea(id) : nullptr;
 }
 
@@ -237,6 +237,22 @@ void Graph::SetPath(const ChokePoint * cpA, const ChokePoint * cpB, const CPPath
 }
 
 
+// Returns the ChokePoints of pContext listed before pStart.
+// Only computing the distances from each ChokePoint to the ones before it breaks the symmetry.
+template<class Context>
+static vector<const ChokePoint *> targetsBefore(const Context * pContext, const ChokePoint * pStart)
+{
+	vector<const ChokePoint *> Targets;
+	for (const ChokePoint * cp : pContext->ChokePoints())
+	{
+		if (cp == pStart) break;
+		Targets.push_back(cp);
+	}
+
+	return Targets;
+}
+
+
 // Computes the ground distances between any pair of ChokePoints in pContext
 // This is achieved by invoking several times pContext->ComputeDistances,
 // which effectively computes the distances from one starting ChokePoint, using Dijkstra's algorithm.
@@ -245,53 +261,73 @@ void Graph::SetPath(const ChokePoint * cpA, const ChokePoint * cpB, const CPPath
 template<class Context>
 void Graph::ComputeChokePointDistances(const Context * pContext)
 {
-///	multimap<int, vector<WalkPosition>> trace;
-
 	for (const ChokePoint * pStart : pContext->ChokePoints())
 	{
-		vector<const ChokePoint *> Targets;
-		for (const ChokePoint * cp : pContext->ChokePoints())
-		{
-			if (cp == pStart) break;	// breaks symmetry
-			Targets.push_back(cp);
-		}
+		vector<const ChokePoint *> Targets = targetsBefore(pContext, pStart);
 
 		auto DistanceToTargets = pContext->ComputeDistances(pStart, Targets);
 
-		for (int i = 0 ; i < (int)Targets.size() ; ++i)
-		{
-			int newDist = DistanceToTargets[i];
-			int existingDist = Distance(pStart, Targets[i]);
+		ApplyChokePointDistances(pContext, pStart, Targets, DistanceToTargets);
+	}
+}
 
-			if (newDist && ((existingDist == -1) || (newDist < existingDist)))
-			{
-				SetDistance(pStart, Targets[i], newDist);
+template void Graph::ComputeChokePointDistances<Graph>(const Graph * pContext);
+template void Graph::ComputeChokePointDistances<Area>(const Area * pContext);
 
-				// Build the path from pStart to Targets[i]:
 
-				CPPath Path {pStart, Targets[i]};
+// Records the distances from pStart to Targets computed by pContext->ComputeDistances, when they improve the known ones.
+template<class Context>
+void Graph::ApplyChokePointDistances(const Context * pContext, const ChokePoint * pStart, const vector<const ChokePoint *> & Targets, const vector<int> & DistanceToTargets)
+{
+	for (int i = 0 ; i < (int)Targets.size() ; ++i)
+	{
+		int newDist = DistanceToTargets[i];
+		int existingDist = Distance(pStart, Targets[i]);
 
-				// if (Context == Graph), there may be intermediate ChokePoints. They have been set by ComputeDistances,
-				// so we just have to collect them (in the reverse order) and insert them into Path:
-				if ((void *)(pContext) == (void *)(this))	// tests (Context == Graph) without warning about constant condition
-					for (const ChokePoint * pPrev = Targets[i]->PathBackTrace() ; pPrev != pStart ; pPrev = pPrev->PathBackTrace())
-						Path.insert(Path.begin()+1, pPrev);
+		if (newDist && ((existingDist == -1) || (newDist < existingDist)))
+		{
+			SetDistance(pStart, Targets[i], newDist);
 
-				SetPath(pStart, Targets[i], Path);
+			// Build the path from pStart to Targets[i]:
 
-			///	vector<WalkPosition> PathTrace;
-			///	for (auto e : Path) PathTrace.push_back(e->Center());
-			///	trace.emplace(int(0.5 + DistanceToTargets[i]/8.0), PathTrace);
-			}
+			CPPath Path {pStart, Targets[i]};
+
+			// if (Context == Graph), there may be intermediate ChokePoints. They have been set by ComputeDistances,
+			// so we just have to collect them (in the reverse order) and insert them into Path:
+			if ((void *)(pContext) == (void *)(this))	// tests (Context == Graph) without warning about constant condition
+				for (const ChokePoint * pPrev = Targets[i]->PathBackTrace() ; pPrev != pStart ; pPrev = pPrev->PathBackTrace())
+					Path.insert(Path.begin()+1, pPrev);
+
+			SetPath(pStart, Targets[i], Path);
 		}
 	}
+}
 
-///	for (auto & line : trace) { Log << line.first; for (auto e : line.second) Log << " " << e; Log << endl; }
 
-}
+// Same as calling ComputeChokePointDistances for each Area, but the Dijkstra searches run on several threads.
+// The searches only read the Tiles, and their results are applied afterwards in the serial order,
+// so the distance matrix and the paths are identical.
+void Graph::ComputeAreaChokePointDistancesInParallel()
+{
+	// DistancesByArea[a][s] holds the distances from the s-th ChokePoint of the a-th Area to the ones before it
+	vector<vector<vector<int>>> DistancesByArea(Areas().size());
+	parallel_for(Areas().size(), GetMap()->InitializationThreads(), [this, &DistancesByArea](int a)
+	{
+		const Area & area = Areas()[a];
+		for (const ChokePoint * pStart : area.ChokePoints())
+			DistancesByArea[a].push_back(area.ComputeDistances(pStart, targetsBefore(&area, pStart), true));
+	});
 
-template void Graph::ComputeChokePointDistances<Graph>(const Graph * pContext);
-template void Graph::ComputeChokePointDistances<Area>(const Area * pContext);
+	for (int a = 0 ; a < (int)Areas().size() ; ++a)
+	{
+		const Area & area = Areas()[a];
+		for (int s = 0 ; s < (int)area.ChokePoints().size() ; ++s)
+		{
+			const ChokePoint * pStart = area.ChokePoints()[s];
+			ApplyChokePointDistances(&area, pStart, targetsBefore(&area, pStart), DistancesByArea[a][s]);
+		}
+	}
+}
 
 
 void Graph::ComputeChokePointDistanceMatrix()
@@ -308,8 +344,11 @@ void Graph::ComputeChokePointDistanceMatrix()
 		line.resize(m_ChokePointList.size());
 
 	// 2) Compute distances inside each Area
-	for (const Area & area : Areas())
-		ComputeChokePointDistances(&area);
+	if (GetMap()->InitializationThreads() > 1)
+		ComputeAreaChokePointDistancesInParallel();
+	else
+		for (const Area & area : Areas())
+			ComputeChokePointDistances(&area);
 
 	// 3) Compute distances through connected Areas
 	ComputeChokePointDistances(this);
@@ -329,6 +368,83 @@ void Graph::ComputeChokePointDistanceMatrix()
 }
 
 
+void Graph::SetChokePointDistanceMatrix(vector<vector<int>> && Distances, vector<vector<CPPath>> && Paths)
+{
+	bwem_assert(Distances.size() == m_ChokePointList.size());
+	bwem_assert(Paths.size() == m_ChokePointList.size());
+
+	m_ChokePointDistanceMatrix = move(Distances);
+	m_PathsBetweenChokePoints = move(Paths);
+
+	// Same as steps 4) and 5) of ComputeChokePointDistanceMatrix
+	for (Area & area : Areas())
+		area.UpdateAccessibleNeighbours();
+
+	UpdateGroupIds();
+}
+
+
+// Incremental alternative to ComputeChokePointDistanceMatrix, used when a blocking Neutral has been destroyed.
+// Then some ChokePoints of ModifiedAreas have been unblocked and some Tiles of ModifiedAreas have become walkable,
+// so the distances can only decrease, and any path that improves goes through some ChokePoint of ModifiedAreas (a pivot).
+// Gives the same distances as ComputeChokePointDistanceMatrix.
+void Graph::UpdateChokePointDistanceMatrix(const vector<const Area *> & ModifiedAreas)
+{
+	// 1) Update distances inside each modified Area
+	for (const Area * pArea : ModifiedAreas)
+		ComputeChokePointDistances(pArea);
+
+	// 2) Recompute the rows of the pivots through connected Areas
+	vector<bool> Pivot(m_ChokePointList.size(), false);
+	vector<const ChokePoint *> Pivots;
+	for (const Area * pArea : ModifiedAreas)
+		for (const ChokePoint * cp : pArea->ChokePoints())
+			if (!Pivot[cp->Index()])
+			{
+				Pivot[cp->Index()] = true;
+				Pivots.push_back(cp);
+			}
+
+	for (const ChokePoint * pStart : Pivots)
+	{
+		vector<const ChokePoint *> Targets;
+		for (const ChokePoint * cp : ChokePoints())
+			if (cp != pStart) Targets.push_back(cp);
+
+		ApplyChokePointDistances(this, pStart, Targets, ComputeDistances(pStart, Targets));
+	}
+
+	// 3) Patch the other entries in place: an improved path between two ChokePoints that are not pivots
+	//    consists of the shortest paths to and from the first pivot it goes through.
+	for (const ChokePoint * cpA : ChokePoints()) if (!Pivot[cpA->Index()])
+	for (const ChokePoint * cpB : ChokePoints()) if (!Pivot[cpB->Index()] && (cpB->Index() < cpA->Index()))
+		for (const ChokePoint * pPivot : Pivots)
+		{
+			if (pPivot->Blocked()) continue;		// a path can only go through an unblocked ChokePoint
+
+			const int distA = Distance(cpA, pPivot);
+			const int distB = Distance(pPivot, cpB);
+			if ((distA == -1) || (distB == -1)) continue;
+
+			const int existingDist = Distance(cpA, cpB);
+			if ((existingDist == -1) || (distA + distB < existingDist))
+			{
+				SetDistance(cpA, cpB, distA + distB);
+
+				CPPath Path = GetPath(cpA, pPivot);
+				Path.insert(Path.end(), GetPath(pPivot, cpB).begin() + 1, GetPath(pPivot, cpB).end());
+				SetPath(cpA, cpB, Path);
+			}
+		}
+
+	// Same as steps 4) and 5) of ComputeChokePointDistanceMatrix
+	for (Area & area : Areas())
+		area.UpdateAccessibleNeighbours();
+
+	UpdateGroupIds();
+}
+
+
 // Returns Distances such that Distances[i] == ground_distance(start, Targets[i]) in pixels
 // Any Distances[i] may be 0 (meaning Targets[i] is not reachable).
 // This may occur in the case where start and Targets[i] leave in different continents or due to Bloqued intermediate ChokePoint(s).
@@ -0,0 +1,274 @@
+//////////////////////////////////////////////////////////////////////////
+//
+// This file is part of the BWEM Library.
+// BWEM is free software, licensed under the MIT/X11 License.
+// A copy of the license is provided with the library in the LICENSE file.
+// Copyright (c) 2015, 2017, Igor Dimitrijevic
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "mapImpl.h"
+#include <cstdio>
+#include <cstring>
+
+using namespace BWAPI;
+
+using namespace std;
+
+
+namespace BWEM {
+namespace detail {
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//                                                                                          //
+//                                  Analysis cache
+//                                                                                          //
+//////////////////////////////////////////////////////////////////////////////////////////////
+//
+// The cache holds the results of the expensive steps of Map::Initialize:
+//   - the altitude and the area id of each MiniTile (ComputeAltitude, ProcessBlockingNeutrals and ComputeAreas)
+//   - the Areas and the raw frontier between them (ComputeAreas)
+//   - the ChokePoint distance matrix and the paths between ChokePoints (ComputeChokePointDistanceMatrix)
+// The ChokePoints and the Bases are cheap to create from these, so they are recomputed.
+//
+// The file is the CacheHeader followed by the sections it describes, in order.
+// It is only meant to be read back on the same platform, so everything is stored in native byte order.
+// Bump cache_version whenever the analysis or this layout changes.
+
+const uint32_t cache_version = 2;
+const char cache_magic[8] = {'B', 'W', 'E', 'M', 'C', 'A', 'C', 'H'};
+
+
+struct CachedMiniTile	{ altitude_t altitude; Area::id areaId; };
+struct CachedArea		{ int32_t topX; int32_t topY; int32_t miniTiles; };
+struct CachedFrontier	{ int32_t areaA; int32_t areaB; int32_t x; int32_t y; };
+
+
+struct MapImpl::CacheHeader
+{
+	char				magic[8];
+	uint32_t			version;
+	char				mapHash[64];
+	int32_t				walkWidth;
+	int32_t				walkHeight;
+	int32_t				altitudeAlgorithm;
+	int32_t				maxAltitude;
+	int32_t				areas;
+	int32_t				rawFrontier;
+	int32_t				chokePoints;
+	int32_t				pathEntries;		// total number of ChokePoints in all the paths
+
+	// Offsets of the sections, in bytes from the start of the file
+	size_t				MiniTilesOffset() const		{ return sizeof(CacheHeader); }
+	size_t				AreasOffset() const			{ return MiniTilesOffset() + size_t(walkWidth) * walkHeight * sizeof(CachedMiniTile); }
+	size_t				FrontierOffset() const		{ return AreasOffset() + size_t(areas) * sizeof(CachedArea); }
+	size_t				DistancesOffset() const		{ return FrontierOffset() + size_t(rawFrontier) * sizeof(CachedFrontier); }
+	size_t				PathLengthsOffset() const	{ return DistancesOffset() + size_t(chokePoints) * chokePoints * sizeof(int32_t); }
+	size_t				PathEntriesOffset() const	{ return PathLengthsOffset() + size_t(chokePoints) * chokePoints * sizeof(int32_t); }
+	size_t				TotalSize() const			{ return PathEntriesOffset() + size_t(pathEntries) * sizeof(int32_t); }
+};
+
+
+template<class T>
+static const T * section(const MappedFile & Cache, size_t offset)
+{
+	return reinterpret_cast<const T *>(Cache.Data() + offset);
+}
+
+
+static string cacheFileName(const string & directory, BWAPI::Game * game)
+{
+	return directory + "bwem-" + game->mapHash() + ".cache";
+}
+
+
+// Returns the cache for this map, or nullptr if there is none or it can't be used.
+unique_ptr<MappedFile> MapImpl::OpenCache(BWAPI::Game * game) const
+{
+	for (const string & directory : {m_cacheReadDirectory, m_cacheWriteDirectory})
+	{
+		if (directory.empty()) continue;
+
+		auto pCache = make_unique<MappedFile>(cacheFileName(directory, game));
+		if (!pCache->Data() || (pCache->Size() < sizeof(CacheHeader))) continue;
+
+		const CacheHeader & header = *section<CacheHeader>(*pCache, 0);
+		if (memcmp(header.magic, cache_magic, sizeof(cache_magic)) != 0) continue;
+		if (header.version != cache_version) continue;
+		if (strncmp(header.mapHash, game->mapHash().c_str(), sizeof(header.mapHash)) != 0) continue;
+		if ((header.walkWidth != WalkSize().x) || (header.walkHeight != WalkSize().y)) continue;
+		if (header.altitudeAlgorithm != int32_t(m_altitudeAlgorithm)) continue;
+		if ((header.areas < 0) || (header.rawFrontier < 0) || (header.chokePoints < 0) || (header.pathEntries < 0)) continue;
+		if (pCache->Size() != header.TotalSize()) continue;
+
+		return pCache;
+	}
+
+	return nullptr;
+}
+
+
+// Replaces ComputeAltitude
+void MapImpl::LoadAltitude(const MappedFile & Cache)
+{
+	const CacheHeader & header = *section<CacheHeader>(Cache, 0);
+	const CachedMiniTile * pMiniTiles = section<CachedMiniTile>(Cache, header.MiniTilesOffset());
+
+	// The cache stores the MiniTiles row by row, whatever the storage (Cf. SetCompactStorage)
+	for (int y = 0 ; y < WalkSize().y ; ++y)
+	for (int x = 0 ; x < WalkSize().x ; ++x)
+		GetMiniTile_(WalkPosition(x, y), check_t::no_check).RestoreAltitude(pMiniTiles[y * WalkSize().x + x].altitude);
+
+	m_maxAltitude = altitude_t(header.maxAltitude);
+}
+
+
+// Replaces ComputeAreas
+void MapImpl::LoadAreas(const MappedFile & Cache)
+{
+	const CacheHeader & header = *section<CacheHeader>(Cache, 0);
+
+	const CachedMiniTile * pMiniTiles = section<CachedMiniTile>(Cache, header.MiniTilesOffset());
+	for (int y = 0 ; y < WalkSize().y ; ++y)
+	for (int x = 0 ; x < WalkSize().x ; ++x)
+		GetMiniTile_(WalkPosition(x, y), check_t::no_check).RestoreAreaId(pMiniTiles[y * WalkSize().x + x].areaId);
+
+	const CachedFrontier * pFrontier = section<CachedFrontier>(Cache, header.FrontierOffset());
+	for (int i = 0 ; i < header.rawFrontier ; ++i)
+		m_RawFrontier.emplace_back(make_pair(Area::id(pFrontier[i].areaA), Area::id(pFrontier[i].areaB)), WalkPosition(pFrontier[i].x, pFrontier[i].y));
+
+	vector<pair<WalkPosition, int>> AreasList;
+	const CachedArea * pAreas = section<CachedArea>(Cache, header.AreasOffset());
+	for (int i = 0 ; i < header.areas ; ++i)
+		AreasList.emplace_back(WalkPosition(pAreas[i].topX, pAreas[i].topY), pAreas[i].miniTiles);
+
+	GetGraph().CreateAreas(AreasList);
+
+	SetAreaIdInTiles();
+}
+
+
+// Replaces Graph::ComputeChokePointDistanceMatrix
+// Returns false if the ChokePoints don't match the cached ones, in which case nothing is changed.
+bool MapImpl::LoadChokePointDistanceMatrix(const MappedFile & Cache)
+{
+	const CacheHeader & header = *section<CacheHeader>(Cache, 0);
+	const int count = header.chokePoints;
+	if (count != (int)GetGraph().ChokePoints().size()) return false;
+
+	vector<const ChokePoint *> ChokePointsByIndex(count);
+	for (const ChokePoint * cp : GetGraph().ChokePoints())
+	{
+		if (cp->Index() >= count) return false;
+		ChokePointsByIndex[cp->Index()] = cp;
+	}
+
+	const int32_t * pDistances = section<int32_t>(Cache, header.DistancesOffset());
+	const int32_t * pPathLengths = section<int32_t>(Cache, header.PathLengthsOffset());
+	const int32_t * pPathEntries = section<int32_t>(Cache, header.PathEntriesOffset());
+	const int32_t * pPathEntriesEnd = pPathEntries + header.pathEntries;
+
+	vector<vector<int>> Distances(count, vector<int>(count));
+	vector<vector<CPPath>> Paths(count, vector<CPPath>(count));
+	for (int a = 0 ; a < count ; ++a)
+	for (int b = 0 ; b < count ; ++b)
+	{
+		Distances[a][b] = pDistances[a * count + b];
+
+		const int length = pPathLengths[a * count + b];
+		if ((length < 0) || (length > pPathEntriesEnd - pPathEntries)) return false;
+
+		for (int i = 0 ; i < length ; ++i, ++pPathEntries)
+		{
+			if ((*pPathEntries < 0) || (*pPathEntries >= count)) return false;
+			Paths[a][b].push_back(ChokePointsByIndex[*pPathEntries]);
+		}
+	}
+
+	GetGraph().SetChokePointDistanceMatrix(move(Distances), move(Paths));
+	return true;
+}
+
+
+// Must be called at the end of Initialize, before the Map is changed by any destroyed Neutral.
+void MapImpl::SaveCache(BWAPI::Game * game) const
+{
+	if (m_cacheWriteDirectory.empty()) return;
+
+	const auto & Distances = GetGraph().ChokePointDistanceMatrix();
+	const auto & Paths = GetGraph().PathsBetweenChokePoints();
+
+	CacheHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, cache_magic, sizeof(cache_magic));
+	header.version = cache_version;
+	strncpy(header.mapHash, game->mapHash().c_str(), sizeof(header.mapHash) - 1);
+	header.walkWidth = WalkSize().x;
+	header.walkHeight = WalkSize().y;
+	header.altitudeAlgorithm = int32_t(m_altitudeAlgorithm);
+	header.maxAltitude = MaxAltitude();
+	header.areas = Areas().size();
+	header.rawFrontier = m_RawFrontier.size();
+	header.chokePoints = Distances.size();
+	header.pathEntries = 0;
+	for (const auto & line : Paths)
+		for (const CPPath & path : line)
+			header.pathEntries += path.size();
+
+	ofstream out(cacheFileName(m_cacheWriteDirectory, game), ios::binary | ios::trunc);
+	if (!out) return;
+
+	out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+	for (int y = 0 ; y < WalkSize().y ; ++y)
+	for (int x = 0 ; x < WalkSize().x ; ++x)
+	{
+		const MiniTile & miniTile = GetMiniTile(WalkPosition(x, y), check_t::no_check);
+		CachedMiniTile cached = { miniTile.Altitude(), miniTile.AreaId() };
+		out.write(reinterpret_cast<const char *>(&cached), sizeof(cached));
+	}
+
+	for (const Area & area : Areas())
+	{
+		CachedArea cached = { area.Top().x, area.Top().y, area.MiniTiles() };
+		out.write(reinterpret_cast<const char *>(&cached), sizeof(cached));
+	}
+
+	for (const auto & f : m_RawFrontier)
+	{
+		CachedFrontier cached = { f.first.first, f.first.second, f.second.x, f.second.y };
+		out.write(reinterpret_cast<const char *>(&cached), sizeof(cached));
+	}
+
+	for (const auto & line : Distances)
+		for (int distance : line)
+		{
+			int32_t cached = distance;
+			out.write(reinterpret_cast<const char *>(&cached), sizeof(cached));
+		}
+
+	for (const auto & line : Paths)
+		for (const CPPath & path : line)
+		{
+			int32_t cached = path.size();
+			out.write(reinterpret_cast<const char *>(&cached), sizeof(cached));
+		}
+
+	for (const auto & line : Paths)
+		for (const CPPath & path : line)
+			for (const ChokePoint * cp : path)
+			{
+				int32_t cached = cp->Index();
+				out.write(reinterpret_cast<const char *>(&cached), sizeof(cached));
+			}
+
+	// Don't leave a truncated file behind
+	if (!out)
+	{
+		out.close();
+		std::remove(cacheFileName(m_cacheWriteDirectory, game).c_str());
+	}
+}
+
+
+}} // namespace BWEM::detail
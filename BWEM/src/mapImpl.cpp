@@ -8,6 +8,7 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "mapImpl.h"
+#include "altitude.h"
 #include "neutral.h"
 #include "bwapiExt.h"
 
@@ -57,58 +58,114 @@ MapImpl::~MapImpl()
 
 void MapImpl::Initialize(BWAPI::Game *game)
 {
+	// Keep the settings across the reset
+	const int initializationThreads = m_initializationThreads;
+	const string cacheReadDirectory = m_cacheReadDirectory;
+	const string cacheWriteDirectory = m_cacheWriteDirectory;
+	const altitude_algorithm_t altitudeAlgorithm = m_altitudeAlgorithm;
+	const bool compactStorage = m_compactStorage;
+
 	this->~MapImpl();
     new (this) MapImpl();
 
-///	Timer overallTimer;
-///	Timer timer;
+	m_initializationThreads = initializationThreads;
+	m_cacheReadDirectory = cacheReadDirectory;
+	m_cacheWriteDirectory = cacheWriteDirectory;
+	m_altitudeAlgorithm = altitudeAlgorithm;
+	m_compactStorage = compactStorage;
+
+	Timer overallTimer;
+	Timer timer;
+	auto recordTiming = [this, &timer](const string & step)
+	{
+		m_InitializationTimings.emplace_back(step, timer.ElapsedMilliseconds());
+		timer.Reset();
+	};
 
 	m_Size = TilePosition(game->mapWidth(), game->mapHeight());
 	m_size = Size().x * Size().y;
-	m_Tiles.resize(m_size);
 
 	m_WalkSize = WalkPosition(Size());
 	m_walkSize = WalkSize().x * WalkSize().y;
-	m_MiniTiles.resize(m_walkSize);
+
+	// In compact storage, the arrays are padded to whole squares of 8 x 8 Tiles (Cf. SetCompactStorage)
+	m_blocksPerRow = CompactStorage() ? (Size().x + 7) / 8 : 0;
+	const int storedTiles = CompactStorage() ? m_blocksPerRow * ((Size().y + 7) / 8) * 64 : m_size;
+	m_Tiles.resize(storedTiles);
+	m_PackedTiles.resize(storedTiles);
+	m_MiniTiles.resize(storedTiles * 16);
 
 	m_center = Position(Size())/2;
 
 	for (TilePosition t : game->getStartLocations())
 		m_StartingLocations.push_back(t);
 
-///	bw << "Map::Initialize-resize: " << timer.ElapsedMilliseconds() << " ms" << endl; timer.Reset();
+	recordTiming("Map::Initialize-resize");
 	
 	LoadData(game);
-///	bw << "Map::LoadData: " << timer.ElapsedMilliseconds() << " ms" << endl; timer.Reset();
+	recordTiming("Map::LoadData");
 	
 	DecideSeasOrLakes();
-///	bw << "Map::DecideSeasOrLakes: " << timer.ElapsedMilliseconds() << " ms" << endl; timer.Reset();
+	recordTiming("Map::DecideSeasOrLakes");
 
 	InitializeNeutrals(game);
-///	bw << "Map::InitializeNeutrals: " << timer.ElapsedMilliseconds() << " ms" << endl; timer.Reset();
+	recordTiming("Map::InitializeNeutrals");
+
+	// If we have analyzed this map before, the expensive steps are replaced by loading their results
+	unique_ptr<MappedFile> pCache = OpenCache(game);
+	recordTiming("Map::OpenCache");
 
-	ComputeAltitude();
-///	bw << "Map::ComputeAltitude: " << timer.ElapsedMilliseconds() << " ms" << endl; timer.Reset();
+	if (pCache)
+	{
+		LoadAltitude(*pCache);
+		recordTiming("Map::LoadAltitude");
+	}
+	else
+	{
+		ComputeAltitude();
+		recordTiming("Map::ComputeAltitude");
+	}
 
 	ProcessBlockingNeutrals();
-///	bw << "Map::ProcessBlockingNeutrals: " << timer.ElapsedMilliseconds() << " ms" << endl; timer.Reset();
+	recordTiming("Map::ProcessBlockingNeutrals");
 
-	ComputeAreas();
-///	bw << "Map::ComputeAreas: " << timer.ElapsedMilliseconds() << " ms" << endl; timer.Reset();
+	if (pCache)
+	{
+		LoadAreas(*pCache);
+		recordTiming("Map::LoadAreas");
+	}
+	else
+	{
+		ComputeAreas();
+		recordTiming("Map::ComputeAreas");
+	}
 
 	GetGraph().CreateChokePoints();
-///	bw << "Graph::CreateChokePoints: " << timer.ElapsedMilliseconds() << " ms" << endl; timer.Reset();
+	recordTiming("Graph::CreateChokePoints");
 
-	GetGraph().ComputeChokePointDistanceMatrix();
-///	bw << "Graph::ComputeChokePointDistanceMatrix: " << timer.ElapsedMilliseconds() << " ms" << endl; timer.Reset();
+	if (pCache && LoadChokePointDistanceMatrix(*pCache))
+	{
+		recordTiming("Map::LoadChokePointDistanceMatrix");
+	}
+	else
+	{
+		GetGraph().ComputeChokePointDistanceMatrix();
+		recordTiming("Graph::ComputeChokePointDistanceMatrix");
+	}
 
 	GetGraph().CollectInformation();
-///	bw << "Graph::CollectInformation: " << timer.ElapsedMilliseconds() << " ms" << endl; timer.Reset();
+	recordTiming("Graph::CollectInformation");
 
 	GetGraph().CreateBases();
-///	bw << "Graph::CreateBases: " << timer.ElapsedMilliseconds() << " ms" << endl; timer.Reset();
+	recordTiming("Graph::CreateBases");
 
-///	bw << "Map::Initialize: " << overallTimer.ElapsedMilliseconds() << " ms" << endl;
+	if (!pCache)
+	{
+		SaveCache(game);
+		recordTiming("Map::SaveCache");
+	}
+
+	m_InitializationTimings.emplace_back("Map::Initialize", overallTimer.ElapsedMilliseconds());
 }
 
 
@@ -147,6 +204,8 @@ void MapImpl::LoadData(BWAPI::Game *game)
 		GetTile_(t).SetGroundHeight(bwapiGroundHeight / 2);
 		if (bwapiGroundHeight % 2)
 			GetTile_(t).SetDoodad();
+
+		UpdatePackedTile(t);
 	}
 }
 
@@ -281,61 +340,32 @@ void MapImpl::ReplaceAreaIds(BWAPI::WalkPosition p, Area::id newAreaId)
 
 // Assigns MiniTile::m_altitude foar each miniTile having AltitudeMissing()
 // Cf. MiniTile::Altitude() for meaning of altitude_t.
-// Altitudes are computed using the straightforward Dijkstra's algorithm : the lower ones are computed first, starting from the seaside-miniTiles neighbours.
-// The point here is to precompute all possible altitudes for all possible tiles, and sort them.
+// Altitudes are computed from the seaside-miniTiles, using the algorithm selected by SetAltitudeAlgorithm (Cf. altitude.h).
 void MapImpl::ComputeAltitude()
 {
-	const int altitude_scale = 8;	// 8 provides a pixel definition for altitude_t, since altitudes are computed from miniTiles which are 8x8 pixels
-
-	// 1) Fill in and sort DeltasByAscendingAltitude
-	const int range = max(WalkSize().x, WalkSize().y) / 2 + 3;		// should suffice for maps with no Sea.
-	
-	vector<pair<WalkPosition, altitude_t>> DeltasByAscendingAltitude;
-
-	for (int dy = 0 ; dy <= range ; ++dy)
-	for (int dx = dy ; dx <= range ; ++dx)			// Only consider 1/8 of possible deltas. Other ones obtained by symmetry.
-		if (dx || dy)
-			DeltasByAscendingAltitude.emplace_back(WalkPosition(dx, dy), altitude_t(0.5 + norm(dx, dy) * altitude_scale));
-
-	sort(DeltasByAscendingAltitude.begin(), DeltasByAscendingAltitude.end(),
-		[](const pair<WalkPosition, altitude_t> & a, const pair<WalkPosition, altitude_t> & b){ return a.second < b.second; });
-
-
-	// 2) Fill in ActiveSeaSideList, which basically contains all the seaside miniTiles (from which altitudes are to be computed)
-	//    It also includes extra border-miniTiles which are considered as seaside miniTiles too.
-	struct ActiveSeaSide { WalkPosition origin; altitude_t lastAltitudeGenerated; };
-	vector<ActiveSeaSide> ActiveSeaSideList;
-
-	for (int y = -1 ; y <= WalkSize().y ; ++y)
-	for (int x = -1 ; x <= WalkSize().x ; ++x)
+	vector<bool> SeaSide(m_walkSize);
+	vector<bool> Missing(m_walkSize);
+	for (int y = 0 ; y < WalkSize().y ; ++y)
+	for (int x = 0 ; x < WalkSize().x ; ++x)
 	{
 		WalkPosition w(x, y);
-		if (!Valid(w) || seaSide(w, this))
-			ActiveSeaSideList.push_back(ActiveSeaSide{w, 0});
+		SeaSide[y * WalkSize().x + x] = seaSide(w, this);
+		Missing[y * WalkSize().x + x] = GetMiniTile_(w, check_t::no_check).AltitudeMissing();
 	}
 
-	// 3) Dijkstra's algorithm
-	for (const auto & delta_altitude : DeltasByAscendingAltitude)
+	const vector<altitude_t> Altitudes = (m_altitudeAlgorithm == altitude_algorithm_t::distance_transform)
+		? ComputeAltitudeByDistanceTransform(WalkSize().x, WalkSize().y, SeaSide, Missing, InitializationThreads())
+		: ComputeAltitudeBySweep(WalkSize().x, WalkSize().y, SeaSide, Missing);
+
+	m_maxAltitude = 0;
+	for (int y = 0 ; y < WalkSize().y ; ++y)
+	for (int x = 0 ; x < WalkSize().x ; ++x)
 	{
-		const WalkPosition d = delta_altitude.first;
-		const altitude_t altitude = delta_altitude.second;
-		for (int i = 0 ; i < (int)ActiveSeaSideList.size() ; ++i)
+		const int i = y * WalkSize().x + x;
+		if (Missing[i] && (Altitudes[i] > 0))
 		{
-			ActiveSeaSide & Current = ActiveSeaSideList[i];
-			if (altitude - Current.lastAltitudeGenerated >= 2 * altitude_scale)		// optimization : once a seaside miniTile verifies this condition, 
-				fast_erase(ActiveSeaSideList, i--);									// we can throw it away as it will not generate min altitudes anymore
-			else
-				for (auto delta : {	WalkPosition(d.x, d.y), WalkPosition(-d.x, d.y), WalkPosition(d.x, -d.y), WalkPosition(-d.x, -d.y),
-									WalkPosition(d.y, d.x), WalkPosition(-d.y, d.x), WalkPosition(d.y, -d.x), WalkPosition(-d.y, -d.x)})
-				{
-					WalkPosition w = Current.origin + delta;
-					if (Valid(w))
-					{
-						auto & miniTile = GetMiniTile_(w, check_t::no_check);
-						if (miniTile.AltitudeMissing())
-							miniTile.SetAltitude(m_maxAltitude = Current.lastAltitudeGenerated = altitude);
-					}
-				}
+			GetMiniTile_(WalkPosition(x, y), check_t::no_check).SetAltitude(Altitudes[i]);
+			m_maxAltitude = max(m_maxAltitude, Altitudes[i]);
 		}
 	}
 }
@@ -657,15 +687,19 @@ void MapImpl::SetAltitudeInTile(TilePosition t)
 }
 
 
+// Each Tile only depends on its own MiniTiles, so the rows can be processed in parallel.
 void MapImpl::SetAreaIdInTiles()
 {
-	for (int y = 0 ; y < Size().y ; ++y)
-	for (int x = 0 ; x < Size().x ; ++x)
+	parallel_for(Size().y, InitializationThreads(), [this](int y)
 	{
-		TilePosition t(x, y);
-		SetAreaIdInTile(t);
-		SetAltitudeInTile(t);
-	}
+		for (int x = 0 ; x < Size().x ; ++x)
+		{
+			TilePosition t(x, y);
+			SetAreaIdInTile(t);
+			SetAltitudeInTile(t);
+			UpdatePackedTile(t);
+		}
+	});
 }
 
 
@@ -733,10 +767,11 @@ void MapImpl::OnBlockingNeutralDestroyed(const Neutral * pBlocking)
 	{
 		GetTile_(pBlocking->TopLeft() + TilePosition(dx, dy)).ResetAreaId();
 		SetAreaIdInTile(pBlocking->TopLeft() + TilePosition(dx, dy));
+		UpdatePackedTile(pBlocking->TopLeft() + TilePosition(dx, dy));
 	}
 
 	if (AutomaticPathUpdate())
-		GetGraph().ComputeChokePointDistanceMatrix();
+		GetGraph().UpdateChokePointDistanceMatrix(pBlocking->BlockedAreas());
 }
 
 
@@ -8,6 +8,23 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "utils.h"
+#include <atomic>
+#include <thread>
+
+#ifdef _WIN32
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
 
 using namespace std;
 
@@ -53,5 +70,97 @@ bool intersect(int ax, int ay, int bx, int by, int cx, int cy, int dx, int dy)
 }
 
 
+void parallel_for(int count, int threads, const function<void(int)> & body)
+{
+	threads = max(1, min(threads, count));
+	if (threads == 1)
+	{
+		for (int i = 0 ; i < count ; ++i)
+			body(i);
+		return;
+	}
+
+	// The items may take very different times, so each thread picks up the next one when it is done
+	atomic<int> next(0);
+	auto worker = [&next, count, &body]()
+	{
+		for (int i = next++ ; i < count ; i = next++)
+			body(i);
+	};
+
+	vector<thread> Workers;
+	for (int t = 1 ; t < threads ; ++t)
+		Workers.emplace_back(worker);
+
+	worker();
+
+	for (thread & w : Workers)
+		w.join();
+}
+
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const string & fileName)
+{
+	HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return;
+
+	LARGE_INTEGER size;
+	if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+	{
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping)
+		{
+			m_data = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+			if (m_data)
+			{
+				m_size = size_t(size.QuadPart);
+				m_handle = mapping;
+			}
+			else CloseHandle(mapping);
+		}
+	}
+
+	CloseHandle(file);		// the mapping keeps the file open
+}
+
+
+MappedFile::~MappedFile()
+{
+	if (m_data) UnmapViewOfFile(m_data);
+	if (m_handle) CloseHandle(m_handle);
+}
+
+#else
+
+MappedFile::MappedFile(const string & fileName)
+{
+	int file = open(fileName.c_str(), O_RDONLY);
+	if (file < 0) return;
+
+	struct stat info;
+	if ((fstat(file, &info) == 0) && (info.st_size > 0))
+	{
+		void * data = mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+		if (data != MAP_FAILED)
+		{
+			m_data = static_cast<const char *>(data);
+			m_size = size_t(info.st_size);
+		}
+	}
+
+	close(file);		// the mapping keeps the file open
+}
+
+
+MappedFile::~MappedFile()
+{
+	if (m_data) munmap(const_cast<char *>(m_data), m_size);
+}
+
+#endif
+
+
 }} // namespace BWEM::utils
 
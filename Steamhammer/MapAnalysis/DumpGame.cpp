@@ -0,0 +1,235 @@
+#include "DumpGame.h"
+#include "MapDump.h"
+
+#include <cstring>
+#include <fstream>
+
+using namespace UAlbertaBot;
+
+namespace
+{
+    const int SelfId = 0;
+    const int NeutralId = 1;
+
+    template <size_t N>
+    void copyString(char (&destination)[N], const std::string & source)
+    {
+        std::strncpy(destination, source.c_str(), N - 1);
+        destination[N - 1] = '\0';
+    }
+
+    // Reads height lines of width characters and passes each character to set(x, y, c)
+    template <class Setter>
+    bool readGrid(std::istream & in, int width, int height, Setter set)
+    {
+        std::string line;
+        for (int y = 0; y < height; y++)
+        {
+            if (!(in >> line) || (int)line.size() != width) return false;
+            for (int x = 0; x < width; x++)
+            {
+                set(x, y, line[x]);
+            }
+        }
+        return true;
+    }
+}
+
+DumpGame::DumpGame()
+    : _data(new BWAPI::GameData)
+{
+}
+
+DumpGame::~DumpGame()
+{
+    if (BWAPI::BroodwarPtr == _game.get())
+    {
+        BWAPI::BroodwarPtr = nullptr;
+    }
+}
+
+bool DumpGame::parse(std::istream & in)
+{
+    BWAPI::GameData & data = *_data;
+
+    std::string record;
+    int version = 0;
+    if (!(in >> record >> version) || record != "MapDump")
+    {
+        _error = "not a map dump";
+        return false;
+    }
+    if (version != MapDump::Version)
+    {
+        _error = "unsupported map dump version " + std::to_string(version);
+        return false;
+    }
+
+    auto sizeKnown = [&]()
+    {
+        if (data.mapWidth > 0 && data.mapHeight > 0) return true;
+        _error = record + " before size";
+        return false;
+    };
+
+    while (in >> record)
+    {
+        if (record == "name")
+        {
+            std::string name;
+            std::getline(in >> std::ws, name);
+            copyString(data.mapFileName, name);
+            copyString(data.mapPathName, name);
+            copyString(data.mapName, name);
+        }
+        else if (record == "hash")
+        {
+            std::string hash;
+            in >> hash;
+            copyString(data.mapHash, hash);
+        }
+        else if (record == "size")
+        {
+            in >> data.mapWidth >> data.mapHeight;
+            if (data.mapWidth < 1 || data.mapWidth > 256 || data.mapHeight < 1 || data.mapHeight > 256)
+            {
+                _error = "bad map size";
+                return false;
+            }
+        }
+        else if (record == "self")
+        {
+            BWAPI::PlayerData & self = data.players[SelfId];
+            in >> self.startLocationX >> self.startLocationY >> self.race;
+        }
+        else if (record == "start")
+        {
+            if (data.startLocationCount >= 8)
+            {
+                _error = "too many start locations";
+                return false;
+            }
+            in >> data.startLocations[data.startLocationCount].x >> data.startLocations[data.startLocationCount].y;
+            ++data.startLocationCount;
+        }
+        else if (record == "height")
+        {
+            if (!sizeKnown()) return false;
+            if (!readGrid(in, data.mapWidth, data.mapHeight, [&](int x, int y, char c) { data.getGroundHeight[x][y] = c - '0'; }))
+            {
+                _error = "bad ground height grid";
+                return false;
+            }
+        }
+        else if (record == "buildable")
+        {
+            if (!sizeKnown()) return false;
+            if (!readGrid(in, data.mapWidth, data.mapHeight, [&](int x, int y, char c) { data.isBuildable[x][y] = c == '1'; }))
+            {
+                _error = "bad buildability grid";
+                return false;
+            }
+        }
+        else if (record == "walkable")
+        {
+            if (!sizeKnown()) return false;
+            if (!readGrid(in, data.mapWidth * 4, data.mapHeight * 4, [&](int x, int y, char c) { data.isWalkable[x][y] = c == '1'; }))
+            {
+                _error = "bad walkability grid";
+                return false;
+            }
+        }
+        else if (record == "neutral")
+        {
+            if (data.initialUnitCount >= (int)(sizeof(data.units) / sizeof(data.units[0])))
+            {
+                _error = "too many neutral units";
+                return false;
+            }
+
+            BWAPI::UnitData & unit = data.units[data.initialUnitCount];
+            in >> unit.type >> unit.positionX >> unit.positionY >> unit.resources;
+            unit.id = data.initialUnitCount;
+            unit.player = NeutralId;
+            unit.hitPoints = BWAPI::UnitType(unit.type).maxHitPoints();
+            unit.exists = true;
+            unit.isCompleted = true;
+            for (bool & visible : unit.isVisible) visible = true;
+            ++data.initialUnitCount;
+        }
+        else if (record == "end")
+        {
+            return sizeKnown();
+        }
+        else
+        {
+            _error = "unknown record " + record;
+            return false;
+        }
+
+        if (!in)
+        {
+            _error = "bad " + record + " record";
+            return false;
+        }
+    }
+
+    _error = "truncated map dump";
+    return false;
+}
+
+bool DumpGame::load(const std::string & fileName)
+{
+    std::ifstream in(fileName);
+    if (!in)
+    {
+        _error = "can't open " + fileName;
+        return false;
+    }
+
+    // The shared memory block is plain data, and a live game starts out with it zeroed too
+    std::memset(_data.get(), 0, sizeof(BWAPI::GameData));
+    if (!parse(in)) return false;
+
+    BWAPI::GameData & data = *_data;
+
+    // We have seen the whole map
+    for (int x = 0; x < data.mapWidth; x++)
+    {
+        for (int y = 0; y < data.mapHeight; y++)
+        {
+            data.isExplored[x][y] = true;
+            data.isVisible[x][y] = true;
+        }
+    }
+
+    // Our player and the neutral player, which owns the static neutral units
+    data.playerCount = 2;
+    data.self = SelfId;
+    data.enemy = -1;
+    data.neutral = NeutralId;
+
+    BWAPI::PlayerData & self = data.players[SelfId];
+    copyString(self.name, "Locutus");
+    self.type = BWAPI::PlayerTypes::Player.getID();
+    self.isParticipating = true;
+
+    BWAPI::PlayerData & neutral = data.players[NeutralId];
+    copyString(neutral.name, "Neutral");
+    neutral.type = BWAPI::PlayerTypes::Neutral.getID();
+    neutral.race = BWAPI::Races::None.getID();
+    neutral.isNeutral = true;
+    neutral.startLocationX = BWAPI::TilePositions::None.x;
+    neutral.startLocationY = BWAPI::TilePositions::None.y;
+
+    data.isInGame = true;
+    data.frameCount = 0;
+
+    // The client library's objects read from BWAPIClient.data, and the game sets up its unit and player sets at match start
+    BWAPI::BWAPIClient.data = _data.get();
+    _game.reset(new BWAPI::GameImpl(_data.get()));
+    BWAPI::BroodwarPtr = _game.get();
+    _game->onMatchStart();
+
+    return true;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <BWAPI.h>
+#include <BWAPI/Client.h>
+
+namespace UAlbertaBot
+{
+
+// A stand-in for a running game, built from a map dump (see Source/MapDump.h).
+// It fills in the shared memory block that the BWAPI client library reads from a live game,
+// and lets the client library's Game implementation serve it as BWAPI::Broodwar.
+// So the map analysis code sees an ordinary game at frame 0, with our player, the neutral player,
+// the start locations and the static neutral units.
+class DumpGame
+{
+    std::unique_ptr<BWAPI::GameData>    _data;
+    std::unique_ptr<BWAPI::GameImpl>    _game;
+    std::string                         _error;
+
+    bool parse(std::istream & in);
+
+public:
+
+    DumpGame();
+    ~DumpGame();
+
+    // Reads the dump and makes it the current game. Returns false and sets error() if the dump can't be read.
+    bool load(const std::string & fileName);
+
+    const std::string & error() const { return _error; };
+};
+
+}
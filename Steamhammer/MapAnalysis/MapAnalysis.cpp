@@ -0,0 +1,213 @@
+// Offline map analysis: runs the startup map analysis on map dumps and reports how long each phase takes
+// and how much memory it uses. Map dumps are written by the bot when Tools/DumpMap is set in the config file.
+//
+// Usage: MapAnalysis [--threads N] <dump file or directory>...
+//
+// Each map is analyzed in a child process, so that it starts from a fresh state and gets its own memory figures.
+// The output is CSV: map, phase, milliseconds, resident memory after the phase in MB, peak resident memory in MB.
+//
+// Covered: BWEM (each step of Map::Initialize, and the starting location bases), BWEB (stations and blocks),
+// our clearance map, MapTools and Bases. BWTA is not run, so MapTools sees no BWTA base locations
+// (see MapAnalysisStubs.cpp).
+//
+// Build it with CMakeLists.txt in this directory.
+
+#include "DumpGame.h"
+#include "Bases.h"
+#include "ClearanceMap.h"
+#include "MapTools.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <thread>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+    #include <psapi.h>
+#endif
+
+using namespace UAlbertaBot;
+
+namespace
+{
+    struct MemoryUsage
+    {
+        double residentMB;
+        double peakMB;
+    };
+
+    MemoryUsage memoryUsage()
+    {
+        MemoryUsage usage = { 0.0, 0.0 };
+
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters;
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        {
+            usage.residentMB = counters.WorkingSetSize / (1024.0 * 1024.0);
+            usage.peakMB = counters.PeakWorkingSetSize / (1024.0 * 1024.0);
+        }
+#else
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line))
+        {
+            // Both are given in kB
+            if (line.compare(0, 6, "VmRSS:") == 0) usage.residentMB = std::atof(line.c_str() + 6) / 1024.0;
+            if (line.compare(0, 6, "VmHWM:") == 0) usage.peakMB = std::atof(line.c_str() + 6) / 1024.0;
+        }
+#endif
+
+        return usage;
+    }
+
+    class PhaseReporter
+    {
+        std::string                                     _map;
+        std::chrono::steady_clock::time_point           _start;
+
+    public:
+
+        PhaseReporter(const std::string & map) : _map(map) { reset(); };
+
+        void reset() { _start = std::chrono::steady_clock::now(); };
+
+        void report(const std::string & phase, double milliseconds) const
+        {
+            MemoryUsage usage = memoryUsage();
+            std::printf("%s,%s,%.2f,%.1f,%.1f\n", _map.c_str(), phase.c_str(), milliseconds, usage.residentMB, usage.peakMB);
+            std::fflush(stdout);
+        }
+
+        // Reports the time since the last reset, and resets
+        void report(const std::string & phase)
+        {
+            report(phase, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _start).count());
+            reset();
+        }
+    };
+
+    int analyze(const std::string & fileName, int threads)
+    {
+        std::string map = std::filesystem::path(fileName).filename().string();
+        PhaseReporter reporter(map);
+
+        DumpGame game;
+        if (!game.load(fileName))
+        {
+            std::fprintf(stderr, "%s: %s\n", fileName.c_str(), game.error().c_str());
+            return 1;
+        }
+        reporter.report("LoadDump");
+
+        // Same settings as the bot, except for the cache, which would skip the work we want to measure
+        auto & bwemMap = BWEM::Map::Instance();
+        bwemMap.SetInitializationThreads(threads);
+        bwemMap.SetAltitudeAlgorithm(BWEM::altitude_algorithm_t::distance_transform);
+        bwemMap.SetCompactStorage(true);
+        bwemMap.Initialize(BWAPI::BroodwarPtr);
+        for (const auto & timing : bwemMap.InitializationTimings())
+        {
+            reporter.report("BWEM " + timing.first, timing.second);
+        }
+        reporter.reset();
+
+        bwemMap.EnableAutomaticPathAnalysis();
+        if (!bwemMap.FindBasesForStartingLocations())
+        {
+            std::fprintf(stderr, "%s: BWEM map analysis failed\n", fileName.c_str());
+            return 1;
+        }
+        reporter.report("BWEM FindBasesForStartingLocations");
+
+        auto & bwebMap = BWEB::Map::Instance();
+        bwebMap.onStart();
+        reporter.report("BWEB onStart");
+
+        bwebMap.findBlocks();
+        reporter.report("BWEB findBlocks");
+
+        ClearanceMap::Instance().initialize();
+        reporter.report("ClearanceMap");
+
+        // Bases would create it on first use, so create it first to time them apart
+        MapTools::Instance();
+        reporter.report("MapTools");
+
+        Bases::Instance().initialize();
+        reporter.report("Bases");
+
+        return 0;
+    }
+
+    std::string quoted(const std::string & s)
+    {
+        return "\"" + s + "\"";
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    int threads = std::max(1, (int)std::thread::hardware_concurrency());
+    std::vector<std::string> dumps;
+    std::string single;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc)
+        {
+            threads = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--single" && i + 1 < argc)
+        {
+            single = argv[++i];
+        }
+        else if (std::filesystem::is_directory(arg))
+        {
+            for (const auto & entry : std::filesystem::directory_iterator(arg))
+            {
+                if (entry.path().extension() == ".dump") dumps.push_back(entry.path().string());
+            }
+        }
+        else
+        {
+            dumps.push_back(arg);
+        }
+    }
+
+    // Child process: analyze one map
+    if (!single.empty())
+    {
+        return analyze(single, threads);
+    }
+
+    if (dumps.empty())
+    {
+        std::fprintf(stderr, "Usage: %s [--threads N] <dump file or directory>...\n", argv[0]);
+        return 2;
+    }
+
+    std::sort(dumps.begin(), dumps.end());
+
+    std::printf("map,phase,ms,residentMB,peakMB\n");
+    std::fflush(stdout);
+
+    int failures = 0;
+    for (const std::string & dump : dumps)
+    {
+        std::string command = quoted(argv[0]) + " --threads " + std::to_string(threads) + " --single " + quoted(dump);
+#ifdef _WIN32
+        // cmd.exe strips the outer quotes of a command line that starts with one
+        command = quoted(command);
+#endif
+        if (std::system(command.c_str()) != 0) failures++;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,90 @@
+// Stand-ins for the parts of the bot and of BWTA that MapTools.cpp links against, but that the map analysis never reaches.
+// MapTools also uses them to choose expansions, once the game is running.
+//
+// BWTA is only available on Windows, and its own analysis is not what we measure, so here the map has no BWTA
+// base locations: MapTools finds no island bases, and the rest of its setup runs as it does in the bot.
+
+#include "BuildingPlacer.h"
+#include "InformationManager.h"
+#include "PathFinding.h"
+#include "PathService.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+using namespace UAlbertaBot;
+
+namespace
+{
+    [[noreturn]] void notAnalyzed(const char * what)
+    {
+        std::fprintf(stderr, "%s is not part of the map analysis\n", what);
+        std::abort();
+    }
+}
+
+const std::set<BWTA::BaseLocation *> & BWTA::getBaseLocations()
+{
+    static const std::set<BWTA::BaseLocation *> none;
+    return none;
+}
+
+BuildingPlacer & BuildingPlacer::Instance()
+{
+    notAnalyzed("BuildingPlacer");
+}
+
+bool BuildingPlacer::isReserved(int x, int y) const
+{
+    notAnalyzed("BuildingPlacer");
+}
+
+InformationManager & InformationManager::Instance()
+{
+    notAnalyzed("InformationManager");
+}
+
+std::vector<BWTA::BaseLocation *> InformationManager::getBases(BWAPI::Player player)
+{
+    notAnalyzed("InformationManager");
+}
+
+BWAPI::Player InformationManager::getBaseOwner(BWTA::BaseLocation * base)
+{
+    notAnalyzed("InformationManager");
+}
+
+bool InformationManager::isEnemyBuildingInRegion(BWTA::Region * region, bool ignoreRefineries)
+{
+    notAnalyzed("InformationManager");
+}
+
+PathService & PathService::Instance()
+{
+    notAnalyzed("PathService");
+}
+
+PathHandle PathService::submit(
+    RequestType type,
+    BWAPI::Position start,
+    BWAPI::Position end,
+    BWAPI::UnitType unitType,
+    PathFinding::PathFindingOptions options,
+    Callback callback)
+{
+    notAnalyzed("PathService");
+}
+
+bool PathHandle::isReady() const
+{
+    notAnalyzed("PathService");
+}
+
+int PathFinding::GetGroundDistance(
+    BWAPI::Position start,
+    BWAPI::Position end,
+    BWAPI::UnitType unitType,
+    PathFindingOptions options)
+{
+    notAnalyzed("PathFinding");
+}
@@ -15,11 +15,35 @@ BOSSManager::BOSSManager()
     , _previousSearchFinishFrame(0)
     , _searchInProgress(false)
     , _previousStatus("No Searches")
+    , _searchFinished(false)
+    , _cancelSearch(false)
+    , _searchTimedOut(false)
+    , _searchThrew(false)
+    , _searchTime(0)
 {
 }
 
+BOSSManager::~BOSSManager()
+{
+    stop();
+}
+
+// cancels the search in progress, if any, and waits for its thread
+void BOSSManager::stop()
+{
+    _cancelSearch = true;
+
+    if (_searchThread.joinable())
+    {
+        _searchThread.join();
+    }
+
+    _searchInProgress = false;
+}
+
 void BOSSManager::reset()
 {
+    stop();
     _previousSearchResults = BOSS::DFBB_BuildOrderSearchResults();
     _searchInProgress = false;
     _previousBuildOrder.clear();
@@ -28,6 +52,9 @@ void BOSSManager::reset()
 // start a new search for a new goal
 void BOSSManager::startNewSearch(const std::vector<MetaPair> & goalUnits)
 {
+    // only one search runs at a time
+    stop();
+
     size_t numWorkers   = UnitUtil::GetAllUnitCount(BWAPI::Broodwar->self()->getRace().getWorker());
     size_t numDepots    = UnitUtil::GetAllUnitCount(BWAPI::Broodwar->self()->getRace().getCenter())
                         + UnitUtil::GetAllUnitCount(BWAPI::UnitTypes::Zerg_Lair)
@@ -51,16 +78,48 @@ void BOSSManager::startNewSearch(const std::vector<MetaPair> & goalUnits)
     {
         BOSS::BuildOrderSearchGoal goal = GetGoal(goalUnits);
 
-        BOSS::GameState initialState(BWAPI::Broodwar, BWAPI::Broodwar->self(), BuildingManager::Instance().buildingTypesQueued());
+        const BOSS::GameState initialState = getCurrentState();
+
+        _previousGoalUnits = goalUnits;
+        _searchState = initialState;
+        _searchGoal = goal;
+
+        // a goal close to the last one gets the last build order repaired for it, without a search
+        const bool repaired = repairLastPlan(initialState, goal);
+        if (repaired && getGoalDelta(goal) <= Config::Macro::BOSSRepairGoalDelta)
+        {
+            _previousBuildOrder = _repairedBuildOrder;
+            _previousStatus = std::string("\x07") + "BOSS Repaired Plan\n";
+            _totalPreviousSearchTime = 0;
+            _savedSearchResults = BOSS::DFBB_BuildOrderSearchResults();
+            setLastPlan();
+            return;
+        }
 
         _smartSearch = SearchPtr(new BOSS::DFBB_BuildOrderSmartSearch(initialState.getRace()));
-        _smartSearch->setGoal(GetGoal(goalUnits));
+        _smartSearch->setGoal(goal);
         _smartSearch->setState(initialState);
+        _smartSearch->setNumThreads(std::max(1, Config::Macro::BOSSSearchThreads));
+
+        // otherwise the search only has to look for build orders at least as good as the repaired one
+        if (repaired)
+        {
+            _smartSearch->setInitialUpperBound(_repairedBuildOrder.getCompletionTime(initialState));
+        }
 
         _searchInProgress = true;
         _previousSearchStartFrame = BWAPI::Broodwar->getFrameCount();
         _totalPreviousSearchTime = 0;
-        _previousGoalUnits = goalUnits;
+        _previousStatus = std::string("\x04") + "BOSS Searching\n";
+
+        _searchFinished = false;
+        _cancelSearch = false;
+        _searchTimedOut = false;
+        _searchThrew = false;
+        _searchTime = 0;
+
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(Config::Macro::BOSSTimeLimit);
+        _searchThread = std::thread(&BOSSManager::runSearch, this, deadline);
     }
     catch (const BOSS::BOSSException &)
     {
@@ -101,6 +160,8 @@ void BOSSManager::drawSearchInformation(int x, int y)
     BWAPI::Broodwar->drawTextScreen(BWAPI::Position(x, y+25), "Time (ms): %.3lf", _totalPreviousSearchTime);
     BWAPI::Broodwar->drawTextScreen(BWAPI::Position(x, y+35), "Nodes: %d", _savedSearchResults.nodesExpanded);
     BWAPI::Broodwar->drawTextScreen(BWAPI::Position(x, y+45), "BO Size: %d", (int)_savedSearchResults.buildOrder.size());
+    BWAPI::Broodwar->drawTextScreen(BWAPI::Position(x, y+55), "TT hits: %.1lf%% cutoffs: %.1lf%%", 100 * _savedSearchResults.ttHitRate(), 100 * _savedSearchResults.ttCutoffRate());
+    BWAPI::Broodwar->drawTextScreen(BWAPI::Position(x, y+65), "Bounds: %d - %d", _savedSearchResults.lowerBound, _savedSearchResults.upperBound);
 }
 
 void BOSSManager::drawStateInformation(int x, int y) 
@@ -110,129 +171,241 @@ void BOSSManager::drawStateInformation(int x, int y)
         return;
     }
 
-    BOSS::GameState currentState(BWAPI::Broodwar, BWAPI::Broodwar->self(), BuildingManager::Instance().buildingTypesQueued());
+    BOSS::GameState currentState = getCurrentState();
     BWAPI::Broodwar->drawTextScreen(BWAPI::Position(x-100, y+30), "\x04%s", currentState.getBuildingData().toString().c_str());
     BWAPI::Broodwar->drawTextScreen(BWAPI::Position(x+150, y), "\x04%s", currentState.toString().c_str());
     
 }
 
-// tell the search to keep going for however long we have this frame
-void BOSSManager::update(double timeLimit)
+// our state as BOSS sees it; this reads BWAPI, so it has to be called on the frame thread
+BOSS::GameState BOSSManager::getCurrentState()
 {
-    // if there's a search in progress, resume it
-    if (isSearchInProgress())
-    {
-        _previousStatus.clear();
+    return BOSS::GameState(BWAPI::Broodwar, BWAPI::Broodwar->self(), BuildingManager::Instance().buildingTypesQueued());
+}
 
-        // give the search at least 5ms to search this frame
-        double realTimeLimit = timeLimit < 0 ? 5 : timeLimit;
-        _smartSearch->setTimeLimit((int)realTimeLimit);
-        bool caughtException = false;
+// runs on the search thread, in short calls to the resumable search so that a cancel is noticed soon
+void BOSSManager::runSearch(std::chrono::steady_clock::time_point deadline)
+{
+    // milliseconds per call to the search
+    const int sliceTime = 10;
 
-		try
+    const auto start = std::chrono::steady_clock::now();
+
+    try
+    {
+        while (!_cancelSearch)
         {
-            // call the search to continue searching
+            const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+            _smartSearch->setTimeLimit(std::max(1, std::min(sliceTime, (int)remaining)));
+
             // this will resume a search in progress or start a new search if not yet started
-			_smartSearch->search();
-		}
-		catch (const BOSS::BOSSException &)
+            _smartSearch->search();
+
+            // a build order which can't be beaten by more than a few frames is as good as solved
+            const BOSS::DFBB_BuildOrderSearchResults & results = _smartSearch->getResults();
+            const bool closeEnough = results.solutionFound && (results.upperBound - results.lowerBound <= Config::Macro::BOSSAcceptableGap);
+            if (results.solved || closeEnough)
+            {
+                break;
+            }
+
+            if (std::chrono::steady_clock::now() >= deadline)
+            {
+                _searchTimedOut = true;
+                break;
+            }
+        }
+    }
+    catch (const BOSS::BOSSException &)
+    {
+        _searchThrew = true;
+    }
+
+    _searchTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    _searchFinished = true;
+}
+
+// picks up the results once the search thread has finished
+void BOSSManager::update()
+{
+    if (!isSearchInProgress() || !_searchFinished)
+    {
+        return;
+    }
+
+    _searchThread.join();
+
+    // a search which was cancelled is of no use
+    if (_cancelSearch)
+    {
+        _searchInProgress = false;
+        return;
+    }
+
+    finishSearch();
+}
+
+void BOSSManager::finishSearch()
+{
+    _previousStatus.clear();
+    _totalPreviousSearchTime = _searchTime;
+
+    bool caughtException = _searchThrew;
+    if (caughtException)
+    {
+        if (Config::Debug::DrawBuildOrderSearchInfo)
         {
-			if (Config::Debug::DrawBuildOrderSearchInfo)
-			{
-				BWAPI::Broodwar->drawTextScreen(0, 0, "Search didn't find a solution, resorting to Naive Build Order");
-			}
-            _previousStatus = "BOSSExeption";
-            caughtException = true;
-		}
+            BWAPI::Broodwar->drawTextScreen(0, 0, "Search didn't find a solution, resorting to Naive Build Order");
+        }
+        _previousStatus = "BOSSExeption";
+    }
+
+    bool searchTimeOut = _searchTimedOut;
+    const BOSS::DFBB_BuildOrderSearchResults & results = _smartSearch->getResults();
+    bool closeEnough = results.solutionFound && (results.upperBound - results.lowerBound <= Config::Macro::BOSSAcceptableGap);
+    bool solved = (results.solved || closeEnough) && results.solutionFound;
 
-        _totalPreviousSearchTime += _smartSearch->getResults().timeElapsed;
+    // if we've found a solution, let us know
+    if (Config::Debug::DrawBuildOrderSearchInfo && _smartSearch->getResults().solved)
+    {
+        BWAPI::Broodwar->printf("Build order SOLVED in %d nodes", (int)_smartSearch->getResults().nodesExpanded);
+    }
 
-        // after the search finishes for this frame, check to see if we have a solution or if we hit the overall time limit
-        bool searchTimeOut = (BWAPI::Broodwar->getFrameCount() > (_previousSearchStartFrame + Config::Macro::BOSSFrameLimit));
-        bool previousSearchComplete = searchTimeOut || _smartSearch->getResults().solved || caughtException;
-        if (previousSearchComplete)
+    if (_smartSearch->getResults().solved)
+    {
+        if (_smartSearch->getResults().solutionFound)
+        {
+            _previousStatus = std::string("\x07") + "BOSS Solve Solution\n";
+        }
+        else
         {
-            bool solved = _smartSearch->getResults().solved && _smartSearch->getResults().solutionFound;
+            _previousStatus = std::string("\x03") + "BOSS Solve NoSolution\n";
+        }
+    }
+    else if (closeEnough)
+    {
+        _previousStatus = std::string("\x07") + "BOSS Near-optimal Solution\n";
+    }
 
-            // if we've found a solution, let us know
-			if (Config::Debug::DrawBuildOrderSearchInfo && _smartSearch->getResults().solved)
+    // re-set all the search information to get read for the next search
+    _searchInProgress = false;
+    _previousSearchFinishFrame = BWAPI::Broodwar->getFrameCount();
+    _previousSearchResults = _smartSearch->getResults();
+    _savedSearchResults = _previousSearchResults;
+    _previousBuildOrder = _previousSearchResults.buildOrder;
+
+    // a search with the repaired build order as its upper bound may not have found another as good
+    if (_previousBuildOrder.size() == 0 && _repairedBuildOrder.size() > 0)
+    {
+        _previousBuildOrder = _repairedBuildOrder;
+        _previousStatus = std::string("\x07") + "BOSS Repaired Plan\n";
+    }
+
+    if (_previousBuildOrder.size() > 0)
+    {
+        setLastPlan();
+    }
+
+    if (solved && _previousBuildOrder.size() == 0)
+    {
+        _previousStatus = std::string("\x07") + "BOSS Trivial Solve\n";
+    }
+
+    // if our search resulted in a build order of size 0 then something failed
+    if (!solved && _previousBuildOrder.size() == 0)
+    {
+        // log the debug information since this shouldn't happen if everything goes to plan
+        /*std::stringstream ss;
+        ss << _smartSearch->getParameters().toString() << "\n";
+        ss << "searchTimeOut: " << (searchTimeOut ? "true" : "false") << "\n";
+        ss << "caughtException: " << (caughtException ? "true" : "false") << "\n";
+        ss << "getResults().solved: " << (_smartSearch->getResults().solved ? "true" : "false") << "\n";
+        ss << "getResults().solutionFound: " << (_smartSearch->getResults().solutionFound ? "true" : "false") << "\n";
+        ss << "nodes: " << _savedSearchResults.nodesExpanded << "\n";
+        ss << "time: " << _savedSearchResults.timeElapsed << "\n";
+        Logger::LogOverwriteToFile("bwapi-data/AI/LastBadBuildOrder.txt", ss.str());*/
+        
+        // so try another naive build order search as a last resort
+        BOSS::NaiveBuildOrderSearch nbos(_smartSearch->getParameters().initialState, _smartSearch->getParameters().goal);
+
+		try
+        {
+            if (searchTimeOut)
             {
-                BWAPI::Broodwar->printf("Build order SOLVED in %d nodes", (int)_smartSearch->getResults().nodesExpanded);
+                _previousStatus = std::string("\x02") + "BOSS Timeout\n";
             }
 
-            if (_smartSearch->getResults().solved)
+            if (caughtException)
             {
-                if (_smartSearch->getResults().solutionFound)
-                {
-                    _previousStatus = std::string("\x07") + "BOSS Solve Solution\n";
-                }
-                else
-                {
-                    _previousStatus = std::string("\x03") + "BOSS Solve NoSolution\n";
-                }
+                _previousStatus = std::string("\x02") + "BOSS Exception\n";
             }
 
-            // re-set all the search information to get read for the next search
-            _searchInProgress = false;
-            _previousSearchFinishFrame = BWAPI::Broodwar->getFrameCount();
-            _previousSearchResults = _smartSearch->getResults();
-            _savedSearchResults = _previousSearchResults;
-            _previousBuildOrder = _previousSearchResults.buildOrder;
+			_previousBuildOrder = nbos.solve();
+            _previousStatus += "\x03NBOS Solution";
 
-            if (solved && _previousBuildOrder.size() == 0)
+			return;
+		}
+        // and if that search doesn't work then we're out of luck, no build orders for us
+		catch (const BOSS::BOSSException & exception)
+        {
+            _previousStatus += "\x08Naive Exception";
+            if (Config::Debug::DrawBuildOrderSearchInfo)
             {
-                _previousStatus = std::string("\x07") + "BOSS Trivial Solve\n";
+				UAB_ASSERT_WARNING(false, "BOSS Timeout Naive Search Exception: %s", exception.what());
+				BWAPI::Broodwar->drawTextScreen(0, 20, "No BuildOrder found, returning empty BuildOrder");
             }
+			_previousBuildOrder = BOSS::BuildOrder();
+			return;
+		}
+    }
+}
 
-            // if our search resulted in a build order of size 0 then something failed
-            if (!solved && _previousBuildOrder.size() == 0)
-            {
-                // log the debug information since this shouldn't happen if everything goes to plan
-                /*std::stringstream ss;
-                ss << _smartSearch->getParameters().toString() << "\n";
-                ss << "searchTimeOut: " << (searchTimeOut ? "true" : "false") << "\n";
-                ss << "caughtException: " << (caughtException ? "true" : "false") << "\n";
-                ss << "getResults().solved: " << (_smartSearch->getResults().solved ? "true" : "false") << "\n";
-                ss << "getResults().solutionFound: " << (_smartSearch->getResults().solutionFound ? "true" : "false") << "\n";
-                ss << "nodes: " << _savedSearchResults.nodesExpanded << "\n";
-                ss << "time: " << _savedSearchResults.timeElapsed << "\n";
-                Logger::LogOverwriteToFile("bwapi-data/AI/LastBadBuildOrder.txt", ss.str());*/
-                
-                // so try another naive build order search as a last resort
-                BOSS::NaiveBuildOrderSearch nbos(_smartSearch->getParameters().initialState, _smartSearch->getParameters().goal);
-
-				try
-                {
-                    if (searchTimeOut)
-                    {
-                        _previousStatus = std::string("\x02") + "BOSS Timeout\n";
-                    }
-
-                    if (caughtException)
-                    {
-                        _previousStatus = std::string("\x02") + "BOSS Exception\n";
-                    }
-
-					_previousBuildOrder = nbos.solve();
-                    _previousStatus += "\x03NBOS Solution";
-
-					return;
-				}
-                // and if that search doesn't work then we're out of luck, no build orders for us
-				catch (const BOSS::BOSSException & exception)
-                {
-                    _previousStatus += "\x08Naive Exception";
-                    if (Config::Debug::DrawBuildOrderSearchInfo)
-                    {
-						UAB_ASSERT_WARNING(false, "BOSS Timeout Naive Search Exception: %s", exception.what());
-						BWAPI::Broodwar->drawTextScreen(0, 20, "No BuildOrder found, returning empty BuildOrder");
-                    }
-					_previousBuildOrder = BOSS::BuildOrder();
-					return;
-				}
-            }
+// fast-forwards the last build order to the state and repairs it for the goal, into _repairedBuildOrder
+bool BOSSManager::repairLastPlan(const BOSS::GameState & state, const BOSS::BuildOrderSearchGoal & goal)
+{
+    _repairedBuildOrder.clear();
+
+    if (_lastPlan.empty())
+    {
+        return false;
+    }
+
+    try
+    {
+        BOSS::BuildOrderRepair repair(state, goal);
+        if (repair.repair(_lastPlanState, _lastPlan))
+        {
+            _repairedBuildOrder = repair.getBuildOrder();
+            return true;
         }
     }
+    catch (const BOSS::BOSSException &)
+    {
+        // the search from scratch is still there
+    }
+
+    return false;
+}
+
+void BOSSManager::setLastPlan()
+{
+    _lastPlan = _previousBuildOrder;
+    _lastPlanState = _searchState;
+    _lastPlanGoal = _searchGoal;
+}
+
+// how many goal units the goal differs by from the goal of the last build order
+int BOSSManager::getGoalDelta(const BOSS::BuildOrderSearchGoal & goal) const
+{
+    int delta = 0;
+
+    const std::vector<BOSS::ActionType> & allActionTypes = BOSS::ActionTypes::GetAllActionTypes(getRace());
+    for (const BOSS::ActionType & action : allActionTypes)
+    {
+        delta += std::abs((int)goal.getGoal(action) - (int)_lastPlanGoal.getGoal(action));
+    }
+
+    return delta;
 }
 
 void BOSSManager::logBadSearch()
@@ -4,7 +4,10 @@
 #include "WorkerManager.h"
 #include "../../BOSS/source/BOSS.h"
 #include "StrategyManager.h"
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <thread>
 
 namespace UAlbertaBot
 {
@@ -23,10 +26,29 @@ class BOSSManager
 
     SearchPtr                               _smartSearch;
 
+    // The search runs on its own thread, on a snapshot of the state taken on the frame thread when it
+    // started, and the frame thread only checks whether it has finished. The search thread owns
+    // _smartSearch and writes the other results before setting _searchFinished.
+    std::thread                             _searchThread;
+    std::atomic<bool>                       _searchFinished;
+    std::atomic<bool>                       _cancelSearch;
+    bool                                    _searchTimedOut;
+    bool                                    _searchThrew;
+    double                                  _searchTime;
+
     BOSS::DFBB_BuildOrderSearchResults      _previousSearchResults;
     BOSS::DFBB_BuildOrderSearchResults      _savedSearchResults;
     BOSS::BuildOrder                        _previousBuildOrder;
 
+    // the last build order found, which is kept while it's carried out, so that it can be repaired for the next goal
+    BOSS::BuildOrder                        _lastPlan;
+    BOSS::GameState                         _lastPlanState;
+    BOSS::BuildOrderSearchGoal              _lastPlanGoal;
+
+    BOSS::GameState                         _searchState;
+    BOSS::BuildOrderSearchGoal              _searchGoal;
+    BOSS::BuildOrder                        _repairedBuildOrder;        // to fall back on if the search doesn't find one as good
+
 	BOSS::GameState				            getCurrentState();
 	BOSS::GameState				            getStartState();
 	
@@ -40,14 +62,24 @@ class BOSSManager
 
     void                                    logBadSearch();
 
+    void                                    runSearch(std::chrono::steady_clock::time_point deadline);
+    void                                    finishSearch();
+
+    bool                                    repairLastPlan(const BOSS::GameState & state, const BOSS::BuildOrderSearchGoal & goal);
+    void                                    setLastPlan();
+    int                                     getGoalDelta(const BOSS::BuildOrderSearchGoal & goal) const;
+
 	BOSSManager();
 
 public:
 
+    ~BOSSManager();
+
 	static BOSSManager &	    Instance();
 
-	void						update(double timeLimit);
+	void						update();
     void                        reset();
+    void                        stop();
 
     BuildOrder                  getBuildOrder();
     bool                        isSearchInProgress();
@@ -10,20 +10,375 @@ using namespace UAlbertaBot;
 namespace { auto & bwemMap = BWEM::Map::Instance(); }
 namespace { auto & bwebMap = BWEB::Map::Instance(); }
 
+// A search over every tile of the map that can stop at a deadline and resume where it stopped
+struct BuildingPlacer::BlockSearch
+{
+    int x = 0;
+    int y = 0;
+
+    virtual ~BlockSearch() {}
+
+    // Work to do before the tiles are considered, which can also stop at the deadline and resume.
+    // Returns true when it is done.
+    virtual bool prepare(std::chrono::steady_clock::time_point deadline) { return true; }
+
+    virtual void consider(BWAPI::TilePosition tile) = 0;
+
+    // Returns true when every tile has been considered
+    bool run(std::chrono::steady_clock::time_point deadline)
+    {
+        if (!prepare(deadline)) return false;
+
+        for (; x < BWAPI::Broodwar->mapWidth(); x++, y = 0)
+            for (; y < BWAPI::Broodwar->mapHeight(); y++)
+            {
+                if (std::chrono::steady_clock::now() >= deadline) return false;
+                consider(BWAPI::TilePosition(x, y));
+            }
+
+        return true;
+    }
+};
+
+// Find a hidden tech block: a block with two tech locations hidden from predicted scouting paths
+struct BuildingPlacer::HiddenTechBlockSearch : public BuildingPlacer::BlockSearch
+{
+    std::set<const BWEM::Area*> areasToAvoid;
+    std::set<const BWEM::Area*> areasToPreferablyAvoid;
+    BWTA::BaseLocation * myBase;
+
+    BWAPI::TilePosition tileBest = BWAPI::TilePositions::Invalid;
+    int distBest = INT_MAX;
+
+    HiddenTechBlockSearch()
+        : myBase(InformationManager::Instance().getMyMainBaseLocation())
+    {
+        // First do the pathing to gather which areas we should avoid
+        for (auto base : BWTA::getStartLocations())
+        {
+            if (base == myBase) continue;
+
+            for (auto choke : PathFinding::GetChokePointPath(base->getPosition(), myBase->getPosition(), BWAPI::UnitTypes::Zerg_Zergling, PathFinding::PathFindingOptions::UseNearestBWEMArea))
+            {
+                areasToAvoid.insert(choke->GetAreas().first);
+                areasToAvoid.insert(choke->GetAreas().second);
+                for (auto area : choke->GetAreas().first->AccessibleNeighbours())
+                    areasToPreferablyAvoid.insert(area);
+                for (auto area : choke->GetAreas().second->AccessibleNeighbours())
+                    areasToPreferablyAvoid.insert(area);
+            }
+        }
+    }
+
+    // Now find the closest location where we can build the block
+    // We weight the "preferably avoid" areas so they are only selected if all other options are bad
+    void consider(BWAPI::TilePosition tile) override
+    {
+        if (!tile.isValid()) return;
+        if (!BWAPI::Broodwar->isBuildable(tile)) return;
+        if (areasToAvoid.find(bwemMap.GetNearestArea(tile)) != areasToAvoid.end()) return;
+
+        int dist = -1;
+        if (bwebMap.canAddBlock(tile, 5, 4))
+        {
+            BWAPI::Position blockCenter = BWAPI::Position(tile) + BWAPI::Position(5 * 16, 4 * 16);
+            dist = PathFinding::GetGroundDistance(blockCenter, myBase->getPosition(), BWAPI::UnitTypes::Protoss_Probe, PathFinding::PathFindingOptions::UseNearestBWEMArea);
+            if (dist == -1 || dist > 3000) return;
+        }
+        else if (bwebMap.canAddBlock(tile, 8, 2))
+        {
+            BWAPI::Position blockCenter = BWAPI::Position(tile) + BWAPI::Position(8 * 16, 2 * 16);
+            dist = PathFinding::GetGroundDistance(blockCenter, myBase->getPosition(), BWAPI::UnitTypes::Protoss_Probe, PathFinding::PathFindingOptions::UseNearestBWEMArea);
+            if (dist == -1 || dist > 3000) return;
+        }
+        else
+            return;
+
+        if (areasToPreferablyAvoid.find(bwemMap.GetNearestArea(tile)) != areasToPreferablyAvoid.end())
+            dist += 1000;
+
+        if (dist < distBest)
+        {
+            tileBest = tile;
+            distBest = dist;
+        }
+    }
+};
+
+bool canAddProxyBlock(const BWAPI::TilePosition here, const int width, const int height, const std::set<BWAPI::TilePosition> & unbuildableTiles)
+{
+    // Check 4 corners before checking the rest
+    BWAPI::TilePosition one(here.x, here.y);
+    BWAPI::TilePosition two(here.x + width - 1, here.y);
+    BWAPI::TilePosition three(here.x, here.y + height - 1);
+    BWAPI::TilePosition four(here.x + width - 1, here.y + height - 1);
+
+    if (!one.isValid() || !two.isValid() || !three.isValid() || !four.isValid()) return false;
+    if (unbuildableTiles.find(one) != unbuildableTiles.end()) return false;
+    if (unbuildableTiles.find(two) != unbuildableTiles.end()) return false;
+    if (unbuildableTiles.find(three) != unbuildableTiles.end()) return false;
+    if (unbuildableTiles.find(four) != unbuildableTiles.end()) return false;
+
+    for (auto x = here.x; x < here.x + width; x++) {
+        for (auto y = here.y; y < here.y + height; y++) {
+            BWAPI::TilePosition t(x, y);
+            if (!t.isValid() || unbuildableTiles.find(t) != unbuildableTiles.end())
+                return false;
+        }
+    }
+    return true;
+}
+
+// Finds proxy blocks: one close to each potential enemy base and one at approximately equal distance between them
+struct BuildingPlacer::ProxyBlockSearch : public BuildingPlacer::BlockSearch
+{
+    std::set<BWAPI::TilePosition> unbuildableTiles;
+    std::set<const BWEM::Area*> areasToAvoid;
+    std::vector<BWTA::BaseLocation*> enemyStartLocations;
+    BWAPI::Position mainPosition;
+
+    int overallDistBest = INT_MAX;
+    BWAPI::TilePosition overallTileBest = BWAPI::TilePositions::Invalid;
+    std::map<BWTA::BaseLocation*, int> distBest;
+    std::map<BWTA::BaseLocation*, BWAPI::TilePosition> tileBest;
+
+    std::ostringstream debug;
+
+    // How far prepare() has got
+    int preparedColumns = 0;
+    size_t preparedStartLocations = 0;
+    bool prepared = false;
+
+    ProxyBlockSearch()
+        : mainPosition(InformationManager::Instance().getMyMainBaseLocation()->getPosition())
+    {
+    }
+
+    static void insertWithCollision(BWAPI::TilePosition here, std::set<BWAPI::TilePosition> & tiles)
+    {
+        tiles.insert(here + BWAPI::TilePosition(-1, -1));
+        tiles.insert(here + BWAPI::TilePosition(-1, 0));
+        tiles.insert(here + BWAPI::TilePosition(-1, 1));
+        tiles.insert(here + BWAPI::TilePosition(0, -1));
+        tiles.insert(here);
+        tiles.insert(here + BWAPI::TilePosition(0, 1));
+        tiles.insert(here + BWAPI::TilePosition(1, -1));
+        tiles.insert(here + BWAPI::TilePosition(1, 0));
+        tiles.insert(here + BWAPI::TilePosition(1, 1));
+    }
+
+    // Gathers the tiles and areas to avoid, a map column or a start location at a time
+    bool prepare(std::chrono::steady_clock::time_point deadline) override
+    {
+        if (prepared) return true;
+
+        // Build a set of tiles we don't want to build on
+        // This differs from normal BWEB in that we allow building over base locations
+        for (; preparedColumns < BWAPI::Broodwar->mapWidth(); preparedColumns++)
+        {
+            if (std::chrono::steady_clock::now() >= deadline) return false;
+
+            for (int y = 0; y < BWAPI::Broodwar->mapHeight(); y++)
+            {
+                BWAPI::TilePosition here(preparedColumns, y);
+                if (!bwemMap.GetTile(here).Walkable())
+                    insertWithCollision(here, unbuildableTiles);
+                else if (!bwemMap.GetTile(here).Buildable())
+                    unbuildableTiles.insert(here);
+            }
+        }
+
+        // For base-specific locations, avoid all areas likely to be traversed by worker scouts
+        const auto & startLocations = BWTA::getStartLocations();
+        for (; preparedStartLocations < startLocations.size(); preparedStartLocations++)
+        {
+            if (std::chrono::steady_clock::now() >= deadline) return false;
+
+            auto first = *std::next(startLocations.begin(), preparedStartLocations);
+            for (auto second : startLocations)
+            {
+                if (first == second) continue;
+
+                for (auto choke : PathFinding::GetChokePointPath(first->getPosition(), second->getPosition(), BWAPI::UnitTypes::Protoss_Probe, PathFinding::PathFindingOptions::UseNearestBWEMArea))
+                {
+                    areasToAvoid.insert(choke->GetAreas().first);
+                    areasToAvoid.insert(choke->GetAreas().second);
+                }
+            }
+
+            // Also add any areas that neighbour each start location
+            auto baseArea = bwemMap.GetNearestArea(first->getTilePosition());
+            for (auto area : baseArea->AccessibleNeighbours())
+                areasToAvoid.insert(area);
+        }
+
+        for (auto &unit : BWAPI::Broodwar->getStaticNeutralUnits())
+            for (int x = 0; x <= unit->getType().tileWidth(); x++)
+                for (int y = 0; y <= unit->getType().tileHeight(); y++)
+                    insertWithCollision(unit->getInitialTilePosition() + BWAPI::TilePosition(x, y), unbuildableTiles);
+
+        // Gather the possible enemy start locations
+        if (InformationManager::Instance().getEnemyMainBaseLocation())
+        {
+            enemyStartLocations.push_back(InformationManager::Instance().getEnemyMainBaseLocation());
+        }
+        else
+        {
+            for (auto base : BWTA::getStartLocations())
+            {
+                if (base == InformationManager::Instance().getMyMainBaseLocation()) continue;
+                enemyStartLocations.push_back(base);
+            }
+        }
+
+        // Initialize variables for scoring possible locations
+        for (auto base : enemyStartLocations)
+        {
+            distBest[base] = INT_MAX;
+            tileBest[base] = BWAPI::TilePositions::Invalid;
+        }
+
+        debug << "Finding proxy locations";
+
+        prepared = true;
+        return true;
+    }
+
+    // Find the best locations
+    void consider(BWAPI::TilePosition tile) override
+    {
+        if (!tile.isValid()) return;
+        if (!BWAPI::Broodwar->isBuildable(tile)) return;
+
+        // Consider two types of blocks
+        BWAPI::Position blockCenter;
+        if (canAddProxyBlock(tile, 10, 6, unbuildableTiles))
+        {
+            blockCenter = BWAPI::Position(tile) + BWAPI::Position(10 * 16, 6 * 16);
+        }
+        else
+            return;
+
+        debug << "\nBlock @ " << tile << ": ";
+
+        // Consider each start location
+        bool inStartLocationRegion = false;
+        int minDist = INT_MAX;
+        int maxDist = 0;
+        for (auto base : enemyStartLocations)
+        {
+            debug << "base@" << base->getTilePosition() << ": ";
+
+            // Don't build horror gates
+            if (BWTA::getRegion(blockCenter) == base->getRegion())
+            {
+                debug << "In base region. ";
+                inStartLocationRegion = true;
+                continue;
+            }
+
+            // Compute distance, abort if it is not connected
+            int dist = PathFinding::GetGroundDistance(base->getPosition(), blockCenter, BWAPI::UnitTypes::Protoss_Zealot, PathFinding::PathFindingOptions::UseNearestBWEMArea);
+            if (dist == -1)
+            {
+                debug << "Not connected. ";
+                return;
+            }
+
+            debug << "dist=" << dist;
+
+            // Update overall stats for this tile that we will use for picking a center block
+            if (dist < minDist) minDist = dist;
+            if (dist > maxDist) maxDist = dist;
+
+            if (dist >= distBest[base] || dist < 2000)
+            {
+                debug << ". ";
+                continue;
+            }
+
+            // Reject this block for the base if it overlaps an area we want to avoid
+            if (areasToAvoid.find(bwemMap.GetNearestArea(tile)) != areasToAvoid.end() ||
+                areasToAvoid.find(bwemMap.GetNearestArea(tile + BWAPI::TilePosition(9, 0))) != areasToAvoid.end() ||
+                areasToAvoid.find(bwemMap.GetNearestArea(tile + BWAPI::TilePosition(9, 5))) != areasToAvoid.end() ||
+                areasToAvoid.find(bwemMap.GetNearestArea(tile + BWAPI::TilePosition(0, 5))) != areasToAvoid.end())
+            {
+                debug << "; overlaps avoided area. ";
+                continue;
+            }
+
+            // This is now the best block for this base
+            distBest[base] = dist;
+            tileBest[base] = tile;
+            debug << " (best). ";
+        }
+
+        // Don't consider center positions in a base
+        if (inStartLocationRegion)
+        {
+            debug << "rejecting for center, in start location region";
+            return;
+        }
+
+        // Don't consider center positions too close to a base
+        if (minDist < 2000)
+        {
+            debug << "rejecting for center, too close to a base";
+            return;
+        }
+
+        // On 4+ player maps where the center isn't buildable, prefer locations closest to our main
+        if (enemyStartLocations.size() >= 3 && minDist < ((double)maxDist * 0.75))
+        {
+            int distToOurMain = PathFinding::GetGroundDistance(blockCenter, mainPosition, BWAPI::UnitTypes::Protoss_Probe, PathFinding::PathFindingOptions::UseNearestBWEMArea);
+            if (distToOurMain > minDist)
+            {
+                debug << "rejecting for center, large variance and too far from our main";
+                return;
+            }
+        }
+
+        // Update overall best if appropriate
+        if (maxDist < overallDistBest)
+        {
+            debug << "(best center)";
+            overallDistBest = maxDist;
+            overallTileBest = tile;
+        }
+    }
+};
+
 BuildingPlacer::BuildingPlacer()
-    : _boxTop       (std::numeric_limits<int>::max())
+    : _reserved         (BWAPI::Broodwar->mapWidth(), BWAPI::Broodwar->mapHeight())
+    , _unbuildable      (BWAPI::Broodwar->mapWidth(), BWAPI::Broodwar->mapHeight())
+    , _resourceBoxTiles (BWAPI::Broodwar->mapWidth(), BWAPI::Broodwar->mapHeight())
+    , _baseLocationTiles(BWAPI::Broodwar->mapWidth(), BWAPI::Broodwar->mapHeight())
+    , _boxTop       (std::numeric_limits<int>::max())
     , _boxBottom    (std::numeric_limits<int>::lowest())
     , _boxLeft      (std::numeric_limits<int>::max())
     , _boxRight     (std::numeric_limits<int>::lowest())
     , _hiddenTechBlock  (-1)
     , _centerProxyBlock (-1)
     , _proxyBlock       (-1)
+    , _proxyBlocksFound (false)
 {
-    _reserveMap = std::vector< std::vector<bool> >(BWAPI::Broodwar->mapWidth(),std::vector<bool>(BWAPI::Broodwar->mapHeight(),false));
+    _unbuildable.build([](int x, int y) { return !BWAPI::Broodwar->isBuildable(x, y); });
+
+    // A building overlaps a base location if its footprint, extended by one tile right and down,
+    // touches the resource depot footprint at the base location, also extended by one tile right and down
+    BWAPI::UnitType center = BWAPI::Broodwar->self()->getRace().getCenter();
+    for (BWTA::BaseLocation * base : BWTA::getBaseLocations())
+    {
+        _baseLocationTiles.set(base->getTilePosition().x, base->getTilePosition().y, center.tileWidth() + 1, center.tileHeight() + 1, true);
+    }
 
     computeResourceBox();
 }
 
+BuildingPlacer::~BuildingPlacer()
+{
+}
+
 BuildingPlacer & BuildingPlacer::Instance() 
 {
     static BuildingPlacer instance;
@@ -69,30 +424,27 @@ void BuildingPlacer::computeResourceBox()
     }
 
     //BWAPI::Broodwar->printf("%d %d %d %d", boxTop, boxBottom, boxLeft, boxRight);
+
+    _resourceBoxTiles.build([this](int x, int y) { return isInResourceBox(x, y); });
 }
 
 // makes final checks to see if a building can be built at a certain location
 bool BuildingPlacer::canBuildHere(BWAPI::TilePosition position,const Building & b) const
 {
-    if (!BWAPI::Broodwar->canBuildHere(position,b.type,b.builderUnit))
+    // check the reserve map
+    if (_reserved.count(position.x, position.y, b.type.tileWidth(), b.type.tileHeight()) > 0)
     {
         return false;
     }
 
-    // check the reserve map
-    for (int x = position.x; x < position.x + b.type.tileWidth(); x++)
+    // if it overlaps a base location return false
+    if (tileOverlapsBaseLocation(position,b.type))
     {
-        for (int y = position.y; y < position.y + b.type.tileHeight(); y++)
-        {
-            if (_reserveMap[x][y])
-            {
-                return false;
-            }
-        }
+        return false;
     }
 
-    // if it overlaps a base location return false
-    if (tileOverlapsBaseLocation(position,b.type))
+    // the expensive check last
+    if (!BWAPI::Broodwar->canBuildHere(position,b.type,b.builderUnit))
     {
         return false;
     }
@@ -123,12 +475,6 @@ bool BuildingPlacer::tileBlocksAddon(BWAPI::TilePosition position) const
 // Space value is buildDist. horizontalOnly means only horizontal spacing.
 bool BuildingPlacer::canBuildHereWithSpace(BWAPI::TilePosition position,const Building & b,int buildDist) const
 {
-    //if we can't build here, we of course can't build here with space
-    if (!canBuildHere(position,b))
-    {
-        return false;
-    }
-
     // height and width of the building
     int width(b.type.tileWidth());
     int height(b.type.tileHeight());
@@ -159,23 +505,41 @@ bool BuildingPlacer::canBuildHereWithSpace(BWAPI::TilePosition position,const Bu
         endx = position.x + width + buildDist;
         endy = position.y + height + buildDist;
     }
-\
+
     // if this rectangle doesn't fit on the map we can't build here
     if (startx < 0 || starty < 0 || endx > BWAPI::Broodwar->mapWidth() || endy > BWAPI::Broodwar->mapHeight())
     {
         return false;
     }
 
-    // if space is reserved, or it's in the resource box, we can't build here
-    for (int x = startx; x < endx; x++)
+    if (!b.type.isRefinery())
+    {
+        // if the map doesn't allow it, space is reserved, or it's in the resource box, we can't build here
+        // these are table lookups, so they come before the checks that look at each tile
+        int spaceWidth = endx - startx;
+        int spaceHeight = endy - starty;
+        if (_unbuildable.count(startx, starty, spaceWidth, spaceHeight) > 0 ||
+            _reserved.count(startx, starty, spaceWidth, spaceHeight) > 0 ||
+            (b.type != BWAPI::UnitTypes::Protoss_Photon_Cannon && _resourceBoxTiles.count(startx, starty, spaceWidth, spaceHeight) > 0))
+        {
+            return false;
+        }
+    }
+
+    //if we can't build here, we of course can't build here with space
+    if (!canBuildHere(position,b))
+    {
+        return false;
+    }
+
+    // if a building or another unit is in the way, we can't build here
+    if (!b.type.isRefinery())
     {
-        for (int y = starty; y < endy; y++)
+        for (int x = startx; x < endx; x++)
         {
-            if (!b.type.isRefinery())
+            for (int y = starty; y < endy; y++)
             {
-                if (!buildable(b,x,y) ||
-					_reserveMap[x][y] ||
-					(b.type != BWAPI::UnitTypes::Protoss_Photon_Cannon && isInResourceBox(x,y)))
+                if (!buildable(b,x,y))
                 {
                     return false;
                 }
@@ -213,33 +577,8 @@ bool BuildingPlacer::tileOverlapsBaseLocation(BWAPI::TilePosition tile, BWAPI::U
         return false;
     }
 
-    // dimensions of the proposed location
-    int tx1 = tile.x;
-    int ty1 = tile.y;
-    int tx2 = tx1 + type.tileWidth();
-    int ty2 = ty1 + type.tileHeight();
-
-    // for each base location
-    for (BWTA::BaseLocation * base : BWTA::getBaseLocations())
-    {
-        // dimensions of the base location
-        int bx1 = base->getTilePosition().x;
-        int by1 = base->getTilePosition().y;
-        int bx2 = bx1 + BWAPI::Broodwar->self()->getRace().getCenter().tileWidth();
-        int by2 = by1 + BWAPI::Broodwar->self()->getRace().getCenter().tileHeight();
-
-        // conditions for non-overlap are easy
-        bool noOverlap = (tx2 < bx1) || (tx1 > bx2) || (ty2 < by1) || (ty1 > by2);
-
-        // if the reverse is true, return true
-        if (!noOverlap)
-        {
-            return true;
-        }
-    }
-
-    // otherwise there is no overlap
-    return false;
+    // the proposed location, extended by one tile right and down, against the base location tiles
+    return _baseLocationTiles.count(tile.x, tile.y, type.tileWidth() + 1, type.tileHeight() + 1) > 0;
 }
 
 bool BuildingPlacer::buildable(const Building & b,int x,int y) const
@@ -277,19 +616,8 @@ bool BuildingPlacer::buildable(const Building & b,int x,int y) const
 
 void BuildingPlacer::reserveTiles(BWAPI::TilePosition position,int width,int height)
 {
-    int rwidth = _reserveMap.size();
-    int rheight = _reserveMap[0].size();
-    for (int x = position.x; x < position.x + width && x < rwidth; x++)
-    {
-        for (int y = position.y; y < position.y + height && y < rheight; y++)
-        {
-			BWAPI::TilePosition t(x, y);
-			if (!t.isValid()) continue;
-
-			_reserveMap[x][y] = true;
-			bwebMap.getUsedTiles().insert(t);
-		}
-    }
+    _reserved.set(position.x, position.y, width, height, true);
+    bwebMap.occupancy.set(BWEB::Layers::Planned, position, width, height);
 }
 
 void BuildingPlacer::drawReservedTiles()
@@ -299,14 +627,11 @@ void BuildingPlacer::drawReservedTiles()
         return;
     }
 
-    int rwidth = _reserveMap.size();
-    int rheight = _reserveMap[0].size();
-
-    for (int x = 0; x < rwidth; ++x)
+    for (int x = 0; x < BWAPI::Broodwar->mapWidth(); ++x)
     {
-        for (int y = 0; y < rheight; ++y)
+        for (int y = 0; y < BWAPI::Broodwar->mapHeight(); ++y)
         {
-            if (_reserveMap[x][y] || isInResourceBox(x,y))
+            if (_reserved.get(x,y) || isInResourceBox(x,y))
             {
                 int x1 = x*32 + 8;
                 int y1 = y*32 + 8;
@@ -321,20 +646,8 @@ void BuildingPlacer::drawReservedTiles()
 
 void BuildingPlacer::freeTiles(BWAPI::TilePosition position, int width, int height)
 {
-    int rwidth = _reserveMap.size();
-    int rheight = _reserveMap[0].size();
-
-    for (int x = position.x; x < position.x + width && x < rwidth; x++)
-    {
-        for (int y = position.y; y < position.y + height && y < rheight; y++)
-        {
-			BWAPI::TilePosition t(x, y);
-			if (!t.isValid()) continue;
-			
-			_reserveMap[x][y] = false;
-			bwebMap.getUsedTiles().erase(t);
-		}
-    }
+    _reserved.set(position.x, position.y, width, height, false);
+    bwebMap.occupancy.reset(BWEB::Layers::Planned, position, width, height);
 }
 
 // NOTE This allows building only on accessible geysers.
@@ -376,89 +689,317 @@ BWAPI::TilePosition BuildingPlacer::getRefineryPosition()
 
 bool BuildingPlacer::isReserved(int x, int y) const
 {
-    int rwidth = _reserveMap.size();
-    int rheight = _reserveMap[0].size();
-    if (x < 0 || y < 0 || x >= rwidth || y >= rheight)
+    return _reserved.get(x, y);
+}
+
+namespace
+{
+    // Bump when the layout file format or the way the layout is computed changes
+    const int BWEBLayoutVersion = 2;
+
+    // The layout depends on the map, our start location and race, and the kind of wall
+    std::string bwebLayoutFileName(const std::string & wallType)
     {
-        return false;
+        BWAPI::TilePosition start = BWAPI::Broodwar->self()->getStartLocation();
+        return "layout-" + BWAPI::Broodwar->mapHash() +
+            "-" + std::to_string(start.x) + "-" + std::to_string(start.y) +
+            "-" + BWAPI::Broodwar->self()->getRace().getName() +
+            "-" + wallType + ".txt";
+    }
+
+    template <class Point>
+    void readPoint(std::istream & in, Point & point)
+    {
+        in >> point.x >> point.y;
     }
 
-    return _reserveMap[x][y];
+    template <class Point>
+    std::string pointString(Point point)
+    {
+        return std::to_string(point.x) + " " + std::to_string(point.y);
+    }
+
+    // Whether a building of the given size could still go here: a cheap check that the cached layout fits the map
+    bool buildableFootprint(BWAPI::TilePosition tile, int width, int height)
+    {
+        for (int x = tile.x; x < tile.x + width; x++)
+            for (int y = tile.y; y < tile.y + height; y++)
+                if (!BWAPI::TilePosition(x, y).isValid() || !BWAPI::Broodwar->isBuildable(x, y)) return false;
+        return true;
+    }
 }
 
 void BuildingPlacer::initializeBWEB()
 {
     bwebMap.onStart();
 
+    // The rest is deterministic for the map, our start location and race, and it is the slow part of onStart,
+    // so we reuse the layout of an earlier game when there is one
+    const std::string layoutFile = bwebLayoutFileName("forge-gateway-tight");
+    if (loadBWEBLayout(Config::IO::ReadDir + layoutFile) || loadBWEBLayout(Config::IO::WriteDir + layoutFile))
+    {
+        Log().Get() << "Loaded BWEB layout " << layoutFile;
+        return;
+    }
+
     // TODO: Check if non-tight walls are better vs. protoss and terran
     _wall = LocutusWall::CreateForgeGatewayWall(true);
 
-    findHiddenTechBlock();
-    findProxyBlocks();
+    // We need the start block first, for the first pylon. The other blocks are found over the next frames, see update(),
+    // and the layout is saved when they are done
+    bwebMap.startBlocks(BWAPI::Broodwar->self()->getRace());
+    _hiddenTechBlockSearch.reset(new HiddenTechBlockSearch());
+    _layoutFile = Config::IO::WriteDir + layoutFile;
+
+    // Proxy blocks may be added to the overlap layer before the layout is saved, so remember what is in it now
+    _layoutOverlap.assign(BWAPI::Broodwar->mapHeight(), std::string(BWAPI::Broodwar->mapWidth(), '0'));
+    for (int y = 0; y < BWAPI::Broodwar->mapHeight(); y++)
+        for (int x = 0; x < BWAPI::Broodwar->mapWidth(); x++)
+            if (bwebMap.occupancy.test(BWEB::Layers::Overlap, BWAPI::TilePosition(x, y))) _layoutOverlap[y][x] = '1';
+}
+
+// Spends the frame's share of time on the block searches that are not done yet.
+// Proxy blocks come first once they are wanted, then the hidden tech block, then the other blocks.
+void BuildingPlacer::update()
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(Config::Macro::BlockSearchFrameBudget);
+
+    if (runProxyBlockSearch(deadline))
+    {
+        runBlockSearches(deadline);
+    }
+}
+
+// Each of these returns true if its search is done, or there is none
+
+bool BuildingPlacer::runHiddenTechBlockSearch(std::chrono::steady_clock::time_point deadline)
+{
+    if (!_hiddenTechBlockSearch) return true;
+    if (!_hiddenTechBlockSearch->run(deadline)) return false;
 
-    bwebMap.findBlocks();
+    addHiddenTechBlock(_hiddenTechBlockSearch->tileBest);
+    _hiddenTechBlockSearch.reset();
+    return true;
 }
 
-// Find a hidden tech block: a block with two tech locations hidden from predicted scouting paths
-void BuildingPlacer::findHiddenTechBlock()
+// The hidden tech block goes before the other blocks, so that they don't take its place
+bool BuildingPlacer::runBlockSearches(std::chrono::steady_clock::time_point deadline)
 {
-    // First do the pathing to gather which areas we should avoid
-    std::set<const BWEM::Area*> areasToAvoid;
-    std::set<const BWEM::Area*> areasToPreferablyAvoid;
-    auto _myBase = InformationManager::Instance().getMyMainBaseLocation();
-    for (auto base : BWTA::getStartLocations())
+    if (!runHiddenTechBlockSearch(deadline)) return false;
+    if (!bwebMap.continueBlocks(deadline)) return false;
+
+    if (!_layoutFile.empty())
     {
-        if (base == _myBase) continue;
+        saveBWEBLayout(_layoutFile);
+        _layoutFile.clear();
+    }
+    return true;
+}
+
+bool BuildingPlacer::runProxyBlockSearch(std::chrono::steady_clock::time_point deadline)
+{
+    if (!_proxyBlockSearch) return true;
+    if (!_proxyBlockSearch->run(deadline)) return false;
 
-        for (auto choke : PathFinding::GetChokePointPath(base->getPosition(), _myBase->getPosition(), BWAPI::UnitTypes::Zerg_Zergling, PathFinding::PathFindingOptions::UseNearestBWEMArea))
+    addProxyBlocks(*_proxyBlockSearch);
+    _proxyBlockSearch.reset();
+    _proxyBlocksFound = true;
+    return true;
+}
+
+// The layout file holds what initializeBWEB and the block searches compute after BWEB's onStart, one record per line:
+//   BWEBLayout <version>
+//   station <x> <y>                           location of each BWEB station, to check that onStart found the same ones
+//   wall <forge> <gateway> <pylon> <gap size> <gap center> <gap end 1> <gap end 2>     tiles, then positions; no wall if absent
+//   cannon <x> <y>                            one per wall cannon, in order
+//   pathEnds <start tile> <end tile>          the ends of the path through the wall
+//   startBlockPylon <x> <y>
+//   block <x> <y> <width> <height>            one per BWEB block, in order, followed by its building tiles:
+//   small|medium|large <x> <y>
+//   hiddenTechBlock <index>                   index into the blocks, -1 if none
+//   overlap                                   followed by <map height> lines of <map width> 0 or 1
+//   end
+// The wall's inside and outside tiles are not saved, they are only used while the wall is created.
+// Proxy blocks are not saved either: they are found when a game needs them, see findProxyBlocks.
+bool BuildingPlacer::loadBWEBLayout(const std::string & fileName)
+{
+    std::ifstream in(fileName);
+    if (!in) return false;
+
+    std::string record;
+    int version = 0;
+    if (!(in >> record >> version) || record != "BWEBLayout" || version != BWEBLayoutVersion) return false;
+
+    // Read everything before changing anything, so that a bad file leaves us where we were
+    std::vector<BWAPI::TilePosition> stations;
+    LocutusWall wall;
+    BWAPI::TilePosition startTile = bwebMap.startTile;
+    BWAPI::TilePosition endTile = bwebMap.endTile;
+    BWAPI::TilePosition startBlockPylon = BWAPI::TilePositions::Invalid;
+    std::vector<BWEB::Block> blocks;
+    int hiddenTechBlock = -1;
+    std::vector<std::string> overlap;
+    bool complete = false;
+
+    while (!complete && in >> record)
+    {
+        BWAPI::TilePosition tile;
+        if (record == "station")
+        {
+            readPoint(in, tile);
+            stations.push_back(tile);
+        }
+        else if (record == "wall")
+        {
+            readPoint(in, wall.forge);
+            readPoint(in, wall.gateway);
+            readPoint(in, wall.pylon);
+            in >> wall.gapSize;
+            readPoint(in, wall.gapCenter);
+            readPoint(in, wall.gapEnd1);
+            readPoint(in, wall.gapEnd2);
+            for (const auto & placement : wall.placements())
+                if (!buildableFootprint(placement.second, placement.first.tileWidth(), placement.first.tileHeight())) return false;
+        }
+        else if (record == "cannon")
+        {
+            readPoint(in, tile);
+            if (!buildableFootprint(tile, BWAPI::UnitTypes::Protoss_Photon_Cannon.tileWidth(), BWAPI::UnitTypes::Protoss_Photon_Cannon.tileHeight())) return false;
+            wall.cannons.push_back(tile);
+        }
+        else if (record == "pathEnds")
+        {
+            readPoint(in, startTile);
+            readPoint(in, endTile);
+        }
+        else if (record == "startBlockPylon")
+        {
+            readPoint(in, startBlockPylon);
+        }
+        else if (record == "block")
+        {
+            int width, height;
+            readPoint(in, tile);
+            in >> width >> height;
+            if (!buildableFootprint(tile, width, height)) return false;
+            blocks.emplace_back(width, height, tile);
+        }
+        else if (record == "small" || record == "medium" || record == "large")
+        {
+            readPoint(in, tile);
+            if (blocks.empty()) return false;
+            if (record == "small") blocks.back().insertSmall(tile);
+            else if (record == "medium") blocks.back().insertMedium(tile);
+            else blocks.back().insertLarge(tile);
+        }
+        else if (record == "hiddenTechBlock")
+        {
+            in >> hiddenTechBlock;
+        }
+        else if (record == "overlap")
         {
-            areasToAvoid.insert(choke->GetAreas().first);
-            areasToAvoid.insert(choke->GetAreas().second);
-            for (auto area : choke->GetAreas().first->AccessibleNeighbours())
-                areasToPreferablyAvoid.insert(area);
-            for (auto area : choke->GetAreas().second->AccessibleNeighbours())
-                areasToPreferablyAvoid.insert(area);
+            overlap.resize(BWAPI::Broodwar->mapHeight());
+            for (std::string & line : overlap)
+                if (!(in >> line) || int(line.size()) != BWAPI::Broodwar->mapWidth()) return false;
         }
+        else if (record == "end")
+        {
+            complete = true;
+        }
+        else
+        {
+            return false;
+        }
+
+        if (!in) return false;
     }
 
-    // Now find the closest location where we can build the block
-    // We weight the "preferably avoid" areas so they are only selected if all other options are bad
-    BWAPI::TilePosition tileBest = BWAPI::TilePositions::Invalid;
-    int distBest = INT_MAX;
-    for (int x = 0; x < BWAPI::Broodwar->mapWidth(); x++)
-        for (int y = 0; y < BWAPI::Broodwar->mapHeight(); y++) 
-        {
-            BWAPI::TilePosition tile(x, y);
-            if (!tile.isValid()) continue;
-            if (!BWAPI::Broodwar->isBuildable(tile)) continue;
-            if (areasToAvoid.find(bwemMap.GetNearestArea(tile)) != areasToAvoid.end()) continue;
+    // Check that the file is whole and fits what onStart found
+    if (!complete || overlap.empty()) return false;
+    if (stations.size() != bwebMap.stations.size()) return false;
+    for (size_t i = 0; i < stations.size(); i++)
+        if (stations[i] != bwebMap.stations[i].BWEMBase()->Location()) return false;
+    if (hiddenTechBlock < -1 || hiddenTechBlock >= int(blocks.size())) return false;
+
+    // Apply it
+    _wall = wall;
+    _hiddenTechBlock = hiddenTechBlock;
+
+    bwebMap.blocks.clear();
+    bwebMap.occupancy.clear(BWEB::Layers::Block);
+    for (const auto & block : blocks)
+        bwebMap.addBlock(block);
+    bwebMap.startBlockPylon = startBlockPylon;
+    bwebMap.startTile = startTile;
+    bwebMap.endTile = endTile;
+    bwebMap.occupancy.clear(BWEB::Layers::Overlap);
+    for (int y = 0; y < BWAPI::Broodwar->mapHeight(); y++)
+        for (int x = 0; x < BWAPI::Broodwar->mapWidth(); x++)
+            if (overlap[y][x] == '1') bwebMap.occupancy.set(BWEB::Layers::Overlap, BWAPI::TilePosition(x, y));
 
-            int dist = -1;
-            if (bwebMap.canAddBlock(tile, 5, 4))
-            {
-                BWAPI::Position blockCenter = BWAPI::Position(tile) + BWAPI::Position(5 * 16, 4 * 16);
-                dist = PathFinding::GetGroundDistance(blockCenter, _myBase->getPosition(), BWAPI::UnitTypes::Protoss_Probe, PathFinding::PathFindingOptions::UseNearestBWEMArea);
-                if (dist == -1 || dist > 3000) continue;
-            }
-            else if (bwebMap.canAddBlock(tile, 8, 2))
-            {
-                BWAPI::Position blockCenter = BWAPI::Position(tile) + BWAPI::Position(8 * 16, 2 * 16);
-                dist = PathFinding::GetGroundDistance(blockCenter, _myBase->getPosition(), BWAPI::UnitTypes::Protoss_Probe, PathFinding::PathFindingOptions::UseNearestBWEMArea);
-                if (dist == -1 || dist > 3000) continue;
-            }
-            else
-                continue;
+    return true;
+}
 
-            if (areasToPreferablyAvoid.find(bwemMap.GetNearestArea(tile)) != areasToPreferablyAvoid.end())
-                dist += 1000;
+void BuildingPlacer::saveBWEBLayout(const std::string & fileName) const
+{
+    std::ofstream out(fileName, std::ios::trunc);
+    if (!out) return;
 
-            if (dist < distBest)
-            {
-                tileBest = tile;
-                distBest = dist;
-            }
+    out << "BWEBLayout " << BWEBLayoutVersion << "\n";
+
+    for (const auto & station : bwebMap.stations)
+        out << "station " << pointString(station.BWEMBase()->Location()) << "\n";
+
+    if (_wall.isValid())
+    {
+        out << "wall " << pointString(_wall.forge) << " " << pointString(_wall.gateway) << " " << pointString(_wall.pylon) << " " << _wall.gapSize
+            << " " << pointString(_wall.gapCenter) << " " << pointString(_wall.gapEnd1) << " " << pointString(_wall.gapEnd2) << "\n";
+        for (const auto & cannon : _wall.cannons)
+            out << "cannon " << pointString(cannon) << "\n";
+    }
+    out << "pathEnds " << pointString(bwebMap.startTile) << " " << pointString(bwebMap.endTile) << "\n";
+    out << "startBlockPylon " << pointString(bwebMap.startBlockPylon) << "\n";
+
+    // The live overlap layer also has the proxy blocks and the blocks they replaced,
+    // so the saved one is built from the overlap before the searches and the blocks we save
+    std::vector<std::string> overlap = _layoutOverlap;
+
+    // Leave out the proxy blocks, and skip them in the hidden tech block's index
+    int hiddenTechBlock = _hiddenTechBlock;
+    for (int i = 0; i < int(bwebMap.blocks.size()); i++)
+    {
+        if (isProxyBlock(i))
+        {
+            if (i < _hiddenTechBlock) hiddenTechBlock--;
+            continue;
         }
 
+        const auto & block = bwebMap.blocks[i];
+        for (int y = std::max(0, block.Location().y); y < std::min(BWAPI::Broodwar->mapHeight(), block.Location().y + block.height()); y++)
+            for (int x = std::max(0, block.Location().x); x < std::min(BWAPI::Broodwar->mapWidth(), block.Location().x + block.width()); x++)
+                overlap[y][x] = '1';
+
+        out << "block " << pointString(block.Location()) << " " << block.width() << " " << block.height() << "\n";
+        for (const auto & tile : block.SmallTiles())
+            out << "small " << pointString(tile) << "\n";
+        for (const auto & tile : block.MediumTiles())
+            out << "medium " << pointString(tile) << "\n";
+        for (const auto & tile : block.LargeTiles())
+            out << "large " << pointString(tile) << "\n";
+    }
+
+    out << "hiddenTechBlock " << hiddenTechBlock << "\n";
+
+    out << "overlap\n";
+    for (const std::string & line : overlap)
+        out << line << "\n";
+
+    out << "end\n";
+}
+
+// Adds the hidden tech block the search found, if it found one
+void BuildingPlacer::addHiddenTechBlock(BWAPI::TilePosition tileBest)
+{
     // If there was a position, add the block
     if (tileBest.isValid())
     {
@@ -471,7 +1012,7 @@ void BuildingPlacer::findHiddenTechBlock()
             newBlock.insertSmall(tileBest + BWAPI::TilePosition(0, 2));
             newBlock.insertMedium(tileBest + BWAPI::TilePosition(2, 0));
             newBlock.insertMedium(tileBest + BWAPI::TilePosition(2, 2));
-            bwebMap.blocks.push_back(newBlock);
+            bwebMap.addBlock(newBlock);
 
             _hiddenTechBlock = bwebMap.blocks.size() - 1;
 
@@ -485,7 +1026,7 @@ void BuildingPlacer::findHiddenTechBlock()
             newBlock.insertMedium(tileBest);
             newBlock.insertSmall(tileBest + BWAPI::TilePosition(3, 0));
             newBlock.insertMedium(tileBest + BWAPI::TilePosition(5, 0));
-            bwebMap.blocks.push_back(newBlock);
+            bwebMap.addBlock(newBlock);
 
             _hiddenTechBlock = bwebMap.blocks.size() - 1;
 
@@ -498,36 +1039,13 @@ void BuildingPlacer::findHiddenTechBlock()
         Log().Get() << "No suitable hidden tech block could be found.";
 }
 
-bool canAddProxyBlock(const BWAPI::TilePosition here, const int width, const int height, std::set<BWAPI::TilePosition> & unbuildableTiles)
-{
-    // Check 4 corners before checking the rest
-    BWAPI::TilePosition one(here.x, here.y);
-    BWAPI::TilePosition two(here.x + width - 1, here.y);
-    BWAPI::TilePosition three(here.x, here.y + height - 1);
-    BWAPI::TilePosition four(here.x + width - 1, here.y + height - 1);
-
-    if (!one.isValid() || !two.isValid() || !three.isValid() || !four.isValid()) return false;
-    if (unbuildableTiles.find(one) != unbuildableTiles.end()) return false;
-    if (unbuildableTiles.find(two) != unbuildableTiles.end()) return false;
-    if (unbuildableTiles.find(three) != unbuildableTiles.end()) return false;
-    if (unbuildableTiles.find(four) != unbuildableTiles.end()) return false;
-
-    for (auto x = here.x; x < here.x + width; x++) {
-        for (auto y = here.y; y < here.y + height; y++) {
-            BWAPI::TilePosition t(x, y);
-            if (!t.isValid() || unbuildableTiles.find(t) != unbuildableTiles.end())
-                return false;
-        }
-    }
-    return true;
-}
-
-int addProxyBlock(BWAPI::TilePosition tile, std::set<BWAPI::TilePosition> & unbuildableTiles)
+int BuildingPlacer::addProxyBlock(BWAPI::TilePosition tile, const std::set<BWAPI::TilePosition> & unbuildableTiles)
 {
     if (!tile.isValid()) return -1;
 
     if (canAddProxyBlock(tile, 10, 6, unbuildableTiles))
     {
+        eraseBlocksOverlapping(tile, 10, 6);
         bwebMap.addOverlap(tile, 10, 6);
 
         BWEB::Block newBlock(10, 6, tile);
@@ -538,7 +1056,7 @@ int addProxyBlock(BWAPI::TilePosition tile, std::set<BWAPI::TilePosition> & unbu
         newBlock.insertSmall(tile + BWAPI::TilePosition(4, 4));
         newBlock.insertLarge(tile + BWAPI::TilePosition(6, 0));
         newBlock.insertLarge(tile + BWAPI::TilePosition(6, 3));
-        bwebMap.blocks.push_back(newBlock);
+        bwebMap.addBlock(newBlock);
 
         Log().Debug() << "Added 10x6 proxy block @ " << tile;
 
@@ -550,214 +1068,82 @@ int addProxyBlock(BWAPI::TilePosition tile, std::set<BWAPI::TilePosition> & unbu
     return -1;
 }
 
-// Finds proxy blocks: one close to each potential enemy base and one at approximately equal distance between them
-void BuildingPlacer::findProxyBlocks()
+// Adds the blocks the proxy block search found
+void BuildingPlacer::addProxyBlocks(const ProxyBlockSearch & search)
 {
-    // Build a set of tiles we don't want to build on
-    // This differs from normal BWEB in that we allow building over base locations
-    auto insertWithCollision = [](BWAPI::TilePosition here, std::set<BWAPI::TilePosition> & tiles)
+    _centerProxyBlock = addProxyBlock(search.overallTileBest, search.unbuildableTiles);
+    for (auto base : search.enemyStartLocations)
     {
-        tiles.insert(here + BWAPI::TilePosition(-1, -1));
-        tiles.insert(here + BWAPI::TilePosition(-1, 0));
-        tiles.insert(here + BWAPI::TilePosition(-1, 1));
-        tiles.insert(here + BWAPI::TilePosition(0, -1));
-        tiles.insert(here);
-        tiles.insert(here + BWAPI::TilePosition(0, 1));
-        tiles.insert(here + BWAPI::TilePosition(1, -1));
-        tiles.insert(here + BWAPI::TilePosition(1, 0));
-        tiles.insert(here + BWAPI::TilePosition(1, 1));
-    };
-    std::set<BWAPI::TilePosition> unbuildableTiles;
-    for (int x = 0; x < BWAPI::Broodwar->mapWidth(); x++)
-        for (int y = 0; y < BWAPI::Broodwar->mapHeight(); y++)
-        {
-            BWAPI::TilePosition here(x, y);
-            if (!bwemMap.GetTile(here).Walkable())
-                insertWithCollision(here, unbuildableTiles);
-            else if (!bwemMap.GetTile(here).Buildable())
-                unbuildableTiles.insert(here);
-        }
-    for (auto &unit : BWAPI::Broodwar->neutral()->getUnits())
-        for (int x = 0; x <= unit->getType().tileWidth(); x++)
-            for (int y = 0; y <= unit->getType().tileHeight(); y++)
-                insertWithCollision(unit->getTilePosition() + BWAPI::TilePosition(x, y), unbuildableTiles);
+        BWAPI::TilePosition tileBest = search.tileBest.at(base);
 
-    // For base-specific locations, avoid all areas likely to be traversed by worker scouts
-    std::set<const BWEM::Area*> areasToAvoid;
-    for (auto first : BWTA::getStartLocations())
-    {
-        for (auto second : BWTA::getStartLocations())
+        // Map-specific tweak: on Heartbreak Ridge units somewhat randomly take the top or bottom paths around the middle base
+        // So here we manually fix one base location that otherwise puts the proxy in an easy-to-discover location
+        // TODO: Find a more elegant way to deal with this
+        if (BWAPI::Broodwar->mapHash() == "6f8da3c3cc8d08d9cf882700efa049280aedca8c" &&
+            base->getTilePosition() == BWAPI::TilePosition(117, 56))
         {
-            if (first == second) continue;
-
-            for (auto choke : PathFinding::GetChokePointPath(first->getPosition(), second->getPosition(), BWAPI::UnitTypes::Protoss_Probe, PathFinding::PathFindingOptions::UseNearestBWEMArea))
-            {
-                areasToAvoid.insert(choke->GetAreas().first);
-                areasToAvoid.insert(choke->GetAreas().second);
-            }
+            tileBest = BWAPI::TilePosition(76, 2);
         }
 
-        // Also add any areas that neighbour each start location
-        auto baseArea = bwemMap.GetNearestArea(first->getTilePosition());
-        for (auto area : baseArea->AccessibleNeighbours())
-            areasToAvoid.insert(area);
+        _baseProxyBlocks[base] = addProxyBlock(tileBest, search.unbuildableTiles);
     }
 
-    // Gather the possible enemy start locations
-    std::vector<BWTA::BaseLocation*> enemyStartLocations;
-    if (InformationManager::Instance().getEnemyMainBaseLocation())
-    {
-        enemyStartLocations.push_back(InformationManager::Instance().getEnemyMainBaseLocation());
-    }
-    else
-    {
-        for (auto base : BWTA::getStartLocations())
-        {
-            if (base == InformationManager::Instance().getMyMainBaseLocation()) continue;
-            enemyStartLocations.push_back(base);
-        }
-    }
+    Log().Debug() << search.debug.str();
+}
 
-    // Initialize variables for scoring possible locations
-    int overallDistBest = INT_MAX;
-    BWAPI::TilePosition overallTileBest = BWAPI::TilePositions::Invalid;
-    std::map<BWTA::BaseLocation*, int> distBest;
-    std::map<BWTA::BaseLocation*, BWAPI::TilePosition> tileBest;
-    for (auto base : enemyStartLocations)
+// The proxy blocks may be found after the other blocks, so they take the place of the ones they overlap.
+// The start block and the hidden tech block stay, and the block indexes we keep are updated.
+void BuildingPlacer::eraseBlocksOverlapping(BWAPI::TilePosition tile, int width, int height)
+{
+    auto overlaps = [&](BWAPI::TilePosition here, int w, int h)
     {
-        distBest[base] = INT_MAX;
-        tileBest[base] = BWAPI::TilePositions::Invalid;
-        _baseProxyBlocks[base] = -1;
-    }
-
-    std::ostringstream debug;
-    debug << "Finding proxy locations";
+        return here.x < tile.x + width && tile.x < here.x + w && here.y < tile.y + height && tile.y < here.y + h;
+    };
 
-    // Find the best locations
-    BWAPI::Position mainPosition = InformationManager::Instance().getMyMainBaseLocation()->getPosition();
-    for (int x = 0; x < BWAPI::Broodwar->mapWidth(); x++)
-        for (int y = 0; y < BWAPI::Broodwar->mapHeight(); y++)
+    for (int i = int(bwebMap.blocks.size()) - 1; i >= 0; i--)
+    {
+        const BWEB::Block & block = bwebMap.blocks[i];
+        if (i == _hiddenTechBlock || isProxyBlock(i)) continue;
+        if (!overlaps(block.Location(), block.width(), block.height())) continue;
+
+        // The start block has the first pylon
+        const BWAPI::TilePosition pylon = bwebMap.startBlockPylon;
+        if (pylon.isValid() && pylon.x >= block.Location().x && pylon.x < block.Location().x + block.width() &&
+            pylon.y >= block.Location().y && pylon.y < block.Location().y + block.height())
         {
-            BWAPI::TilePosition tile(x, y);
-            if (!tile.isValid()) continue;
-            if (!BWAPI::Broodwar->isBuildable(tile)) continue;
-
-            // Consider two types of blocks
-            BWAPI::Position blockCenter;
-            if (canAddProxyBlock(tile, 10, 6, unbuildableTiles))
-            {
-                blockCenter = BWAPI::Position(tile) + BWAPI::Position(10 * 16, 6 * 16);
-            }
-            else
-                continue;
-
-            debug << "\nBlock @ " << tile << ": ";
-
-            // Consider each start location
-            bool inStartLocationRegion = false;
-            int minDist = INT_MAX;
-            int maxDist = 0;
-            for (auto base : enemyStartLocations)
-            {
-                debug << "base@" << base->getTilePosition() << ": ";
-
-                // Don't build horror gates
-                if (BWTA::getRegion(blockCenter) == base->getRegion())
-                {
-                    debug << "In base region. ";
-                    inStartLocationRegion = true;
-                    continue;
-                }
-
-                // Compute distance, abort if it is not connected
-                int dist = PathFinding::GetGroundDistance(base->getPosition(), blockCenter, BWAPI::UnitTypes::Protoss_Zealot, PathFinding::PathFindingOptions::UseNearestBWEMArea);
-                if (dist == -1)
-                {
-                    debug << "Not connected. ";
-                    goto nextTile;
-                }
-
-                debug << "dist=" << dist;
-
-                // Update overall stats for this tile that we will use for picking a center block
-                if (dist < minDist) minDist = dist;
-                if (dist > maxDist) maxDist = dist;
-
-                if (dist >= distBest[base] || dist < 2000)
-                {
-                    debug << ". ";
-                    continue;
-                }
-
-                // Reject this block for the base if it overlaps an area we want to avoid
-                if (areasToAvoid.find(bwemMap.GetNearestArea(tile)) != areasToAvoid.end() ||
-                    areasToAvoid.find(bwemMap.GetNearestArea(tile + BWAPI::TilePosition(9, 0))) != areasToAvoid.end() ||
-                    areasToAvoid.find(bwemMap.GetNearestArea(tile + BWAPI::TilePosition(9, 5))) != areasToAvoid.end() ||
-                    areasToAvoid.find(bwemMap.GetNearestArea(tile + BWAPI::TilePosition(0, 5))) != areasToAvoid.end())
-                {
-                    debug << "; overlaps avoided area. ";
-                    continue;
-                }
-
-                // This is now the best block for this base
-                distBest[base] = dist;
-                tileBest[base] = tile;
-                debug << " (best). ";
-            }
-
-            // Don't consider center positions in a base
-            if (inStartLocationRegion)
-            {
-                debug << "rejecting for center, in start location region";
-                continue;
-            }
+            continue;
+        }
 
-            // Don't consider center positions too close to a base
-            if (minDist < 2000)
-            {
-                debug << "rejecting for center, too close to a base";
-                continue;
-            }
+        Log().Debug() << "Erased block @ " << block.Location() << " to make room for a proxy block";
+        bwebMap.eraseBlock(block.Location());
 
-            // On 4+ player maps where the center isn't buildable, prefer locations closest to our main
-            if (enemyStartLocations.size() >= 3 && minDist < ((double)maxDist * 0.75))
-            {
-                int distToOurMain = PathFinding::GetGroundDistance(blockCenter, mainPosition, BWAPI::UnitTypes::Protoss_Probe, PathFinding::PathFindingOptions::UseNearestBWEMArea);
-                if (distToOurMain > minDist)
-                {
-                    debug << "rejecting for center, large variance and too far from our main";
-                    continue;
-                }
-            }
+        auto update = [i](int & index) { if (index > i) index--; };
+        update(_hiddenTechBlock);
+        update(_centerProxyBlock);
+        update(_proxyBlock);
+        for (auto & baseBlock : _baseProxyBlocks)
+            update(baseBlock.second);
+    }
+}
 
-            // Update overall best if appropriate
-            if (maxDist < overallDistBest)
-            {
-                debug << "(best center)";
-                overallDistBest = maxDist;
-                overallTileBest = tile;
-            }
+bool BuildingPlacer::isProxyBlock(int index) const
+{
+    if (index == -1) return false;
+    if (index == _centerProxyBlock) return true;
 
-        nextTile:;
-        }
+    for (const auto & baseBlock : _baseProxyBlocks)
+        if (index == baseBlock.second) return true;
 
-    // Add the blocks
-    _centerProxyBlock = addProxyBlock(overallTileBest, unbuildableTiles);
-    for (auto base : enemyStartLocations)
-    {
-        // Map-specific tweak: on Heartbreak Ridge units somewhat randomly take the top or bottom paths around the middle base
-        // So here we manually fix one base location that otherwise puts the proxy in an easy-to-discover location
-        // TODO: Find a more elegant way to deal with this
-        if (BWAPI::Broodwar->mapHash() == "6f8da3c3cc8d08d9cf882700efa049280aedca8c" &&
-            base->getTilePosition() == BWAPI::TilePosition(117, 56))
-        {
-            tileBest[base] = BWAPI::TilePosition(76, 2);
-        }
+    return false;
+}
 
-        _baseProxyBlocks[base] = addProxyBlock(tileBest[base], unbuildableTiles);
-    }
+// Starts the search for proxy blocks, which update() carries out, if it isn't started yet.
+// The proxy blocks are only wanted when we proxy, and by then we may know where the enemy base is.
+void BuildingPlacer::findProxyBlocks()
+{
+    if (_proxyBlocksFound || _proxyBlockSearch) return;
 
-    Log().Debug() << debug.str();
+    _proxyBlockSearch.reset(new ProxyBlockSearch());
 }
 
 BWAPI::TilePosition buildLocationInBlock(BWAPI::UnitType type, const BWEB::Block & block)
@@ -824,6 +1210,10 @@ BWAPI::TilePosition BuildingPlacer::placeBuildingBWEB(BWAPI::UnitType type, BWAP
         // Set the proxy block if it is not already
         if (_proxyBlock == -1)
         {
+            // We need the proxy blocks now, so finish finding them if update() hasn't yet
+            findProxyBlocks();
+            runProxyBlockSearch(std::chrono::steady_clock::time_point::max());
+
             // If we know the enemy start location, attempt to use it
             auto enemyMain = InformationManager::Instance().getEnemyMainBaseLocation();
             if (enemyMain)
@@ -840,10 +1230,14 @@ BWAPI::TilePosition BuildingPlacer::placeBuildingBWEB(BWAPI::UnitType type, BWAP
         }
     }
 
-    if (macroLocation == MacroLocation::HiddenTech && _hiddenTechBlock != -1)
+    if (macroLocation == MacroLocation::HiddenTech)
     {
-        auto location = buildLocationInBlock(type, bwebMap.Blocks()[_hiddenTechBlock]);
-        if (location.isValid()) return location;
+        runHiddenTechBlockSearch(std::chrono::steady_clock::time_point::max());
+        if (_hiddenTechBlock != -1)
+        {
+            auto location = buildLocationInBlock(type, bwebMap.Blocks()[_hiddenTechBlock]);
+            if (location.isValid()) return location;
+        }
     }
 
 	if (type == BWAPI::UnitTypes::Protoss_Pylon)
@@ -852,6 +1246,9 @@ BWAPI::TilePosition BuildingPlacer::placeBuildingBWEB(BWAPI::UnitType type, BWAP
 		if (bwebMap.isPlaceable(BWAPI::UnitTypes::Protoss_Pylon, bwebMap.startBlockPylon))
 			return bwebMap.startBlockPylon;
 
+        // The rest needs the blocks, so finish finding them if update() hasn't yet
+        runBlockSearches(std::chrono::steady_clock::time_point::max());
+
         // If we have an active proxy, build the pylon as far away from the main choke as possible
         if (StrategyManager::Instance().isProxying() &&
             macroLocation == MacroLocation::Anywhere && bwebMap.mainArea && bwebMap.mainChoke)
@@ -1027,6 +1424,7 @@ BWAPI::TilePosition BuildingPlacer::placeBuildingBWEB(BWAPI::UnitType type, BWAP
         return BWAPI::TilePositions::Invalid;
 	}
 
+	runBlockSearches(std::chrono::steady_clock::time_point::max());
 	return bwebMap.getBuildPosition(type, closeTo);
 }
 
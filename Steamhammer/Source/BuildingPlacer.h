@@ -6,6 +6,10 @@
 #include "InformationManager.h"
 #include "BuildOrder.h"
 #include "LocutusWall.h"
+#include "SummedAreaTable.h"
+
+#include <chrono>
+#include <memory>
 
 namespace UAlbertaBot
 {
@@ -13,8 +17,13 @@ namespace UAlbertaBot
 class BuildingPlacer
 {
     BuildingPlacer();
+    ~BuildingPlacer();
 
-    std::vector< std::vector<bool> > _reserveMap;
+    // Footprint checks count tiles in these, so they take a few lookups however large the footprint is
+    SummedAreaTable     _reserved;              // Tiles reserved for buildings we are placing
+    SummedAreaTable     _unbuildable;           // Tiles the map doesn't allow buildings on
+    SummedAreaTable     _resourceBoxTiles;      // Tiles in the resource box of our main base
+    SummedAreaTable     _baseLocationTiles;     // Tiles a building must not touch, see tileOverlapsBaseLocation
 
     int     _boxTop;
     int	    _boxBottom;
@@ -28,6 +37,28 @@ class BuildingPlacer
     int                 _centerProxyBlock;      // Proxy block suitable for when we don't know the enemy base
     int                 _proxyBlock;            // Chosen proxy block
 
+    // The block searches are spread over the early frames, see update()
+    struct BlockSearch;
+    struct HiddenTechBlockSearch;
+    struct ProxyBlockSearch;
+    std::unique_ptr<HiddenTechBlockSearch>  _hiddenTechBlockSearch;     // null when not started or done
+    std::unique_ptr<ProxyBlockSearch>       _proxyBlockSearch;          // null when not started or done
+    bool                _proxyBlocksFound;
+    std::string         _layoutFile;            // where to save the layout when the searches are done, empty if it came from there
+    std::vector<std::string> _layoutOverlap;    // the overlap layer before the block searches, a string of 0 and 1 per row
+
+    bool                runHiddenTechBlockSearch(std::chrono::steady_clock::time_point deadline);
+    bool                runBlockSearches(std::chrono::steady_clock::time_point deadline);
+    bool                runProxyBlockSearch(std::chrono::steady_clock::time_point deadline);
+    void                addHiddenTechBlock(BWAPI::TilePosition tile);
+    void                addProxyBlocks(const ProxyBlockSearch & search);
+    int                 addProxyBlock(BWAPI::TilePosition tile, const std::set<BWAPI::TilePosition> & unbuildableTiles);
+    void                eraseBlocksOverlapping(BWAPI::TilePosition tile, int width, int height);
+    bool                isProxyBlock(int index) const;
+
+    bool                loadBWEBLayout(const std::string & fileName);
+    void                saveBWEBLayout(const std::string & fileName) const;
+
 public:
 
     static BuildingPlacer & Instance();
@@ -56,7 +87,7 @@ public:
 
 	// BWEB-related stuff
 	void				initializeBWEB();
-    void                findHiddenTechBlock();
+    void                update();
     void                findProxyBlocks();
 	BWAPI::TilePosition placeBuildingBWEB(BWAPI::UnitType type, BWAPI::TilePosition closeTo, MacroLocation macroLocation);
 	void				reserveWall(const BuildOrder & buildOrder);
@@ -0,0 +1,302 @@
+#include "Common.h"
+#include "ClearanceMap.h"
+
+namespace { auto & bwemMap = BWEM::Map::Instance(); }
+
+using namespace UAlbertaBot;
+
+namespace
+{
+    // Neighbour table: the four straight directions first, then the diagonals
+    const int NeighbourCount = 8;
+    const int neighbourX[NeighbourCount] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+    const int neighbourY[NeighbourCount] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+    const int neighbourCost[NeighbourCount] = { 10, 10, 10, 10, 14, 14, 14, 14 };
+
+    // The open list is a ring of buckets indexed by estimated total cost.
+    // With a consistent heuristic, a step raises the estimate by at most twice the step cost,
+    // so all open entries fit in a ring larger than 2 * 14.
+    const int BucketCount = 32;
+
+    // Octile distance in the same units as neighbourCost
+    inline int heuristic(int x, int y, const BWAPI::WalkPosition & goal)
+    {
+        int dx = std::abs(x - goal.x);
+        int dy = std::abs(y - goal.y);
+        return 10 * std::max(dx, dy) + 4 * std::min(dx, dy);
+    }
+
+    inline BWAPI::Position center(const BWAPI::WalkPosition & walk)
+    {
+        return BWAPI::Position(walk) + BWAPI::Position(4, 4);
+    }
+}
+
+ClearanceMap::ClearanceMap()
+    : _width(0)
+    , _height(0)
+    , _generation(0)
+{
+}
+
+ClearanceMap & ClearanceMap::Instance()
+{
+    static ClearanceMap instance;
+    return instance;
+}
+
+void ClearanceMap::initialize()
+{
+    _width = BWAPI::Broodwar->mapWidth() * 4;
+    _height = BWAPI::Broodwar->mapHeight() * 4;
+
+    _clearance.assign(_width * _height, 0);
+    compute(0, 0, _width, _height);
+
+    _cost.assign(_width * _height, 0);
+    _parent.assign(_width * _height, 0);
+    _visited.assign(_width * _height, 0);
+    _generation = 0;
+}
+
+// Clearance is capped at 255 pixels and a walk tile step is at least 8 pixels,
+// so only walk tiles less than 32 steps from the neutral can change.
+void ClearanceMap::onNeutralDestroyed(BWAPI::Unit unit)
+{
+    const int padding = 32;
+
+    BWAPI::WalkPosition topLeft(unit->getInitialTilePosition());
+    BWAPI::WalkPosition size(BWAPI::TilePosition(unit->getType().tileWidth(), unit->getType().tileHeight()));
+    compute(topLeft.x - padding, topLeft.y - padding, topLeft.x + size.x + padding, topLeft.y + size.y + padding);
+}
+
+void ClearanceMap::compute(int left, int top, int right, int bottom)
+{
+    left = std::max(0, left);
+    top = std::max(0, top);
+    right = std::min(_width, right);
+    bottom = std::min(_height, bottom);
+
+    // Seed with the BWEM altitude, which is the exact distance to the nearest sea walk tile
+    for (int y = top; y < bottom; y++)
+        for (int x = left; x < right; x++)
+        {
+            auto & miniTile = bwemMap.GetMiniTile(BWAPI::WalkPosition(x, y));
+            _clearance[index(x, y)] = miniTile.Walkable() ? (unsigned char)std::min(255, (int)miniTile.Altitude()) : 0;
+        }
+
+    // Block the walk tiles under static neutrals
+    auto block = [&](const BWEM::Neutral * neutral)
+    {
+        BWAPI::WalkPosition topLeft(neutral->TopLeft());
+        BWAPI::WalkPosition size(neutral->Size());
+        for (int y = std::max(top, topLeft.y); y < std::min(bottom, topLeft.y + size.y); y++)
+            for (int x = std::max(left, topLeft.x); x < std::min(right, topLeft.x + size.x); x++)
+                _clearance[index(x, y)] = 0;
+    };
+    for (auto & mineral : bwemMap.Minerals()) block(mineral.get());
+    for (auto & building : bwemMap.StaticBuildings()) block(building.get());
+
+    // Lakes and neutrals don't affect the altitude, so propagate distances from them with a two-pass chamfer transform
+    // Straight steps are 8 pixels and diagonal steps 11, which is close enough at these distances
+    // Walk tiles just outside the rectangle are already right, and are read but not changed
+    auto relax = [this](int x, int y, int dx, int dy, int cost)
+    {
+        if (!inBounds(x + dx, y + dy)) return;
+        int candidate = _clearance[index(x + dx, y + dy)] + cost;
+        if (candidate < _clearance[index(x, y)])
+            _clearance[index(x, y)] = (unsigned char)candidate;
+    };
+
+    for (int y = top; y < bottom; y++)
+        for (int x = left; x < right; x++)
+        {
+            relax(x, y, -1, 0, 8);
+            relax(x, y, 0, -1, 8);
+            relax(x, y, -1, -1, 11);
+            relax(x, y, 1, -1, 11);
+        }
+
+    for (int y = bottom - 1; y >= top; y--)
+        for (int x = right - 1; x >= left; x--)
+        {
+            relax(x, y, 1, 0, 8);
+            relax(x, y, 0, 1, 8);
+            relax(x, y, 1, 1, 11);
+            relax(x, y, -1, 1, 11);
+        }
+}
+
+int ClearanceMap::getClearance(BWAPI::WalkPosition pos) const
+{
+    if (!inBounds(pos.x, pos.y)) return 0;
+    return _clearance[index(pos.x, pos.y)];
+}
+
+int ClearanceMap::requiredClearance(BWAPI::UnitType type)
+{
+    // BWEM treats walk tiles next to unwalkable ones as unwalkable, so measuring from walk tile centers
+    // underestimates the real room by about half a walk tile
+    return std::max(8, std::max(type.width(), type.height()) / 2 - 4);
+}
+
+bool ClearanceMap::isWalkable(BWAPI::UnitType type, BWAPI::Position center) const
+{
+    if (!center.isValid()) return false;
+
+    int left = type.dimensionLeft();
+    int right = type.dimensionRight();
+    int up = type.dimensionUp();
+    int down = type.dimensionDown();
+
+    // If nothing is blocked within reach of the bounding box corners, the unit fits.
+    // The position can be 6 pixels from its walk tile center, and blocked walk tiles reach 6 pixels from theirs.
+    int radius = (int)std::ceil(std::sqrt(std::pow(std::max(left, right), 2) + std::pow(std::max(up, down), 2)));
+    if (getClearance(BWAPI::WalkPosition(center)) > radius + 12) return true;
+
+    // Otherwise check each walk tile the bounding box touches
+    for (int x = (center.x - left) / 8; x <= (center.x + right) / 8; x++)
+        for (int y = (center.y - up) / 8; y <= (center.y + down) / 8; y++)
+            if (!BWAPI::Broodwar->isWalkable(x, y))
+                return false;
+
+    return true;
+}
+
+bool ClearanceMap::isLineClear(BWAPI::Position start, BWAPI::Position end, BWAPI::UnitType type) const
+{
+    int required = requiredClearance(type);
+
+    int dx = end.x - start.x;
+    int dy = end.y - start.y;
+    int steps = std::max(std::abs(dx), std::abs(dy)) / 8 + 1;
+    for (int i = 0; i <= steps; i++)
+    {
+        BWAPI::Position current(start.x + (dx * i) / steps, start.y + (dy * i) / steps);
+        if (getClearance(BWAPI::WalkPosition(current)) < required) return false;
+    }
+
+    return true;
+}
+
+// A* over walk tiles that have enough clearance for the unit, using a bucketed open list.
+std::vector<BWAPI::Position> ClearanceMap::findPath(
+    BWAPI::Position start,
+    BWAPI::Position end,
+    BWAPI::UnitType type,
+    int maxNodes) const
+{
+    std::vector<BWAPI::Position> result;
+
+    int required = requiredClearance(type);
+    BWAPI::WalkPosition startWalk(start);
+    BWAPI::WalkPosition endWalk(end);
+    if (getClearance(startWalk) < required || getClearance(endWalk) < required) return result;
+
+    if (startWalk == endWalk)
+    {
+        result.push_back(end);
+        return result;
+    }
+
+    // Start a new search generation instead of clearing the scratch space
+    if (++_generation == 0)
+    {
+        std::fill(_visited.begin(), _visited.end(), 0);
+        _generation = 1;
+    }
+
+    std::vector<std::vector<int>> buckets(BucketCount);
+    auto push = [&](int x, int y, int cost, int direction)
+    {
+        int i = index(x, y);
+        _visited[i] = _generation;
+        _cost[i] = cost;
+        _parent[i] = (unsigned char)direction;
+        buckets[(cost + heuristic(x, y, endWalk)) % BucketCount].push_back(i);
+    };
+
+    int goal = index(endWalk.x, endWalk.y);
+    int currentEstimate = heuristic(startWalk.x, startWalk.y, endWalk);
+    int queued = 1;
+    int expanded = 0;
+    bool found = false;
+    push(startWalk.x, startWalk.y, 0, NeighbourCount);
+
+    while (queued > 0)
+    {
+        auto & bucket = buckets[currentEstimate % BucketCount];
+        if (bucket.empty())
+        {
+            currentEstimate++;
+            continue;
+        }
+
+        int current = bucket.back();
+        bucket.pop_back();
+        queued--;
+
+        int x = current % _width;
+        int y = current / _width;
+
+        // Skip entries that were superseded by a cheaper path
+        if (_cost[current] + heuristic(x, y, endWalk) != currentEstimate) continue;
+
+        if (current == goal)
+        {
+            found = true;
+            break;
+        }
+
+        if (++expanded > maxNodes) return result;
+
+        for (int d = 0; d < NeighbourCount; d++)
+        {
+            int nextX = x + neighbourX[d];
+            int nextY = y + neighbourY[d];
+            if (!inBounds(nextX, nextY)) continue;
+            if (_clearance[index(nextX, nextY)] < required) continue;
+
+            // Don't cut corners
+            if (d >= 4 &&
+                (_clearance[index(nextX, y)] < required || _clearance[index(x, nextY)] < required))
+            {
+                continue;
+            }
+
+            int cost = _cost[current] + neighbourCost[d];
+            int next = index(nextX, nextY);
+            if (_visited[next] == _generation && _cost[next] <= cost) continue;
+
+            push(nextX, nextY, cost, d);
+            queued++;
+        }
+    }
+
+    if (!found) return result;
+
+    // Walk back from the goal to get the walk tiles on the path
+    std::vector<BWAPI::Position> tiles;
+    for (int current = goal; _parent[current] != NeighbourCount; )
+    {
+        int x = current % _width;
+        int y = current / _width;
+        tiles.push_back(center(BWAPI::WalkPosition(x, y)));
+
+        int d = _parent[current];
+        current = index(x - neighbourX[d], y - neighbourY[d]);
+    }
+    std::reverse(tiles.begin(), tiles.end());
+
+    // Reduce it to the turning points by skipping over tiles we can reach in a straight line
+    BWAPI::Position anchor = start;
+    for (size_t i = 0; i < tiles.size(); i++)
+    {
+        while (i + 1 < tiles.size() && isLineClear(anchor, tiles[i + 1], type)) i++;
+
+        anchor = tiles[i];
+        result.push_back(i + 1 == tiles.size() ? end : anchor);
+    }
+
+    return result;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Common.h"
+
+namespace UAlbertaBot
+{
+
+// Clearance of every 8x8 walk tile: the distance in pixels to the nearest tile a ground unit can't stand on.
+// Seeded from the BWEM MiniTile altitude, which only measures the distance to sea, and tightened
+// for lakes and the static neutrals BWEM still knows about.
+// Used to check whether units of a given size fit somewhere, and to find walk-resolution paths they fit through.
+class ClearanceMap
+{
+    int                             _width;         // in walk tiles
+    int                             _height;
+
+    std::vector<unsigned char>      _clearance;     // pixels, capped at 255; 0 means blocked
+
+    // Search scratch space, reused between searches
+    mutable std::vector<int>            _cost;
+    mutable std::vector<unsigned char>  _parent;
+    mutable std::vector<unsigned int>   _visited;   // search generation that last touched each walk tile
+    mutable unsigned int                _generation;
+
+    ClearanceMap();
+
+    int  index(int x, int y) const { return y * _width + x; };
+    bool inBounds(int x, int y) const { return x >= 0 && y >= 0 && x < _width && y < _height; };
+
+    // Computes the clearance of the walk tiles in the rectangle, right and bottom exclusive.
+    // The clearance outside the rectangle must already be right.
+    void compute(int left, int top, int right, int bottom);
+
+public:
+
+    static ClearanceMap & Instance();
+
+    // Computes the clearance of the whole map. Call once, after the BWEM analysis.
+    void initialize();
+
+    // Updates the clearance around a destroyed mineral or static building, after BWEM has been told about it
+    void onNeutralDestroyed(BWAPI::Unit unit);
+
+    int getClearance(BWAPI::WalkPosition pos) const;
+
+    // The clearance a unit of the given type needs to stand on a walk tile
+    static int requiredClearance(BWAPI::UnitType type);
+
+    // Whether a unit of the given type fits at the given position considering terrain only.
+    // Same result as checking every pixel of the unit's bounding box, but usually decided with one lookup.
+    bool isWalkable(BWAPI::UnitType type, BWAPI::Position center) const;
+
+    // Whether a unit of the given type can walk in a straight line between the two positions
+    bool isLineClear(BWAPI::Position start, BWAPI::Position end, BWAPI::UnitType type) const;
+
+    // Finds a path between the two positions that a unit of the given type fits through.
+    // The path is returned as a list of turning points, excluding the start and including the end.
+    // Returns an empty path if there is none or the search gives up after expanding maxNodes walk tiles.
+    std::vector<BWAPI::Position> findPath(
+        BWAPI::Position start,
+        BWAPI::Position end,
+        BWAPI::UnitType type,
+        int maxNodes = 50000) const;
+};
+
+}
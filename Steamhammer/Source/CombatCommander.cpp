@@ -39,6 +39,7 @@ CombatCommander::CombatCommander()
 	, _goAggressiveAt(-1)
 	, _reconTarget(BWAPI::Positions::Invalid)   // it will be changed later
 	, _lastReconTargetChange(0)
+	, _reconBaseDistancesFrom(BWAPI::Positions::Invalid)
 	, _enemyWorkerAttackedAt(0)
 {
 }
@@ -749,13 +750,29 @@ BWAPI::Position CombatCommander::getReconLocation() const
         }
     }
 
+    // The distances we have are from our old main
+    if (mainPosition != _reconBaseDistancesFrom)
+    {
+        _reconBaseDistances.clear();
+        _reconBaseDistancesFrom = mainPosition;
+    }
+
     // Score based on two factors: proximity to any known enemy base and time since we've last scouted it
     BWTA::BaseLocation * bestBase = nullptr;
     double bestScore = 0.0;
 	for (BWTA::BaseLocation * base : BWTA::getBaseLocations())
 	{
         if (InformationManager::Instance().getBaseOwner(base) != BWAPI::Broodwar->neutral()) continue; // not neutral
-        if (MapTools::Instance().getGroundTileDistance(base->getPosition(), mainPosition) == -1) continue; // not reachable by ground
+
+        // not reachable by ground
+        // This is computed in the background, so we skip the base until the result is in
+        auto distanceIt = _reconBaseDistances.find(base);
+        if (distanceIt == _reconBaseDistances.end())
+        {
+            _reconBaseDistances[base] = PathService::Instance().getGroundTileDistance(base->getPosition(), mainPosition);
+            continue;
+        }
+        if (!distanceIt->second.isReady() || distanceIt->second.get().length == -1) continue;
 
         // already on route being taken by the ground squad
         auto area = bwemMap.GetArea(base->getTilePosition());
@@ -4,6 +4,7 @@
 #include "Squad.h"
 #include "SquadData.h"
 #include "InformationManager.h"
+#include "PathService.h"
 #include "StrategyManager.h"
 #include "UnitUtil.h"
 
@@ -21,6 +22,11 @@ class CombatCommander
 	BWAPI::Position	_reconTarget;
 	int				_lastReconTargetChange;         // frame number
 
+    // Ground distances from our main to each base, computed in the background for recon target selection
+    // They are thrown away if our main moves.
+    mutable std::map<BWTA::BaseLocation *, PathHandle> _reconBaseDistances;
+    mutable BWAPI::Position _reconBaseDistancesFrom;
+
 	int			    _enemyWorkerAttackedAt;
 
     void            updateBlockScoutingSquad();
@@ -112,7 +112,11 @@ namespace Config
 
     namespace Macro
     {
-        int BOSSFrameLimit                  = 160;
+        int BOSSTimeLimit                   = 6700;     // milliseconds of wall clock time a build order search may take on its thread
+        int BOSSSearchThreads               = 1;        // threads for the build order search, 1 for the background search thread alone
+        int BOSSAcceptableGap               = 24;       // frames a build order may be from provably optimal for the search to stop early
+        int BOSSRepairGoalDelta             = 2;        // goal units a new goal may differ by from the last for the repaired last build order to do without a search
+        int BlockSearchFrameBudget          = 5;        // milliseconds per frame for the BWEB block searches that startup leaves
         int WorkersPerRefinery              = 3;
 		double WorkersPerPatch              = 3.0;
 		int AbsoluteMaxWorkers				= 75;
@@ -125,5 +129,7 @@ namespace Config
     namespace Tools								
     {
         extern int MAP_GRID_SIZE            = 320;      // size of grid spacing in MapGrid
+        int PathServiceThreads              = 1;        // background threads for non-urgent path requests, 0 to run them on the frame thread
+        bool DumpMap                        = false;    // write the map to the write directory for the offline map analysis tool
     }
 }
\ No newline at end of file
@@ -106,7 +106,11 @@ namespace Config
     
     namespace Macro
     {
-        extern int BOSSFrameLimit;
+        extern int BOSSTimeLimit;
+        extern int BOSSSearchThreads;
+        extern int BOSSAcceptableGap;
+        extern int BOSSRepairGoalDelta;
+        extern int BlockSearchFrameBudget;
         extern int WorkersPerRefinery;
 		extern double WorkersPerPatch;
 		extern int AbsoluteMaxWorkers;
@@ -119,5 +123,7 @@ namespace Config
     namespace Tools
     {
         extern int MAP_GRID_SIZE;
+        extern int PathServiceThreads;
+        extern bool DumpMap;
     }
 }
\ No newline at end of file
@@ -0,0 +1,266 @@
+#include "Common.h"
+#include "FlowField.h"
+#include "ClearanceMap.h"
+#include "MapTools.h"
+#include "PathFinding.h"
+
+#include <queue>
+
+namespace { auto & bwemMap = BWEM::Map::Instance(); }
+namespace { auto & bwebMap = BWEB::Map::Instance(); }
+
+using namespace UAlbertaBot;
+
+// Neighbour table: the four straight directions first, then the diagonals
+const int NeighbourCount = 8;
+const int neighbourX[NeighbourCount] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+const int neighbourY[NeighbourCount] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+const int neighbourCost[NeighbourCount] = { 10, 10, 10, 10, 14, 14, 14, 14 };
+const unsigned char NoDirection = NeighbourCount;
+
+const unsigned short FlowField::Unreachable;
+
+// The neighbour table entry that points back in the opposite direction
+inline int reverseDirection(int d)
+{
+    for (int i = 0; i < NeighbourCount; i++)
+        if (neighbourX[i] == -neighbourX[d] && neighbourY[i] == -neighbourY[d])
+            return i;
+    return NoDirection;
+}
+
+FlowField::FlowField(BWAPI::TilePosition target, const std::set<const BWEM::Area *> & areas, BWAPI::UnitType type)
+    : _target(target)
+    , _areas(areas)
+    , _unitSize(FlowFields::sizeClass(type))
+    , _frameComputed(BWAPI::Broodwar->getFrameCount())
+    , _topLeft(target)
+    , _width(1)
+    , _height(1)
+{
+    // Compute the bounding box of all of the areas
+    BWAPI::TilePosition bottomRight(target);
+    for (const BWEM::Area * area : _areas)
+    {
+        _topLeft.x = std::min(_topLeft.x, area->TopLeft().x);
+        _topLeft.y = std::min(_topLeft.y, area->TopLeft().y);
+        bottomRight.x = std::max(bottomRight.x, area->BottomRight().x);
+        bottomRight.y = std::max(bottomRight.y, area->BottomRight().y);
+    }
+
+    _width = bottomRight.x - _topLeft.x + 1;
+    _height = bottomRight.y - _topLeft.y + 1;
+
+    computePassable(type);
+    compute();
+    _passable.clear();
+    _passable.shrink_to_fit();
+}
+
+bool FlowField::inBounds(BWAPI::TilePosition tile) const
+{
+    return tile.x >= _topLeft.x && tile.y >= _topLeft.y &&
+        tile.x < _topLeft.x + _width && tile.y < _topLeft.y + _height;
+}
+
+void FlowField::computePassable(BWAPI::UnitType type)
+{
+    _passable.assign(_width * _height, false);
+
+    int clearance = ClearanceMap::requiredClearance(type);
+    for (int y = _topLeft.y; y < _topLeft.y + _height; y++)
+        for (int x = _topLeft.x; x < _topLeft.x + _width; x++)
+        {
+            BWAPI::TilePosition tile(x, y);
+            if (!tile.isValid()) continue;
+            if (!MapTools::Instance().isWalkable(tile)) continue;
+            if (bwebMap.occupancy.test(BWEB::Layers::Used, tile)) continue;
+
+            // Tiles belonging to an area we don't cover are excluded
+            // Tiles that straddle areas (mostly at chokes) don't have an area and are allowed
+            auto area = bwemMap.GetArea(tile);
+            if (area && !covers(area)) continue;
+
+            // The unit must fit on some part of the tile
+            bool fits = false;
+            for (int walkY = 4 * y; walkY < 4 * y + 4 && !fits; walkY++)
+                for (int walkX = 4 * x; walkX < 4 * x + 4 && !fits; walkX++)
+                    fits = ClearanceMap::Instance().getClearance(BWAPI::WalkPosition(walkX, walkY)) >= clearance;
+            if (!fits) continue;
+
+            _passable[index(tile)] = true;
+        }
+
+    // Close the chokes the unit doesn't fit through
+    for (const BWEM::Area * area : _areas)
+        for (const BWEM::ChokePoint * choke : area->ChokePoints())
+        {
+            if (((ChokeData*)choke->Ext())->width >= _unitSize) continue;
+
+            for (const auto & walk : choke->Geometry())
+            {
+                BWAPI::TilePosition tile(walk);
+                if (inBounds(tile)) _passable[index(tile)] = false;
+            }
+        }
+}
+
+// Dijkstra from the target outwards, recording for each tile the neighbour it was reached from.
+// Diagonal steps are only allowed if both adjacent straight tiles are passable, so units don't cut corners.
+void FlowField::compute()
+{
+    _cost.assign(_width * _height, Unreachable);
+    _direction.assign(_width * _height, NoDirection);
+
+    if (!isPassable(_target)) return;
+
+    typedef std::pair<int, BWAPI::TilePosition> QueueEntry;
+    auto cmp = [](const QueueEntry & left, const QueueEntry & right) { return left.first > right.first; };
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, decltype(cmp)> queue(cmp);
+
+    _cost[index(_target)] = 0;
+    queue.emplace(0, _target);
+
+    while (!queue.empty())
+    {
+        auto const current = queue.top();
+        queue.pop();
+
+        // Skip stale entries
+        if (current.first > _cost[index(current.second)]) continue;
+
+        for (int d = 0; d < NeighbourCount; d++)
+        {
+            BWAPI::TilePosition next(current.second.x + neighbourX[d], current.second.y + neighbourY[d]);
+            if (!isPassable(next)) continue;
+
+            if (neighbourX[d] != 0 && neighbourY[d] != 0 &&
+                (!isPassable(BWAPI::TilePosition(next.x, current.second.y)) ||
+                 !isPassable(BWAPI::TilePosition(current.second.x, next.y))))
+            {
+                continue;
+            }
+
+            int cost = std::min(current.first + neighbourCost[d], Unreachable - 1);
+            if (cost >= _cost[index(next)]) continue;
+
+            _cost[index(next)] = cost;
+            _direction[index(next)] = reverseDirection(d);
+            queue.emplace(cost, next);
+        }
+    }
+}
+
+bool FlowField::isReachable(BWAPI::TilePosition tile) const
+{
+    return inBounds(tile) && _cost[index(tile)] != Unreachable;
+}
+
+int FlowField::getDistance(BWAPI::Position position) const
+{
+    BWAPI::TilePosition tile(position);
+    if (!isReachable(tile)) return -1;
+
+    // Costs are in tenths of a tile
+    return (_cost[index(tile)] * 32) / 10;
+}
+
+BWAPI::Position FlowField::getNextPosition(BWAPI::Position position, int lookaheadTiles) const
+{
+    BWAPI::TilePosition tile(position);
+
+    // If the unit is on a tile not in the field, for example partly on unwalkable terrain,
+    // start from the best reachable neighbour instead
+    if (!isReachable(tile))
+    {
+        BWAPI::TilePosition best = BWAPI::TilePositions::Invalid;
+        for (int d = 0; d < NeighbourCount; d++)
+        {
+            BWAPI::TilePosition next(tile.x + neighbourX[d], tile.y + neighbourY[d]);
+            if (isReachable(next) && (!best.isValid() || _cost[index(next)] < _cost[index(best)]))
+                best = next;
+        }
+
+        if (!best.isValid()) return BWAPI::Positions::Invalid;
+        tile = best;
+    }
+
+    for (int i = 0; i < lookaheadTiles && tile != _target; i++)
+    {
+        unsigned char d = _direction[index(tile)];
+        if (d == NoDirection) break;
+        tile = BWAPI::TilePosition(tile.x + neighbourX[d], tile.y + neighbourY[d]);
+    }
+
+    return BWAPI::Position(tile) + BWAPI::Position(16, 16);
+}
+
+FlowFields & FlowFields::Instance()
+{
+    static FlowFields instance;
+    return instance;
+}
+
+std::shared_ptr<const FlowField> FlowFields::get(BWAPI::Position start, BWAPI::Position target, BWAPI::UnitType type)
+{
+    auto startArea = bwemMap.GetNearestArea(BWAPI::WalkPosition(start));
+    auto targetArea = bwemMap.GetNearestArea(BWAPI::WalkPosition(target));
+    if (!startArea || !targetArea) return nullptr;
+
+    // Seed the field from a passable tile near the target, since the target itself may be a building
+    BWAPI::TilePosition targetTile(target);
+    if (!targetTile.isValid()) return nullptr;
+    if (!MapTools::Instance().isWalkable(targetTile) || bwebMap.occupancy.test(BWEB::Layers::Used, targetTile))
+    {
+        targetTile = PathFinding::NearbyPathfindingTile(targetTile);
+        if (!targetTile.isValid()) return nullptr;
+    }
+
+    // Reuse an existing field for units of this size if it is recent enough and already covers the start area
+    auto key = std::make_pair(targetTile, sizeClass(type));
+    std::set<const BWEM::Area *> areas;
+    auto it = _fields.find(key);
+    if (it != _fields.end())
+    {
+        if (BWAPI::Broodwar->getFrameCount() - it->second->getFrameComputed() > maxAgeFrames)
+        {
+            _fields.erase(it);
+        }
+        else
+        {
+            if (it->second->covers(startArea) && it->second->getNextPosition(start).isValid())
+                return it->second;
+
+            // Otherwise we will extend it with the areas on this unit's path
+            areas = it->second->getAreas();
+        }
+    }
+
+    // Collect the areas along the chokepoint path
+    areas.insert(startArea);
+    areas.insert(targetArea);
+    if (startArea != targetArea)
+    {
+        auto path = PathFinding::GetChokePointPath(start, target, type, PathFinding::PathFindingOptions::UseNearestBWEMArea);
+        if (path.empty()) return nullptr;
+
+        for (const BWEM::ChokePoint * choke : path)
+        {
+            // The flow field has no way of expressing mineral walking
+            if (((ChokeData*)choke->Ext())->requiresMineralWalk) return nullptr;
+
+            areas.insert(choke->GetAreas().first);
+            areas.insert(choke->GetAreas().second);
+        }
+    }
+
+    // If we have too many fields, reset them in case we run out of memory
+    if (_fields.size() >= maxFields)
+    {
+        _fields.clear();
+    }
+
+    auto field = std::make_shared<const FlowField>(targetTile, areas, type);
+    _fields[key] = field;
+    return field;
+}
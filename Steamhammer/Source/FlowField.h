@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Common.h"
+
+#include <memory>
+
+namespace UAlbertaBot
+{
+
+// A flow field leading every reachable tile in a set of BWEM areas towards a single target tile,
+// for units up to a given size.
+// The integration field is computed once with 8-connected Dijkstra over walkable tiles, skipping
+// tiles BWEB has marked as used, tiles without the clearance the unit needs, and chokes narrower than the unit.
+// Afterwards each tile stores the direction of its cheapest neighbour,
+// so any number of units can sample their next move in constant time.
+class FlowField
+{
+    BWAPI::TilePosition                 _target;
+    std::set<const BWEM::Area *>        _areas;
+    int                                 _unitSize;      // pixels, see FlowFields::sizeClass
+    int                                 _frameComputed;
+
+    // The field only covers the bounding box of its areas
+    BWAPI::TilePosition                 _topLeft;
+    int                                 _width;
+    int                                 _height;
+
+    std::vector<unsigned short>         _cost;          // integrated cost to target, 10 per straight step, 14 per diagonal step
+    std::vector<unsigned char>          _direction;     // index into the neighbour table of the next tile towards the target
+    std::vector<bool>                   _passable;      // only used while computing
+
+    int  index(BWAPI::TilePosition tile) const { return (tile.y - _topLeft.y) * _width + (tile.x - _topLeft.x); };
+    bool inBounds(BWAPI::TilePosition tile) const;
+    bool isPassable(BWAPI::TilePosition tile) const { return inBounds(tile) && _passable[index(tile)]; };
+
+    void computePassable(BWAPI::UnitType type);
+    void compute();
+
+public:
+
+    static const unsigned short Unreachable = USHRT_MAX;
+
+    // The unit type gives the size of the units the field is for
+    FlowField(BWAPI::TilePosition target, const std::set<const BWEM::Area *> & areas, BWAPI::UnitType type);
+
+    const BWAPI::TilePosition &             getTarget() const { return _target; };
+    const std::set<const BWEM::Area *> &    getAreas() const { return _areas; };
+    int                                     getFrameComputed() const { return _frameComputed; };
+
+    bool covers(const BWEM::Area * area) const { return _areas.find(area) != _areas.end(); };
+    bool isReachable(BWAPI::TilePosition tile) const;
+
+    // Approximate ground distance in pixels from the given position to the target, or -1 if unreachable
+    int getDistance(BWAPI::Position position) const;
+
+    // Follows the field from the given position for up to the given number of tiles.
+    // Returns the center of the last tile reached, or Invalid if the position is not covered by the field.
+    BWAPI::Position getNextPosition(BWAPI::Position position, int lookaheadTiles = 4) const;
+};
+
+// Cache of flow fields keyed by target tile and unit size, shared by all units of that size moving to the same place.
+class FlowFields
+{
+    const size_t maxFields = 20;            // store this many flow fields
+    const int    maxAgeFrames = 24 * 60;    // rebuild fields older than this, since our buildings change what is passable
+
+    std::map<std::pair<BWAPI::TilePosition, int>, std::shared_ptr<const FlowField>> _fields;
+
+    FlowFields() {};
+
+public:
+
+    static FlowFields & Instance();
+
+    // Units with the same size class fit through the same places: the choke width checks use it,
+    // and so does ClearanceMap::requiredClearance
+    static int sizeClass(BWAPI::UnitType type) { return std::max(type.width(), type.height()); };
+
+    // Gets a flow field that leads a unit of the given type from the start position to the target.
+    // Returns nullptr if no field can be built, for example if the path requires mineral walking.
+    std::shared_ptr<const FlowField> get(BWAPI::Position start, BWAPI::Position target, BWAPI::UnitType type);
+
+    void clear() { _fields.clear(); };
+};
+
+}
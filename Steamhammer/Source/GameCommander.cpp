@@ -3,6 +3,7 @@
 #include "OpponentModel.h"
 #include "UnitUtil.h"
 #include "PathFinding.h"
+#include "PathService.h"
 
 using namespace UAlbertaBot;
 
@@ -63,12 +64,26 @@ void GameCommander::update()
 	MapGrid::Instance().update();
 	_timerManager.stopTimer(TimerManager::MapGrid);
 
+#ifdef CRASH_DEBUG
+	Log().Debug() << "PathService";
+#endif
+
+	// deliver background path results before anyone looks for them
+	PathService::Instance().update();
+
+#ifdef CRASH_DEBUG
+	Log().Debug() << "BuildingPlacer";
+#endif
+
+	// continue the block searches left from startup
+	BuildingPlacer::Instance().update();
+
 #ifdef CRASH_DEBUG
 	Log().Debug() << "BOSSManager";
 #endif
 
 	_timerManager.startTimer(TimerManager::Search);
-	BOSSManager::Instance().update(35 - _timerManager.getMilliseconds());
+	BOSSManager::Instance().update();
 	_timerManager.stopTimer(TimerManager::Search);
 
 #ifdef CRASH_DEBUG
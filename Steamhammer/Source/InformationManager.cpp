@@ -839,7 +839,7 @@ bool trace(BWAPI::TilePosition tile, BWAPI::TilePosition wallTile, int direction
         if (!bwebMap.isWalkable(next) || !bwebMap.isWalkable(nextWall)) return true;
 
         // If the next tile is occupied, we've hit a "concave" corner of the wall
-        if (bwebMap.usedTilesGrid[next.x][next.y])
+        if (bwebMap.occupancy.test(BWEB::Layers::Used, next))
         {
             nextWall = next;
             next = tile;
@@ -847,7 +847,7 @@ bool trace(BWAPI::TilePosition tile, BWAPI::TilePosition wallTile, int direction
         }
 
         // If the next wall tile is not occupied, we've hit a "convex" corner of the wall
-        if (!bwebMap.usedTilesGrid[nextWall.x][nextWall.y])
+        if (!bwebMap.occupancy.test(BWEB::Layers::Used, nextWall))
         {
             next = nextWall;
             nextWall = wallTile;
@@ -944,7 +944,7 @@ void InformationManager::detectEnemyWall(BWAPI::Unit unit)
             BWAPI::TilePosition last = BWAPI::TilePositions::Invalid;
             for (auto tile : path)
             {
-                if (!bwebMap.usedTilesGrid[tile.x][tile.y])
+                if (!bwebMap.occupancy.test(BWEB::Layers::Used, tile))
                 {
                     last = tile;
                     continue;
@@ -1651,16 +1651,7 @@ void InformationManager::onEnemyBuildingFlying(BWAPI::UnitType type, BWAPI::Posi
     BWAPI::TilePosition tile(lastPosition - BWAPI::Position(type.tileWidth() * 16 - 1, type.tileHeight() * 16 - 1));
 
     // Update BWEB
-    for (auto x = tile.x; x < tile.x + type.tileWidth(); x++)
-    {
-        for (auto y = tile.y; y < tile.y + type.tileHeight(); y++)
-        {
-            BWAPI::TilePosition t(x, y);
-            if (!t.isValid()) continue;
-            bwebMap.usedTiles.erase(t);
-            bwebMap.usedTilesGrid[x][y] = false;
-        }
-    }
+    bwebMap.occupancy.reset(BWEB::Layers::Used | BWEB::Layers::Planned, tile, type.tileWidth(), type.tileHeight());
 
     // The building might have been forming a wall
     detectBrokenEnemyWall(type, tile);
@@ -3,6 +3,7 @@
 #include "InformationManager.h"
 #include "Micro.h"
 #include "MapTools.h"
+#include "ClearanceMap.h"
 #include "PathFinding.h"
 
 const double pi = 3.14159265358979323846;
@@ -53,6 +54,8 @@ bool LocutusUnit::moveTo(BWAPI::Position position, bool avoidNarrowChokes)
 
     // Clear any existing waypoints
     waypoints.clear();
+    flowField.reset();
+    clearanceWaypoints.clear();
     targetPosition = BWAPI::Positions::Invalid;
     currentlyMovingTowards = BWAPI::Positions::Invalid;
     mineralWalkingPatch = nullptr;
@@ -63,10 +66,38 @@ bool LocutusUnit::moveTo(BWAPI::Position position, bool avoidNarrowChokes)
     auto targetArea = bwemMap.GetArea(BWAPI::WalkPosition(position));
     if (!targetArea || targetArea == bwemMap.GetArea(BWAPI::WalkPosition(unit->getPosition())))
     {
+        // Large units can get stuck on terrain within the area, so path them around anything in the way
+        if (targetArea &&
+            ClearanceMap::requiredClearance(unit->getType()) > 8 &&
+            !ClearanceMap::Instance().isLineClear(unit->getPosition(), position, unit->getType()))
+        {
+            auto path = ClearanceMap::Instance().findPath(unit->getPosition(), position, unit->getType(), 10000);
+            if (!path.empty())
+            {
+                clearanceWaypoints.assign(path.begin(), path.end());
+                targetPosition = position;
+                moveToNextClearanceWaypoint();
+                return true;
+            }
+        }
+
         Micro::Move(unit, position);
         return true;
     }
 
+    // Non-workers share a flow field with all other units moving to the same target
+    // Workers use choke waypoints, since they may need to mineral walk
+    if (!unit->getType().isWorker())
+    {
+        flowField = FlowFields::Instance().get(unit->getPosition(), position, unit->getType());
+        if (flowField)
+        {
+            targetPosition = position;
+            moveAlongFlowField();
+            return true;
+        }
+    }
+
     // Get the BWEM path
     // TODO: Consider narrow chokes
     auto& path = PathFinding::GetChokePointPath(
@@ -87,6 +118,45 @@ bool LocutusUnit::moveTo(BWAPI::Position position, bool avoidNarrowChokes)
 
 void LocutusUnit::updateMoveWaypoints() 
 {
+    if (flowField)
+    {
+        // If the unit command is no longer to move towards our current target, we have ordered the unit to do something else
+        BWAPI::UnitCommand currentCommand(unit->getLastCommand());
+        if (currentCommand.getType() != BWAPI::UnitCommandTypes::Move || currentCommand.getTargetPosition() != currentlyMovingTowards)
+        {
+            flowField.reset();
+            targetPosition = BWAPI::Positions::Invalid;
+            currentlyMovingTowards = BWAPI::Positions::Invalid;
+            return;
+        }
+
+        // Sample the field again when we get close to the position we are moving towards
+        if (unit->getDistance(currentlyMovingTowards) > 64) return;
+
+        moveAlongFlowField();
+        return;
+    }
+
+    if (!clearanceWaypoints.empty())
+    {
+        // If the unit command is no longer to move towards our current waypoint, we have ordered the unit to do something else
+        BWAPI::UnitCommand currentCommand(unit->getLastCommand());
+        if (currentCommand.getType() != BWAPI::UnitCommandTypes::Move || currentCommand.getTargetPosition() != currentlyMovingTowards)
+        {
+            clearanceWaypoints.clear();
+            targetPosition = BWAPI::Positions::Invalid;
+            currentlyMovingTowards = BWAPI::Positions::Invalid;
+            return;
+        }
+
+        // The last waypoint is the target itself, so there is nothing more to do once we are moving to it
+        if (clearanceWaypoints.size() == 1 || unit->getDistance(currentlyMovingTowards) > 32) return;
+
+        clearanceWaypoints.pop_front();
+        moveToNextClearanceWaypoint();
+        return;
+    }
+
     if (waypoints.empty())
     {
         if (BWAPI::Broodwar->getFrameCount() - lastMoveFrame > BWAPI::Broodwar->getLatencyFrames())
@@ -212,6 +282,33 @@ void LocutusUnit::moveToNextWaypoint()
     lastMoveFrame = BWAPI::Broodwar->getFrameCount();
 }
 
+void LocutusUnit::moveAlongFlowField()
+{
+    // Once we reach the target's area, or the field can't lead us any further, move to the target directly
+    // State will be reset after latency frames to avoid resetting the order later
+    BWAPI::Position next = flowField->getNextPosition(unit->getPosition());
+    if (!next.isValid() ||
+        next == BWAPI::Position(flowField->getTarget()) + BWAPI::Position(16, 16) ||
+        bwemMap.GetArea(BWAPI::WalkPosition(unit->getPosition())) == bwemMap.GetArea(BWAPI::WalkPosition(targetPosition)))
+    {
+        flowField.reset();
+        Micro::Move(unit, targetPosition);
+        lastMoveFrame = BWAPI::Broodwar->getFrameCount();
+        return;
+    }
+
+    currentlyMovingTowards = next;
+    Micro::Move(unit, currentlyMovingTowards);
+    lastMoveFrame = BWAPI::Broodwar->getFrameCount();
+}
+
+void LocutusUnit::moveToNextClearanceWaypoint()
+{
+    currentlyMovingTowards = clearanceWaypoints.front();
+    Micro::Move(unit, currentlyMovingTowards);
+    lastMoveFrame = BWAPI::Broodwar->getFrameCount();
+}
+
 void LocutusUnit::mineralWalk()
 {
     // If we're close to the patch, or if the patch is null and we've moved beyond the choke,
@@ -368,7 +465,7 @@ void LocutusUnit::fleeFrom(BWAPI::Position position)
         if (!position.isValid()) return false;
 
         // Not blocked by a building
-        if (bwebMap.usedTiles.find(BWAPI::TilePosition(position)) != bwebMap.usedTiles.end())
+        if (bwebMap.occupancy.test(BWEB::Layers::Used | BWEB::Layers::Planned, BWAPI::TilePosition(position)))
             return false;
 
         // Walkable
@@ -396,7 +493,8 @@ void LocutusUnit::fleeFrom(BWAPI::Position position)
                 unit->getPosition().y - (int)std::round(64.0 * std::sin(a)));
 
             // Verify it and positions around it
-            if (!verifyPosition(position) ||
+            if (!ClearanceMap::Instance().isWalkable(unit->getType(), position) ||
+                !verifyPosition(position) ||
                 !verifyPosition(position + BWAPI::Position(-16, -16)) ||
                 !verifyPosition(position + BWAPI::Position(16, -16)) ||
                 !verifyPosition(position + BWAPI::Position(16, 16)) ||
@@ -430,11 +528,23 @@ breakOuterLoop:;
 
 int LocutusUnit::distanceToMoveTarget() const
 {
+    // If we're following a flow field, it already knows the ground distance
+    if (flowField)
+    {
+        int dist = flowField->getDistance(unit->getPosition());
+        if (dist >= 0) return dist;
+    }
+
     // If we're currently doing a move with waypoints, sum up the total ground distance
     if (targetPosition.isValid())
     {
         BWAPI::Position current = unit->getPosition();
         int dist = 0;
+        for (auto waypoint : clearanceWaypoints)
+        {
+            dist += current.getApproxDistance(waypoint);
+            current = waypoint;
+        }
         for (auto waypoint : waypoints)
         {
             dist += current.getApproxDistance(BWAPI::Position(waypoint->Center()));
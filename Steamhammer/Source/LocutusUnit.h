@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Common.h"
+#include "FlowField.h"
 
 namespace UAlbertaBot
 {
@@ -12,6 +13,8 @@ class LocutusUnit
     BWAPI::Position                     targetPosition;
     BWAPI::Position                     currentlyMovingTowards;
     std::deque<const BWEM::ChokePoint*> waypoints;
+    std::shared_ptr<const FlowField>    flowField;
+    std::deque<BWAPI::Position>         clearanceWaypoints;     // turning points of a walk tile path within an area
     BWAPI::Unit                         mineralWalkingPatch;
     const BWEM::Area*                   mineralWalkingTargetArea;
     BWAPI::Position                     mineralWalkingStartPosition;
@@ -26,6 +29,8 @@ class LocutusUnit
 
     void updateMoveWaypoints();
     void moveToNextWaypoint();
+    void moveAlongFlowField();
+    void moveToNextClearanceWaypoint();
     void mineralWalk();
 
     void updateGoon();
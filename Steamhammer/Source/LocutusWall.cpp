@@ -2,6 +2,7 @@
 
 #include <Wall.h>
 
+#include <cstdint>
 #include <tuple>
 
 const double pi = 3.14159265358979323846;
@@ -67,30 +68,196 @@ namespace UAlbertaBot
 		return true;
 	}
 
-	void addBuildingOption(int x, int y, BWAPI::UnitType building, std::set<BWAPI::TilePosition>& buildingOptions, bool tight, std::set<BWAPI::TilePosition>& geyserTiles)
+	// A bitboard over a window of tiles around the natural choke: bit x of row y is the tile origin + (x, y)
+	// The wall options are enumerated on these, so footprint, overlap and spacing tests handle a whole row of tiles at once
+	// Tiles outside the window are never set
+	struct TileBitboard
+	{
+		static const int Size = 64;
+
+		BWAPI::TilePosition origin;
+		std::array<uint64_t, Size> rows;
+
+		explicit TileBitboard(BWAPI::TilePosition _origin)
+			: origin(_origin)
+		{
+			rows.fill(0);
+		}
+
+		// Bits x to x + width - 1 of a row, clipped to the window
+		static uint64_t rowMask(int x, int width)
+		{
+			if (x < 0)
+			{
+				width += x;
+				x = 0;
+			}
+			if (x + width > Size) width = Size - x;
+			if (width <= 0) return 0;
+
+			return (width == Size ? ~uint64_t(0) : (uint64_t(1) << width) - 1) << x;
+		}
+
+		bool test(BWAPI::TilePosition tile) const
+		{
+			int x = tile.x - origin.x;
+			int y = tile.y - origin.y;
+			if (x < 0 || y < 0 || x >= Size || y >= Size) return false;
+
+			return ((rows[y] >> x) & 1) != 0;
+		}
+
+		// Sets the width x height rectangle with its top-left corner at the given tile
+		void set(BWAPI::TilePosition tile, int width = 1, int height = 1)
+		{
+			uint64_t mask = rowMask(tile.x - origin.x, width);
+			for (int y = std::max(0, tile.y - origin.y); y < std::min(int(Size), tile.y - origin.y + height); y++)
+				rows[y] |= mask;
+		}
+
+		// Whether any tile of the width x height rectangle with its top-left corner at the given tile is set
+		bool any(BWAPI::TilePosition tile, int width, int height) const
+		{
+			uint64_t mask = rowMask(tile.x - origin.x, width);
+			for (int y = std::max(0, tile.y - origin.y); y < std::min(int(Size), tile.y - origin.y + height); y++)
+				if (rows[y] & mask) return true;
+
+			return false;
+		}
+
+		bool any(BWAPI::TilePosition tile, BWAPI::UnitType building) const
+		{
+			return any(tile, building.tileWidth(), building.tileHeight());
+		}
+
+		// Adds every tile next to a set tile, including diagonally adjacent tiles if requested
+		TileBitboard grown(bool diagonals = true) const
+		{
+			TileBitboard result(origin);
+			for (int y = 0; y < Size; y++)
+			{
+				uint64_t wide = rows[y] | (rows[y] << 1) | (rows[y] >> 1);
+				uint64_t vertical = diagonals ? wide : rows[y];
+
+				result.rows[y] |= wide;
+				if (y > 0) result.rows[y - 1] |= vertical;
+				if (y < Size - 1) result.rows[y + 1] |= vertical;
+			}
+
+			return result;
+		}
+
+		// The tiles where a width x height rectangle with its top-left corner there covers only set tiles
+		TileBitboard anchors(int width, int height) const
+		{
+			TileBitboard result(origin);
+			for (int y = 0; y + height <= Size; y++)
+			{
+				uint64_t covered = ~uint64_t(0);
+				for (int dy = 0; dy < height; dy++)
+					covered &= rows[y + dy];
+
+				uint64_t anchor = covered;
+				for (int dx = 1; dx < width; dx++)
+					anchor &= covered >> dx;
+
+				result.rows[y] = anchor;
+			}
+
+			return result;
+		}
+
+		template<class F>
+		void forEach(F f) const
+		{
+			for (int y = 0; y < Size; y++)
+			{
+				if (!rows[y]) continue;
+
+				for (int x = 0; x < Size; x++)
+					if ((rows[y] >> x) & 1)
+						f(BWAPI::TilePosition(origin.x + x, origin.y + y));
+			}
+		}
+	};
+
+	TileBitboard footprint(BWAPI::TilePosition origin, BWAPI::TilePosition tile, BWAPI::UnitType building)
+	{
+		TileBitboard result(origin);
+		result.set(tile, building.tileWidth(), building.tileHeight());
+		return result;
+	}
+
+	// The bitboards shared by the whole search for a wall, over a window centered on the natural choke
+	struct WallWindow
+	{
+		BWAPI::TilePosition origin;
+		TileBitboard geysers;			// Geysers are always tight, so they are treated specially
+		TileBitboard forgeAnchors;		// Top-left tiles where a forge can be placed
+		TileBitboard gatewayAnchors;	// Top-left tiles where a gateway can be placed
+
+		WallWindow(BWAPI::TilePosition chokeCenter)
+			: origin(chokeCenter - BWAPI::TilePosition(TileBitboard::Size / 2, TileBitboard::Size / 2))
+			, geysers(origin)
+			, forgeAnchors(origin)
+			, gatewayAnchors(origin)
+		{
+			for (auto geyser : bwebMap.area->Geysers())
+				geysers.set(geyser->TopLeft(), geyser->BottomRight().x - geyser->TopLeft().x + 1, geyser->BottomRight().y - geyser->TopLeft().y + 1);
+
+			// Tiles a wall building can cover: buildable, and not used, reserved or overlapped by anything BWEB knows about
+			// This is BWEB's isPlaceable and overlapsAnything for buildings that don't need creep and aren't resource depots
+			TileBitboard placeable(origin);
+			for (int x = origin.x; x < origin.x + TileBitboard::Size; x++)
+				for (int y = origin.y; y < origin.y + TileBitboard::Size; y++)
+				{
+					BWAPI::TilePosition tile(x, y);
+					if (!tile.isValid() || !BWAPI::Broodwar->isBuildable(tile) || BWAPI::Broodwar->hasCreep(tile)) continue;
+					if (bwebMap.occupancy.test(BWEB::Layers::Used | BWEB::Layers::Reserve | BWEB::Layers::Overlap, tile)) continue;
+
+					placeable.set(tile);
+				}
+
+			forgeAnchors = placeable.anchors(BWAPI::UnitTypes::Protoss_Forge.tileWidth(), BWAPI::UnitTypes::Protoss_Forge.tileHeight());
+			gatewayAnchors = placeable.anchors(BWAPI::UnitTypes::Protoss_Gateway.tileWidth(), BWAPI::UnitTypes::Protoss_Gateway.tileHeight());
+		}
+
+		const TileBitboard & anchors(BWAPI::UnitType building) const
+		{
+			return building == BWAPI::UnitTypes::Protoss_Forge ? forgeAnchors : gatewayAnchors;
+		}
+	};
+
+	// The terrain and the building options at one end of the natural choke
+	struct ChokeEndOptions
+	{
+		TileBitboard geo;		// Unwalkable tiles
+		TileBitboard forges;	// Top-left tiles of forges closing this end
+		TileBitboard gateways;	// Top-left tiles of gateways closing this end
+
+		ChokeEndOptions(BWAPI::TilePosition origin)
+			: geo(origin)
+			, forges(origin)
+			, gateways(origin)
+		{};
+	};
+
+	void addBuildingOption(int x, int y, BWAPI::UnitType building, TileBitboard& buildingOptions, bool tight, const WallWindow& window)
 	{
 		// Collect the possible build locations covering this tile
-		std::set<BWAPI::TilePosition> tiles;
-
-		bool geyserBlockTop = geyserTiles.find(BWAPI::TilePosition(x, y - 1)) != geyserTiles.end()
-			|| geyserTiles.find(BWAPI::TilePosition(x - 1, y - 1)) != geyserTiles.end()
-			|| geyserTiles.find(BWAPI::TilePosition(x + 1, y - 1)) != geyserTiles.end();
-		bool geyserBlockLeft = geyserTiles.find(BWAPI::TilePosition(x - 1, y)) != geyserTiles.end()
-			|| geyserTiles.find(BWAPI::TilePosition(x - 1, y - 1)) != geyserTiles.end()
-			|| geyserTiles.find(BWAPI::TilePosition(x - 1, y + 1)) != geyserTiles.end();
-		bool geyserBlockBottom = geyserTiles.find(BWAPI::TilePosition(x, y + 1)) != geyserTiles.end()
-			|| geyserTiles.find(BWAPI::TilePosition(x - 1, y + 1)) != geyserTiles.end()
-			|| geyserTiles.find(BWAPI::TilePosition(x + 1, y + 1)) != geyserTiles.end();
-		bool geyserBlockRight = geyserTiles.find(BWAPI::TilePosition(x + 1, y)) != geyserTiles.end()
-			|| geyserTiles.find(BWAPI::TilePosition(x + 1, y - 1)) != geyserTiles.end()
-			|| geyserTiles.find(BWAPI::TilePosition(x + 1, y + 1)) != geyserTiles.end();
+		std::vector<BWAPI::TilePosition> tiles;
+
+		bool geyserBlockTop = window.geysers.any(BWAPI::TilePosition(x - 1, y - 1), 3, 1);
+		bool geyserBlockLeft = window.geysers.any(BWAPI::TilePosition(x - 1, y - 1), 1, 3);
+		bool geyserBlockBottom = window.geysers.any(BWAPI::TilePosition(x - 1, y + 1), 3, 1);
+		bool geyserBlockRight = window.geysers.any(BWAPI::TilePosition(x + 1, y - 1), 1, 3);
 
 		// Blocked on top
 		if (geyserBlockTop || (building == BWAPI::UnitTypes::Protoss_Forge && !walkableAbove(BWAPI::TilePosition(x, y)))
 			|| (!tight && !bwebMap.isWalkable(BWAPI::TilePosition(x, y - 1))))
 		{
 			for (int i = 0; i < building.tileWidth(); i++)
-				tiles.insert(BWAPI::TilePosition(x - i, y));
+				tiles.push_back(BWAPI::TilePosition(x - i, y));
 		}
 
 		// Blocked on left
@@ -98,7 +265,7 @@ namespace UAlbertaBot
 			|| (!tight && !bwebMap.isWalkable(BWAPI::TilePosition(x - 1, y))))
 		{
 			for (int i = 0; i < building.tileHeight(); i++)
-				tiles.insert(BWAPI::TilePosition(x, y - i));
+				tiles.push_back(BWAPI::TilePosition(x, y - i));
 		}
 
 		// Blocked on bottom
@@ -107,7 +274,7 @@ namespace UAlbertaBot
 		{
 			int thisY = y - building.tileHeight() + 1;
 			for (int i = 0; i < building.tileWidth(); i++)
-				tiles.insert(BWAPI::TilePosition(x - i, thisY));
+				tiles.push_back(BWAPI::TilePosition(x - i, thisY));
 		}
 
 		// Blocked on right
@@ -116,21 +283,30 @@ namespace UAlbertaBot
 		{
 			int thisX = x - building.tileWidth() + 1;
 			for (int i = 0; i < building.tileHeight(); i++)
-				tiles.insert(BWAPI::TilePosition(thisX, y - i));
+				tiles.push_back(BWAPI::TilePosition(thisX, y - i));
 		}
 
-		// Add all valid positions to the options set
+		// Add all valid positions to the options
 		for (BWAPI::TilePosition tile : tiles)
 		{
-			if (!tile.isValid()) continue;
-			if (!bwebMap.isPlaceable(building, tile)) continue;
-			if (bwebMap.overlapsAnything(tile, building.tileWidth(), building.tileHeight(), true)) continue;
+			if (!window.anchors(building).test(tile)) continue;
+			if (buildingOptions.test(tile)) continue;
 
-			auto result = buildingOptions.insert(tile);
-			if (result.second) Log().Debug() << building << " option at " << tile;
+			buildingOptions.set(tile);
+			Log().Debug() << building << " option at " << tile;
 		}
 	}
 
+	// Both building types are added, but only at tiles that are at the same elevation as the natural
+	void addBuildingOptions(BWAPI::TilePosition tile, ChokeEndOptions& end, bool tight, const WallWindow& window, int elevation)
+	{
+		if (!bwebMap.isWalkable(tile)) end.geo.set(tile);
+		if (BWAPI::Broodwar->getGroundHeight(tile) != elevation) return;
+
+		addBuildingOption(tile.x, tile.y, BWAPI::UnitTypes::Protoss_Forge, end.forges, tight, window);
+		addBuildingOption(tile.x, tile.y, BWAPI::UnitTypes::Protoss_Gateway, end.gateways, tight, window);
+	}
+
 	void addForgeGeo(BWAPI::TilePosition forge, std::vector<BWAPI::Position>& geo)
 	{
 		geo.push_back(center(forge));
@@ -155,47 +331,14 @@ namespace UAlbertaBot
 		geo.push_back(center(BWAPI::TilePosition(gateway.x, gateway.y + 1)));
 	}
 
-	void addWallOption(BWAPI::TilePosition forge, BWAPI::TilePosition gateway, std::vector<BWAPI::Position>* geo, std::vector<ForgeGatewayWallOption>& wallOptions)
+	// Scores the gap between the two sets of positions, and adds the wall if the gap can be walked through and is no wider than maxGapSize
+	void addWallOption(BWAPI::TilePosition forge, BWAPI::TilePosition gateway, const std::vector<BWAPI::Position>& geo1, const std::vector<BWAPI::Position>& geo2, int maxGapSize, std::vector<ForgeGatewayWallOption>& wallOptions)
 	{
 		// Check if we've already considered this wall
 		for (auto const& option : wallOptions)
 			if (option.forge == forge && option.gateway == gateway)
 				return;
 
-		// Buildings overlap
-		if (forge.x > (gateway.x - 3) && forge.x < (gateway.x + 4) && forge.y >(gateway.y - 2) && forge.y < (gateway.y + 3))
-		{
-			wallOptions.push_back(ForgeGatewayWallOption(forge, gateway));
-			return;
-		}
-
-		// Buildings cannot be placed
-		if (!bwebMap.isPlaceable(BWAPI::UnitTypes::Protoss_Forge, forge) ||
-			bwebMap.overlapsAnything(forge, BWAPI::UnitTypes::Protoss_Forge.tileWidth(), BWAPI::UnitTypes::Protoss_Forge.tileHeight(), true) ||
-			!bwebMap.isPlaceable(BWAPI::UnitTypes::Protoss_Gateway, gateway) ||
-			bwebMap.overlapsAnything(gateway, BWAPI::UnitTypes::Protoss_Gateway.tileWidth(), BWAPI::UnitTypes::Protoss_Gateway.tileHeight(), true))
-		{
-			wallOptions.push_back(ForgeGatewayWallOption(forge, gateway));
-			return;
-		}
-
-		// Set up the sets of positions we are comparing between
-		std::vector<BWAPI::Position> geo1;
-		std::vector<BWAPI::Position> * geo2;
-
-		if (geo)
-		{
-			addForgeGeo(forge, geo1);
-			addGatewayGeo(gateway, geo1);
-			geo2 = geo;
-		}
-		else
-		{
-			addForgeGeo(forge, geo1);
-			geo2 = new std::vector<BWAPI::Position>();
-			addGatewayGeo(gateway, *geo2);
-		}
-
 		BWAPI::Position natCenter = BWAPI::Position(bwebMap.getNatural()) + BWAPI::Position(64, 48);
 		double bestDist = DBL_MAX;
 		double bestNatDist = DBL_MAX;
@@ -205,7 +348,7 @@ namespace UAlbertaBot
 		BWAPI::Position end2;
 
 		for (BWAPI::Position first : geo1)
-			for (BWAPI::Position second : *geo2)
+			for (BWAPI::Position second : geo2)
 			{
 				double dist = first.getDistance(second);
 				if (dist < bestDist)
@@ -236,22 +379,17 @@ namespace UAlbertaBot
 
         if (!bestCenter.isValid())
         {
-            Log().Debug() << "Error scoring wall forge " << forge << ", gateway " << gateway << ", geo1 size " << geo1.size() << ", geo2 size " << geo2->size();
-            wallOptions.push_back(ForgeGatewayWallOption(forge, gateway));
+            Log().Debug() << "Error scoring wall forge " << forge << ", gateway " << gateway << ", geo1 size " << geo1.size() << ", geo2 size " << geo2.size();
             return;
         }
 
-		if (!geo)
-			delete geo2;
-
 		// Gap must be at least 64
-		if (bestDist < 64.0)
-		{
-			wallOptions.push_back(ForgeGatewayWallOption(forge, gateway));
-			return;
-		}
+		if (bestDist < 64.0) return;
+
+		int gapSize = (int)floor(bestDist / 16.0) - 2;
+		if (gapSize > maxGapSize) return;
 
-		wallOptions.push_back(ForgeGatewayWallOption(forge, gateway, (int)floor(bestDist / 16.0) - 2, bestCenter, end1, end2));
+		wallOptions.push_back(ForgeGatewayWallOption(forge, gateway, gapSize, bestCenter, end1, end2));
 		Log().Debug() << "Scored wall forge " << forge << ", gateway " << gateway << ", gap " << bestDist << ", center " << BWAPI::TilePosition(bestCenter);
 	}
 
@@ -299,7 +437,7 @@ namespace UAlbertaBot
 	{
 		if (!tile.isValid()) return false;
 		if (!bwebMap.isWalkable(tile)) return false;
-		if (bwebMap.overlapGrid[tile.x][tile.y] == 1 && bwebMap.reserveGrid[tile.x][tile.y] != 1) return false;
+		if (bwebMap.occupancy.test(BWEB::Layers::Overlap, tile) && !bwebMap.occupancy.test(BWEB::Layers::Reserve, tile)) return false;
 		return true;
 	}
 
@@ -322,13 +460,7 @@ namespace UAlbertaBot
 
 	void removeOverlap(const BWAPI::TilePosition t, const int w, const int h)
 	{
-		for (auto x = t.x; x < t.x + w; x++)
-		{
-			for (auto y = t.y; y < t.y + h; y++)
-			{
-				bwebMap.overlapGrid[x][y] = 0;
-			}
-		}
+		bwebMap.occupancy.reset(BWEB::Layers::Overlap, t, w, h);
 	}
 
 	bool isAnyWalkable(const BWAPI::TilePosition here)
@@ -446,7 +578,7 @@ namespace UAlbertaBot
 		for (const auto& tile : tiles)
 		{
 			if (!tile.isValid() || !bwebMap.isWalkable(tile)) continue;
-			if (bwebMap.overlapGrid[tile.x][tile.y] > 0) continue;
+			if (bwebMap.occupancy.test(BWEB::Layers::Overlap, tile)) continue;
 			if (bwebMap.overlapsCurrentWall(tile) != BWAPI::UnitTypes::None) continue;
 
 			result = tile;
@@ -532,22 +664,8 @@ namespace UAlbertaBot
 			&& forge.y <= (gateway.y + 3);
 	}
 
-	void analyzeChokeGeoAndFindBuildingOptions(
-		std::vector<BWAPI::Position> & end1Geo, 
-		std::vector<BWAPI::Position> & end2Geo, 
-		std::set<BWAPI::TilePosition> & end1ForgeOptions, 
-		std::set<BWAPI::TilePosition> & end1GatewayOptions, 
-		std::set<BWAPI::TilePosition> & end2ForgeOptions, 
-		std::set<BWAPI::TilePosition> & end2GatewayOptions, 
-		bool tight)
+	void analyzeChokeGeoAndFindBuildingOptions(const WallWindow & window, ChokeEndOptions & end1Options, ChokeEndOptions & end2Options, bool tight)
 	{
-		// Geysers are always tight, so treat them specially
-		std::set<BWAPI::TilePosition> geyserTiles;
-		for (auto geyser : bwebMap.area->Geysers())
-			for (int x = geyser->TopLeft().x; x <= geyser->BottomRight().x; x++)
-				for (int y = geyser->TopLeft().y; y <= geyser->BottomRight().y; y++)
-					geyserTiles.insert(BWAPI::TilePosition(x, y));
-
         // Get elevation of natural, we want our wall to be at the same elevation
         auto elevation = BWAPI::Broodwar->getGroundHeight(bwebMap.naturalTile);
 
@@ -571,11 +689,8 @@ namespace UAlbertaBot
 				{
 					BWAPI::TilePosition tile(x, y);
 					if (!tile.isValid()) continue;
-					if (!bwebMap.isWalkable(tile)) end1Geo.push_back(center(tile));
-                    if (BWAPI::Broodwar->getGroundHeight(tile) != elevation) continue;
 
-					addBuildingOption(x, y, BWAPI::UnitTypes::Protoss_Forge, end1ForgeOptions, tight, geyserTiles);
-					addBuildingOption(x, y, BWAPI::UnitTypes::Protoss_Gateway, end1GatewayOptions, tight, geyserTiles);
+					addBuildingOptions(tile, end1Options, tight, window, elevation);
 				}
 
 			// Find options on right side
@@ -584,11 +699,8 @@ namespace UAlbertaBot
 				{
 					BWAPI::TilePosition tile(x, y);
 					if (!tile.isValid()) continue;
-					if (!bwebMap.isWalkable(tile)) end2Geo.push_back(center(tile));
-                    if (BWAPI::Broodwar->getGroundHeight(tile) != elevation) continue;
 
-					addBuildingOption(x, y, BWAPI::UnitTypes::Protoss_Forge, end2ForgeOptions, tight, geyserTiles);
-					addBuildingOption(x, y, BWAPI::UnitTypes::Protoss_Gateway, end2GatewayOptions, tight, geyserTiles);
+					addBuildingOptions(tile, end2Options, tight, window, elevation);
 				}
 		}
 		else if (diffX >= -2 && diffX <= 2)
@@ -605,11 +717,8 @@ namespace UAlbertaBot
 				{
 					BWAPI::TilePosition tile(x, y);
 					if (!tile.isValid()) continue;
-					if (!bwebMap.isWalkable(tile)) end1Geo.push_back(center(tile));
-                    if (BWAPI::Broodwar->getGroundHeight(tile) != elevation) continue;
 
-					addBuildingOption(x, y, BWAPI::UnitTypes::Protoss_Forge, end1ForgeOptions, tight, geyserTiles);
-					addBuildingOption(x, y, BWAPI::UnitTypes::Protoss_Gateway, end1GatewayOptions, tight, geyserTiles);
+					addBuildingOptions(tile, end1Options, tight, window, elevation);
 				}
 
 			// Find options on bottom side
@@ -618,11 +727,8 @@ namespace UAlbertaBot
 				{
 					BWAPI::TilePosition tile(x, y);
 					if (!tile.isValid()) continue;
-					if (!bwebMap.isWalkable(tile)) end2Geo.push_back(center(tile));
-                    if (BWAPI::Broodwar->getGroundHeight(tile) != elevation) continue;
 
-					addBuildingOption(x, y, BWAPI::UnitTypes::Protoss_Forge, end2ForgeOptions, tight, geyserTiles);
-					addBuildingOption(x, y, BWAPI::UnitTypes::Protoss_Gateway, end2GatewayOptions, tight, geyserTiles);
+					addBuildingOptions(tile, end2Options, tight, window, elevation);
 				}
 		}
 		else
@@ -649,11 +755,8 @@ namespace UAlbertaBot
                         BWAPI::TilePosition tile(x, y);
                         if (!tile.isValid()) continue;
                         if (center(tile).getDistance(end1Center) > center(tile).getDistance(end2Center)) continue;
-                        if (!bwebMap.isWalkable(tile)) end1Geo.push_back(center(tile));
-                        if (BWAPI::Broodwar->getGroundHeight(tile) != elevation) continue;
 
-                        addBuildingOption(x, y, BWAPI::UnitTypes::Protoss_Forge, end1ForgeOptions, tight, geyserTiles);
-                        addBuildingOption(x, y, BWAPI::UnitTypes::Protoss_Gateway, end1GatewayOptions, tight, geyserTiles);
+                        addBuildingOptions(tile, end1Options, tight, window, elevation);
                     }
 
                     // Find options on right side
@@ -664,83 +767,115 @@ namespace UAlbertaBot
                         BWAPI::TilePosition tile(x, y);
                         if (!tile.isValid()) continue;
                         if (center(tile).getDistance(end2Center) > center(tile).getDistance(end1Center)) continue;
-                        if (!bwebMap.isWalkable(tile)) end2Geo.push_back(center(tile));
-                        if (BWAPI::Broodwar->getGroundHeight(tile) != elevation) continue;
 
-                        addBuildingOption(x, y, BWAPI::UnitTypes::Protoss_Forge, end2ForgeOptions, tight, geyserTiles);
-                        addBuildingOption(x, y, BWAPI::UnitTypes::Protoss_Gateway, end2GatewayOptions, tight, geyserTiles);
+                        addBuildingOptions(tile, end2Options, tight, window, elevation);
                     }
 				}
 		}
 	}
 
-	void generateWallOptions(
+	// Walls with the forge closing one end of the choke and the gateway closing the other, leaving the gap between them
+	void addSeparatedWallOptions(
 		std::vector<ForgeGatewayWallOption> & wallOptions,
-		std::vector<BWAPI::Position> & end1Geo,
-		std::vector<BWAPI::Position> & end2Geo,
-		std::set<BWAPI::TilePosition> & end1ForgeOptions,
-		std::set<BWAPI::TilePosition> & end1GatewayOptions,
-		std::set<BWAPI::TilePosition> & end2ForgeOptions,
-		std::set<BWAPI::TilePosition> & end2GatewayOptions,
+		const TileBitboard & forges,
+		const TileBitboard & gateways,
 		int maxGapSize)
 	{
-		// Forge on end1 side
-		for (BWAPI::TilePosition forge : end1ForgeOptions)
+		// Buildings further apart than maxGapSize / 2 + 1 tiles (counting diagonal steps as one) leave a gap wider than maxGapSize,
+		// as the gap is measured between tile centers and so is at least 32 pixels per tile of distance
+		bool bounded = maxGapSize < TileBitboard::Size;
+
+		forges.forEach([&](BWAPI::TilePosition forge)
 		{
-			// Gateway on end2 side
-			for (BWAPI::TilePosition gate : end2GatewayOptions)
-				addWallOption(forge, gate, nullptr, wallOptions);
-
-			// Gateway above forge
-			addWallOption(forge, BWAPI::TilePosition(forge.x - 3, forge.y - 3), &end2Geo, wallOptions);
-			addWallOption(forge, BWAPI::TilePosition(forge.x - 2, forge.y - 3), &end2Geo, wallOptions);
-			addWallOption(forge, BWAPI::TilePosition(forge.x - 1, forge.y - 3), &end2Geo, wallOptions);
-			addWallOption(forge, BWAPI::TilePosition(forge.x, forge.y - 3), &end2Geo, wallOptions);
-			addWallOption(forge, BWAPI::TilePosition(forge.x + 1, forge.y - 3), &end2Geo, wallOptions);
-		}
+			// Anything touching the forge, diagonally included, leaves less than the minimum gap of 64
+			TileBitboard tooClose = footprint(forges.origin, forge, BWAPI::UnitTypes::Protoss_Forge).grown();
+
+			TileBitboard closeEnough = tooClose;
+			if (bounded)
+				for (int i = 1; i < maxGapSize / 2 + 1; i++)
+					closeEnough = closeEnough.grown();
+
+			std::vector<BWAPI::Position> forgeGeo;
+			addForgeGeo(forge, forgeGeo);
+
+			gateways.forEach([&](BWAPI::TilePosition gateway)
+			{
+				if (tooClose.any(gateway, BWAPI::UnitTypes::Protoss_Gateway)) return;
+				if (bounded && !closeEnough.any(gateway, BWAPI::UnitTypes::Protoss_Gateway)) return;
+
+				std::vector<BWAPI::Position> gatewayGeo;
+				addGatewayGeo(gateway, gatewayGeo);
+
+				addWallOption(forge, gateway, forgeGeo, gatewayGeo, maxGapSize, wallOptions);
+			});
+		});
+	}
+
+	// Walls with the forge and gateway sharing an edge and closing one end of the choke, leaving the gap to the terrain at the other end
+	// Every placement of the other building along the edges of each option at this end is considered
+	void addStackedWallOptions(
+		std::vector<ForgeGatewayWallOption> & wallOptions,
+		const WallWindow & window,
+		const ChokeEndOptions & end,
+		const ChokeEndOptions & otherEnd,
+		int maxGapSize)
+	{
+		std::vector<BWAPI::Position> otherGeo;
+		otherEnd.geo.forEach([&](BWAPI::TilePosition tile) { otherGeo.push_back(center(tile)); });
+		if (otherGeo.empty()) return;
+
+		// Buildings touching the terrain at the other end leave less than the minimum gap of 64
+		TileBitboard tooClose = otherEnd.geo.grown();
 
-		// Forge on end2 side
-		for (BWAPI::TilePosition forge : end2ForgeOptions)
+		auto addStacked = [&](BWAPI::TilePosition forge, BWAPI::TilePosition gateway)
 		{
-			// Gateway on end1 side
-			for (BWAPI::TilePosition gate : end1GatewayOptions)
-				addWallOption(forge, gate, nullptr, wallOptions);
-
-			// Gateway above forge
-			addWallOption(forge, BWAPI::TilePosition(forge.x - 3, forge.y - 3), &end1Geo, wallOptions);
-			addWallOption(forge, BWAPI::TilePosition(forge.x - 2, forge.y - 3), &end1Geo, wallOptions);
-			addWallOption(forge, BWAPI::TilePosition(forge.x - 1, forge.y - 3), &end1Geo, wallOptions);
-			addWallOption(forge, BWAPI::TilePosition(forge.x, forge.y - 3), &end1Geo, wallOptions);
-			addWallOption(forge, BWAPI::TilePosition(forge.x + 1, forge.y - 3), &end1Geo, wallOptions);
-		}
+			if (!window.forgeAnchors.test(forge) || !window.gatewayAnchors.test(gateway)) return;
+
+			// The buildings must not overlap, and must share an edge so nothing can walk between them
+			TileBitboard forgeTiles = footprint(window.origin, forge, BWAPI::UnitTypes::Protoss_Forge);
+			if (forgeTiles.any(gateway, BWAPI::UnitTypes::Protoss_Gateway)) return;
+			if (!forgeTiles.grown(false).any(gateway, BWAPI::UnitTypes::Protoss_Gateway)) return;
+
+			if (tooClose.any(forge, BWAPI::UnitTypes::Protoss_Forge) || tooClose.any(gateway, BWAPI::UnitTypes::Protoss_Gateway)) return;
+
+			std::vector<BWAPI::Position> wallGeo;
+			addForgeGeo(forge, wallGeo);
+			addGatewayGeo(gateway, wallGeo);
 
-		// Gateway on end1 side, forge below gateway
-		for (BWAPI::TilePosition gateway : end1GatewayOptions)
+			addWallOption(forge, gateway, wallGeo, otherGeo, maxGapSize, wallOptions);
+		};
+
+		// Gateways along the edges of each forge option
+		end.forges.forEach([&](BWAPI::TilePosition forge)
 		{
-			addWallOption(BWAPI::TilePosition(gateway.x - 2, gateway.y + 3), gateway, &end2Geo, wallOptions);
-			addWallOption(BWAPI::TilePosition(gateway.x - 1, gateway.y + 3), gateway, &end2Geo, wallOptions);
-			addWallOption(BWAPI::TilePosition(gateway.x, gateway.y + 3), gateway, &end2Geo, wallOptions);
-			addWallOption(BWAPI::TilePosition(gateway.x + 1, gateway.y + 3), gateway, &end2Geo, wallOptions);
-			addWallOption(BWAPI::TilePosition(gateway.x + 2, gateway.y + 3), gateway, &end2Geo, wallOptions);
-		}
+			for (int x = forge.x - BWAPI::UnitTypes::Protoss_Gateway.tileWidth(); x <= forge.x + BWAPI::UnitTypes::Protoss_Forge.tileWidth(); x++)
+				for (int y = forge.y - BWAPI::UnitTypes::Protoss_Gateway.tileHeight(); y <= forge.y + BWAPI::UnitTypes::Protoss_Forge.tileHeight(); y++)
+					addStacked(forge, BWAPI::TilePosition(x, y));
+		});
 
-		// Gateway on end2 side, forge below gateway
-		for (BWAPI::TilePosition gateway : end2GatewayOptions)
+		// Forges along the edges of each gateway option
+		end.gateways.forEach([&](BWAPI::TilePosition gateway)
 		{
-			addWallOption(BWAPI::TilePosition(gateway.x - 2, gateway.y + 3), gateway, &end1Geo, wallOptions);
-			addWallOption(BWAPI::TilePosition(gateway.x - 1, gateway.y + 3), gateway, &end1Geo, wallOptions);
-			addWallOption(BWAPI::TilePosition(gateway.x, gateway.y + 3), gateway, &end1Geo, wallOptions);
-			addWallOption(BWAPI::TilePosition(gateway.x + 1, gateway.y + 3), gateway, &end1Geo, wallOptions);
-			addWallOption(BWAPI::TilePosition(gateway.x + 2, gateway.y + 3), gateway, &end1Geo, wallOptions);
-		}
+			for (int x = gateway.x - BWAPI::UnitTypes::Protoss_Forge.tileWidth(); x <= gateway.x + BWAPI::UnitTypes::Protoss_Gateway.tileWidth(); x++)
+				for (int y = gateway.y - BWAPI::UnitTypes::Protoss_Forge.tileHeight(); y <= gateway.y + BWAPI::UnitTypes::Protoss_Gateway.tileHeight(); y++)
+					addStacked(BWAPI::TilePosition(x, y), gateway);
+		});
+	}
 
-		// Prune invalid options from the vector, we don't need to store them any more
-		auto it = wallOptions.begin();
-		for (; it != wallOptions.end(); )
-			if (it->gapCenter == BWAPI::Positions::Invalid || it->gapSize > maxGapSize)
-				it = wallOptions.erase(it);
-			else
-				++it;
+	void generateWallOptions(
+		std::vector<ForgeGatewayWallOption> & wallOptions,
+		const WallWindow & window,
+		const ChokeEndOptions & end1,
+		const ChokeEndOptions & end2,
+		int maxGapSize)
+	{
+		// Forge on one side, gateway on the other
+		addSeparatedWallOptions(wallOptions, end1.forges, end2.gateways, maxGapSize);
+		addSeparatedWallOptions(wallOptions, end2.forges, end1.gateways, maxGapSize);
+
+		// Forge and gateway together on one side
+		addStackedWallOptions(wallOptions, window, end1, end2, maxGapSize);
+		addStackedWallOptions(wallOptions, window, end2, end1, maxGapSize);
 	}
 
 	BWAPI::TilePosition getPylonPlacement(LocutusWall& wall, int optimalPathLength, bool returnFirst = false)
@@ -1005,7 +1140,7 @@ namespace UAlbertaBot
 	{
 		// Reserve the path
 		for (auto& tile : BWEB::Map::Instance().findPath(bwemMap, bwebMap, bwebMap.startTile, bwebMap.endTile))
-			bwebMap.overlapGrid[tile.x][tile.y] = 1;
+			bwebMap.occupancy.set(BWEB::Layers::Overlap, tile);
 	}
 
 	LocutusWall destinationWall()
@@ -1258,19 +1393,15 @@ namespace UAlbertaBot
         Log().Debug() << "Pathfinding between " << bwebMap.startTile << " and " << bwebMap.endTile << ", initial length " << optimalPathLength;
 
 		// Step 1: Analyze choke geo and find potential forge and gateway options
-		std::vector<BWAPI::Position> end1Geo;
-		std::vector<BWAPI::Position> end2Geo;
-
-		std::set<BWAPI::TilePosition> end1ForgeOptions;
-		std::set<BWAPI::TilePosition> end1GatewayOptions;
-		std::set<BWAPI::TilePosition> end2ForgeOptions;
-		std::set<BWAPI::TilePosition> end2GatewayOptions;
+		WallWindow window(BWAPI::TilePosition(bwebMap.choke->Center()));
+		ChokeEndOptions end1Options(window.origin);
+		ChokeEndOptions end2Options(window.origin);
 
-		analyzeChokeGeoAndFindBuildingOptions(end1Geo, end2Geo, end1ForgeOptions, end1GatewayOptions, end2ForgeOptions, end2GatewayOptions, tight);
+		analyzeChokeGeoAndFindBuildingOptions(window, end1Options, end2Options, tight);
 
-		// Step 2: Generate possible combinations
+		// Step 2: Generate and score all possible combinations
 		std::vector<ForgeGatewayWallOption> wallOptions;
-		generateWallOptions(wallOptions, end1Geo, end2Geo, end1ForgeOptions, end1GatewayOptions, end2ForgeOptions, end2GatewayOptions, maxGapSize);
+		generateWallOptions(wallOptions, window, end1Options, end2Options, maxGapSize);
 
 		// Return if we have no valid wall
 		if (wallOptions.empty()) return LocutusWall();
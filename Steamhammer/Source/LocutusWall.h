@@ -90,9 +90,9 @@ namespace UAlbertaBot
         bool exists() const
         {
             return isValid() && (
-                BWEB::Map::Instance().usedTiles.find(pylon) != BWEB::Map::Instance().usedTiles.end() ||
-                BWEB::Map::Instance().usedTiles.find(forge) != BWEB::Map::Instance().usedTiles.end() ||
-                BWEB::Map::Instance().usedTiles.find(gateway) != BWEB::Map::Instance().usedTiles.end());
+                BWEB::Map::Instance().occupancy.test(BWEB::Layers::Used | BWEB::Layers::Planned, pylon) ||
+                BWEB::Map::Instance().occupancy.test(BWEB::Layers::Used | BWEB::Layers::Planned, forge) ||
+                BWEB::Map::Instance().occupancy.test(BWEB::Layers::Used | BWEB::Layers::Planned, gateway));
         }
 
         bool containsBuildingAt(BWAPI::TilePosition tile) const
@@ -0,0 +1,71 @@
+#include "Common.h"
+#include "MapDump.h"
+
+using namespace UAlbertaBot;
+
+std::string MapDump::fileName()
+{
+    return "map-" + BWAPI::Broodwar->mapHash() + ".dump";
+}
+
+bool MapDump::write(const std::string & fileName)
+{
+    std::ofstream out(fileName, std::ios::trunc);
+    if (!out) return false;
+
+    const int width = BWAPI::Broodwar->mapWidth();
+    const int height = BWAPI::Broodwar->mapHeight();
+
+    out << "MapDump " << Version << "\n";
+    out << "name " << BWAPI::Broodwar->mapFileName() << "\n";
+    out << "hash " << BWAPI::Broodwar->mapHash() << "\n";
+    out << "size " << width << " " << height << "\n";
+
+    BWAPI::TilePosition start = BWAPI::Broodwar->self()->getStartLocation();
+    out << "self " << start.x << " " << start.y << " " << BWAPI::Broodwar->self()->getRace().getID() << "\n";
+
+    for (BWAPI::TilePosition tile : BWAPI::Broodwar->getStartLocations())
+    {
+        out << "start " << tile.x << " " << tile.y << "\n";
+    }
+
+    out << "height\n";
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            out << BWAPI::Broodwar->getGroundHeight(x, y);
+        }
+        out << "\n";
+    }
+
+    out << "buildable\n";
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            out << (BWAPI::Broodwar->isBuildable(x, y) ? '1' : '0');
+        }
+        out << "\n";
+    }
+
+    out << "walkable\n";
+    for (int y = 0; y < height * 4; y++)
+    {
+        for (int x = 0; x < width * 4; x++)
+        {
+            out << (BWAPI::Broodwar->isWalkable(x, y) ? '1' : '0');
+        }
+        out << "\n";
+    }
+
+    for (BWAPI::Unit unit : BWAPI::Broodwar->getStaticNeutralUnits())
+    {
+        BWAPI::Position position = unit->getInitialPosition();
+        out << "neutral " << unit->getInitialType().getID() << " " << position.x << " " << position.y << " " << unit->getInitialResources() << "\n";
+    }
+
+    out << "end\n";
+
+    return bool(out);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+
+// Writes the static map information the map analysis depends on to a text file,
+// so that the analysis can be run and profiled outside of a game (see MapAnalysis/).
+//
+// Format, one record per line:
+//   MapDump 1
+//   name <map file name>
+//   hash <map hash>
+//   size <width> <height>                         in tiles
+//   self <start x> <start y> <race id>            our player, start location in tiles
+//   start <x> <y>                                 one per start location, in tiles
+//   height                                        followed by <height> lines of <width> ground heights 0-5
+//   buildable                                     followed by <height> lines of <width> 0 or 1
+//   walkable                                      followed by 4 * <height> lines of 4 * <width> 0 or 1
+//   neutral <unit type id> <x> <y> <resources>    one per static neutral unit, center position in pixels
+//   end
+
+namespace UAlbertaBot
+{
+namespace MapDump
+{
+    const int Version = 1;
+
+    std::string fileName();
+
+    // Returns false if the file could not be written
+    bool write(const std::string & fileName);
+};
+}
@@ -4,6 +4,7 @@
 #include "InformationManager.h"
 #include "PathFinding.h"
 #include "MathUtil.h"
+#include "ClearanceMap.h"
 
 const double pi = 3.14159265358979323846;
 
@@ -399,7 +400,7 @@ bool MapTools::blocksChokeFromScoutingWorker(BWAPI::Position pos, BWAPI::UnitTyp
         }
 
         for (auto current : positionsToCheck)
-            if (!MathUtil::Walkable(enemyUnit, current))
+            if (!ClearanceMap::Instance().isWalkable(enemyUnit, current))
                 return false;
 
         return true;
@@ -473,7 +474,7 @@ void MapTools::computeScoutBlockingPositions(BWAPI::Position center, BWAPI::Unit
     {
         BWAPI::Position start = *toBlock.begin();
         for (auto it = toBlock.begin(); it != toBlock.end(); it = toBlock.erase(it))
-            if (MathUtil::Walkable(BWAPI::UnitTypes::Protoss_Probe, *it))
+            if (ClearanceMap::Instance().isWalkable(BWAPI::UnitTypes::Protoss_Probe, *it))
                 break;
 
         std::reverse(toBlock.begin(), toBlock.end());
@@ -489,7 +490,7 @@ void MapTools::computeScoutBlockingPositions(BWAPI::Position center, BWAPI::Unit
             // Is this a valid position for a probe?
             // We use a probe here because we sometimes mix probes and zealots and probes are larger
             if (!pos.isValid()) continue;
-            if (!MathUtil::Walkable(BWAPI::UnitTypes::Protoss_Probe, pos)) continue;
+            if (!ClearanceMap::Instance().isWalkable(BWAPI::UnitTypes::Protoss_Probe, pos)) continue;
 
             // Does it block the enemy position?
             if (!MathUtil::Overlaps(BWAPI::UnitTypes::Protoss_Probe, enemyPosition, type, pos))
@@ -938,16 +939,64 @@ BWTA::BaseLocation * MapTools::nextExpansion(bool hidden, bool wantMinerals, boo
 	return nullptr;
 }
 
+// Takes in the latest result, and asks again if the terrain has changed since the last request.
+MapTools::BaseDistance & MapTools::updateBaseDistance(BWTA::BaseLocation * base, BWTA::BaseLocation * other)
+{
+    BaseDistance & entry = _baseDistances[std::make_pair(base, other)];
+
+    if (entry.request.isReady())
+    {
+        entry.distance = entry.request.get().length;
+    }
+
+    if (entry.requestVersion != PathService::Instance().terrainVersion())
+    {
+        entry.request = PathService::Instance().submit(
+            PathService::RequestType::GroundDistance,
+            base->getPosition(),
+            other->getPosition(),
+            BWAPI::UnitTypes::Protoss_Probe,
+            PathFinding::PathFindingOptions::UseNearestBWEMArea);
+        entry.requestVersion = PathService::Instance().terrainVersion();
+    }
+
+    return entry;
+}
+
+// Ask for all the distances between bases in the background, so they are ready when we want to expand.
+// Call after the path service is started.
+void MapTools::requestBaseDistances()
+{
+    for (BWTA::BaseLocation * base : BWTA::getBaseLocations())
+    {
+        for (BWTA::BaseLocation * other : BWTA::getBaseLocations())
+        {
+            if (base != other)
+            {
+                updateBaseDistance(base, other);
+            }
+        }
+    }
+}
+
 int MapTools::closestBaseDistance(BWTA::BaseLocation * base, std::vector<BWTA::BaseLocation*> bases)
 {
     int closestDistance = -1;
     for (auto other : bases)
     {
-        int dist = PathFinding::GetGroundDistance(
-            base->getPosition(), 
-            other->getPosition(), 
-            BWAPI::UnitTypes::Protoss_Probe, 
-            PathFinding::PathFindingOptions::UseNearestBWEMArea);
+        BaseDistance & entry = updateBaseDistance(base, other);
+
+        // If the background result is not in yet, which should only happen early in the game, work it out here
+        if (entry.distance == -2)
+        {
+            entry.distance = PathFinding::GetGroundDistance(
+                base->getPosition(),
+                other->getPosition(),
+                BWAPI::UnitTypes::Protoss_Probe,
+                PathFinding::PathFindingOptions::UseNearestBWEMArea);
+        }
+
+        int dist = entry.distance;
         if (dist >= 0 && (dist < closestDistance || closestDistance == -1))
             closestDistance = dist;
     }
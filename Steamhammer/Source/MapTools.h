@@ -5,6 +5,7 @@
 
 #include "Common.h"
 #include "DistanceMap.h"
+#include "PathService.h"
 
 // Keep track of map information, like what tiles are walkable or buildable.
 
@@ -61,8 +62,21 @@ class MapTools
 
     std::set<const BWEM::ChokePoint *> _allChokepoints;
 
+    // Ground distances between bases for choosing expansions, computed in the background
+    struct BaseDistance
+    {
+        PathHandle  request;            // the latest request
+        int         requestVersion;     // terrain version it was made for
+        int         distance;           // the latest result, -2 if none is in yet
+
+        BaseDistance() : requestVersion(-1), distance(-2) {};
+    };
+    std::map<std::pair<BWTA::BaseLocation *, BWTA::BaseLocation *>, BaseDistance> _baseDistances;
+
     MapTools();
 
+    BaseDistance &      updateBaseDistance(BWTA::BaseLocation * base, BWTA::BaseLocation * other);
+
     BWAPI::Position     findClosestUnwalkablePosition(BWAPI::Position start, BWAPI::Position closeTo, int searchRadius);
     void                computeScoutBlockingPositions(BWAPI::Position center, BWAPI::UnitType type, std::set<BWAPI::Position> & result);
     void                findPath(BWAPI::Position start, BWAPI::Position end, std::vector<BWAPI::Position> & result);
@@ -83,6 +97,7 @@ public:
 	int		getGroundTileDistance(BWAPI::Position from, BWAPI::Position to);
 	int		getGroundDistance(BWAPI::Position from, BWAPI::Position to);
 
+    void    requestBaseDistances();
     int     closestBaseDistance(BWTA::BaseLocation * base, std::vector<BWTA::BaseLocation*> bases);
 
 	// Pass only valid tiles to these routines!
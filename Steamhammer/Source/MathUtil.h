@@ -11,6 +11,5 @@ namespace MathUtil
     int EdgeToPointDistance(BWAPI::UnitType type, BWAPI::Position center, BWAPI::Position point);
     bool Overlaps(BWAPI::UnitType firstType, BWAPI::Position firstCenter, BWAPI::UnitType secondType, BWAPI::Position secondCenter);
     bool Overlaps(BWAPI::UnitType type, BWAPI::Position center, BWAPI::Position point);
-    bool Walkable(BWAPI::UnitType type, BWAPI::Position center);
 };
 }
\ No newline at end of file
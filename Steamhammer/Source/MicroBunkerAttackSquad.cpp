@@ -3,6 +3,7 @@
 #include "InformationManager.h"
 #include "CombatCommander.h"
 #include "MathUtil.h"
+#include "ClearanceMap.h"
 #include "PathFinding.h"
 
 const double pi = 3.14159265358979323846;
@@ -65,18 +66,6 @@ void addArcToSet(BWAPI::Position from, BWAPI::Position bunkerPosition, double st
     }
 }
 
-bool isDragoonWalkable(BWAPI::Position position)
-{
-    const auto start = BWAPI::WalkPosition(position);
-    for (auto x = start.x - 2; x <= start.x + 2; x++)
-        for (auto y = start.y - 2; y <= start.y + 2; y++)
-            if (!BWAPI::WalkPosition(x, y).isValid()
-                || !BWAPI::Broodwar->isWalkable(BWAPI::WalkPosition(x, y)))
-                return false;
-
-    return true;
-}
-
 std::vector<BWAPI::TilePosition> getReservedPath(BWAPI::Position bunkerPosition)
 {
     // Get the BWEM path to the bunker
@@ -172,9 +161,9 @@ void MicroBunkerAttackSquad::initialize(BWAPI::Position bunkerPosition)
     for (auto it = attackPositions.begin(); it != attackPositions.end(); )
     {
         if (!it->isValid() ||
-            !isDragoonWalkable(*it) ||
+            !ClearanceMap::Instance().isWalkable(BWAPI::UnitTypes::Protoss_Dragoon, *it) ||
             BWAPI::Broodwar->getGroundHeight(BWAPI::TilePosition(*it)) < bunkerElevation ||
-            bwebMap.usedTiles.find(BWAPI::TilePosition(*it)) != bwebMap.usedTiles.end() ||
+            bwebMap.occupancy.test(BWEB::Layers::Used | BWEB::Layers::Planned, BWAPI::TilePosition(*it)) ||
             closeToReservedPath(*it, reservedPath) ||
             (blocksNarrowChoke && bwemMap.GetNearestArea(BWAPI::WalkPosition(*it)) == bunkerArea))
         {
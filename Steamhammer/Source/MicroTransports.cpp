@@ -156,7 +156,7 @@ void MicroTransports::maybeUnloadTroops()
 	
 	if ((transportHP < 50 || (_target.isValid() && _transportShip->getDistance(_target) < 300)) &&
 		_transportShip->canUnloadAtPosition(_transportShip->getPosition())
-        && bwebMap.usedTiles.find(BWAPI::TilePosition(_transportShip->getPosition())) == bwebMap.usedTiles.end())
+        && !bwebMap.occupancy.test(BWEB::Layers::Used | BWEB::Layers::Planned, BWAPI::TilePosition(_transportShip->getPosition())))
 	{
 		// get the unit's current command
 		BWAPI::UnitCommand currentCommand(_transportShip->getLastCommand());
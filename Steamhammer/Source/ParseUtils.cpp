@@ -89,7 +89,11 @@ void ParseUtils::ParseConfigFile(const std::string & filename)
     if (doc.HasMember("Macro") && doc["Macro"].IsObject())
     {
         const rapidjson::Value & macro = doc["Macro"];
-        JSONTools::ReadInt("BOSSFrameLimit", macro, Config::Macro::BOSSFrameLimit);
+        JSONTools::ReadInt("BOSSTimeLimit", macro, Config::Macro::BOSSTimeLimit);
+        JSONTools::ReadInt("BOSSSearchThreads", macro, Config::Macro::BOSSSearchThreads);
+        JSONTools::ReadInt("BOSSAcceptableGap", macro, Config::Macro::BOSSAcceptableGap);
+        JSONTools::ReadInt("BOSSRepairGoalDelta", macro, Config::Macro::BOSSRepairGoalDelta);
+        JSONTools::ReadInt("BlockSearchFrameBudget", macro, Config::Macro::BlockSearchFrameBudget);
         JSONTools::ReadInt("PylonSpacing", macro, Config::Macro::PylonSpacing);
 
 		Config::Macro::ProductionJamFrameLimit = GetIntByRace("ProductionJamFrameLimit", macro);
@@ -137,6 +141,8 @@ void ParseUtils::ParseConfigFile(const std::string & filename)
         const rapidjson::Value & tool = doc["Tools"];
 
         JSONTools::ReadInt("MapGridSize", tool, Config::Tools::MAP_GRID_SIZE);
+        JSONTools::ReadInt("PathServiceThreads", tool, Config::Tools::PathServiceThreads);
+        JSONTools::ReadBool("DumpMap", tool, Config::Tools::DumpMap);
     }
 
 	// Parse the IO options.
@@ -210,7 +210,7 @@ BWAPI::TilePosition PathFinding::NearbyPathfindingTile(BWAPI::TilePosition start
 
                 BWAPI::TilePosition tile = start + BWAPI::TilePosition(x, y);
                 if (!tile.isValid()) continue;
-                if (bwebMap.usedTilesGrid[tile.x][tile.y]) continue;
+                if (bwebMap.occupancy.test(BWEB::Layers::Used, tile)) continue;
                 if (!bwebMap.isWalkable(tile)) continue;
                 return tile;
             }
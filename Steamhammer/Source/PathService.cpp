@@ -0,0 +1,216 @@
+#include "Common.h"
+#include "PathService.h"
+
+using namespace UAlbertaBot;
+
+bool PathHandle::isReady() const
+{
+    return _future.valid() && _future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+PathService::PathService()
+    : _stopping(false)
+{
+}
+
+PathService::~PathService()
+{
+    stop();
+}
+
+PathService & PathService::Instance()
+{
+    static PathService instance;
+    return instance;
+}
+
+// With no threads, pending requests are processed on the frame thread in update().
+void PathService::start(int threads)
+{
+    // The service outlives a game, so forget anything left over from the last one
+    {
+        std::lock_guard<std::mutex> lock(_queueMutex);
+        _stopping = false;
+        _pending.clear();
+        _completed.clear();
+    }
+    _terrainChanges.clear();
+    _waitingForOccupancy.clear();
+
+    std::atomic_store(&_snapshot, PathSnapshot::Create());
+
+    for (int i = 0; i < threads; ++i)
+    {
+        _threads.push_back(std::thread(&PathService::workerLoop, this));
+    }
+}
+
+void PathService::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(_queueMutex);
+        _stopping = true;
+    }
+    _queueCondition.notify_all();
+
+    for (auto & thread : _threads)
+    {
+        if (thread.joinable()) thread.join();
+    }
+    _threads.clear();
+}
+
+// Only the footprint is recorded here. The new snapshot is made in update(), once per frame however many neutrals died.
+void PathService::onNeutralDestroyed(BWAPI::Unit unit)
+{
+    _terrainChanges.push_back({ unit->getInitialTilePosition(), BWAPI::TilePosition(unit->getType().tileWidth(), unit->getType().tileHeight()) });
+}
+
+void PathService::publishSnapshot()
+{
+    if (!_snapshot) return;
+
+    auto snapshot = _snapshot;
+    if (!_terrainChanges.empty())
+    {
+        snapshot = snapshot->withTerrainChanges(_terrainChanges);
+        _terrainChanges.clear();
+    }
+    if (!_waitingForOccupancy.empty() && snapshot->occupancyFrame() != BWAPI::Broodwar->getFrameCount())
+    {
+        snapshot = snapshot->withCurrentOccupancy();
+    }
+
+    if (snapshot != _snapshot)
+    {
+        std::atomic_store(&_snapshot, snapshot);
+    }
+}
+
+void PathService::workerLoop()
+{
+    while (true)
+    {
+        std::shared_ptr<Request> request;
+        {
+            std::unique_lock<std::mutex> lock(_queueMutex);
+            _queueCondition.wait(lock, [this] { return _stopping || !_pending.empty(); });
+            if (_stopping) return;
+
+            request = _pending.front();
+            _pending.pop_front();
+        }
+
+        auto snapshot = std::atomic_load(&_snapshot);
+        process(*snapshot, *request);
+
+        {
+            std::lock_guard<std::mutex> lock(_queueMutex);
+
+            // If the terrain changed while we were working, the result may be wrong: drop it and run the request again
+            if (std::atomic_load(&_snapshot)->terrainVersion() != snapshot->terrainVersion())
+            {
+                _pending.push_back(request);
+            }
+            else
+            {
+                _completed.push_back(request);
+            }
+        }
+    }
+}
+
+// Runs the request. This reads only the snapshot, so any number of workers can run at once.
+void PathService::process(const PathSnapshot & snapshot, Request & request) const
+{
+    request.result = PathResult();
+
+    switch (request.type)
+    {
+    case RequestType::GroundDistance:
+        request.result.length = snapshot.getGroundDistance(request.start, request.end, request.unitType, request.options);
+        break;
+
+    case RequestType::ChokePointPath:
+        request.result.chokePoints = snapshot.getChokePointPath(request.start, request.end, request.unitType, request.options, &request.result.length);
+        break;
+
+    case RequestType::GroundTileDistance:
+        request.result.length = snapshot.getGroundTileDistance(BWAPI::TilePosition(request.start), BWAPI::TilePosition(request.end));
+        break;
+
+    case RequestType::TilePath:
+        request.result.tiles = snapshot.findTilePath(BWAPI::TilePosition(request.start), BWAPI::TilePosition(request.end));
+        request.result.length = request.result.tiles.empty() ? -1 : (int)request.result.tiles.size();
+        break;
+    }
+}
+
+void PathService::update()
+{
+    publishSnapshot();
+
+    bool queuedTilePaths = !_waitingForOccupancy.empty();
+
+    std::vector<std::shared_ptr<Request>> completed;
+    {
+        std::lock_guard<std::mutex> lock(_queueMutex);
+
+        _pending.insert(_pending.end(), _waitingForOccupancy.begin(), _waitingForOccupancy.end());
+        _waitingForOccupancy.clear();
+
+        // If there are no workers, do the work here instead
+        if (_threads.empty() && _snapshot)
+        {
+            for (auto & request : _pending)
+            {
+                process(*_snapshot, *request);
+                _completed.push_back(request);
+            }
+            _pending.clear();
+        }
+
+        completed.swap(_completed);
+    }
+    if (queuedTilePaths) _queueCondition.notify_all();
+
+    for (auto & request : completed)
+    {
+        request->promise.set_value(request->result);
+        if (request->callback) request->callback(request->result);
+    }
+}
+
+PathHandle PathService::submit(
+    RequestType type,
+    BWAPI::Position start,
+    BWAPI::Position end,
+    BWAPI::UnitType unitType,
+    PathFinding::PathFindingOptions options,
+    Callback callback)
+{
+    auto request = std::make_shared<Request>();
+    request->type = type;
+    request->start = start;
+    request->end = end;
+    request->unitType = unitType;
+    request->options = options;
+    request->callback = callback;
+
+    PathHandle handle(request->promise.get_future().share());
+
+    // Tile paths depend on the buildings, so they wait for a snapshot of the occupancy at the next update
+    if (type == RequestType::TilePath)
+    {
+        _waitingForOccupancy.push_back(request);
+        return handle;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_queueMutex);
+        _pending.push_back(request);
+    }
+    _queueCondition.notify_one();
+
+    return handle;
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "Common.h"
+#include "PathFinding.h"
+#include "PathSnapshot.h"
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// Runs non-urgent path requests on background threads so they don't cause frame spikes.
+// Workers read only an immutable PathSnapshot of the map data, never BWAPI, BWEM or BWEB, so they run
+// while the bot is running and never make the frame thread wait. The frame thread publishes a new snapshot
+// in update() when the terrain or the BWEB occupancy has changed. A request that was answered from terrain
+// that has since changed is dropped and run again on the new snapshot.
+// Results are delivered on the frame thread in update().
+
+namespace UAlbertaBot
+{
+
+struct PathResult
+{
+    int                                 length;         // pixels, or tiles for GroundTileDistance requests; -1 if there is no path
+    BWEM::CPPath                        chokePoints;    // for ChokePointPath requests
+    std::vector<BWAPI::TilePosition>    tiles;          // for TilePath requests
+
+    PathResult() : length(-1) {};
+};
+
+// Future-style handle to the result of a path request.
+// The result becomes ready on the frame its request is completed, at the same time as its callback is run.
+class PathHandle
+{
+    std::shared_future<PathResult> _future;
+
+public:
+
+    PathHandle() {};
+    PathHandle(const std::shared_future<PathResult> & future) : _future(future) {};
+
+    bool                isValid() const { return _future.valid(); };
+    bool                isReady() const;
+    const PathResult &  get() const { return _future.get(); };
+};
+
+class PathService
+{
+public:
+
+    enum class RequestType
+    {
+        GroundDistance,         // PathFinding::GetGroundDistance
+        ChokePointPath,         // PathFinding::GetChokePointPath
+        GroundTileDistance,     // tile distance as in MapTools::getGroundTileDistance
+        TilePath                // BWEB::Map::findPath
+    };
+
+    typedef std::function<void(const PathResult &)> Callback;
+
+private:
+
+    struct Request
+    {
+        RequestType                         type;
+        BWAPI::Position                     start;
+        BWAPI::Position                     end;
+        BWAPI::UnitType                     unitType;
+        PathFinding::PathFindingOptions     options;
+        Callback                            callback;
+        std::promise<PathResult>            promise;
+        PathResult                          result;
+    };
+
+    std::vector<std::thread>                _threads;
+    std::deque<std::shared_ptr<Request>>    _pending;
+    std::vector<std::shared_ptr<Request>>   _completed;
+    std::mutex                              _queueMutex;        // guards _pending, _completed and _stopping
+    std::condition_variable                 _queueCondition;
+    bool                                    _stopping;
+
+    // Read with std::atomic_load by the workers, replaced with std::atomic_store by the frame thread
+    std::shared_ptr<const PathSnapshot>     _snapshot;
+
+    // Only accessed from the frame thread
+    std::vector<PathSnapshot::Footprint>    _terrainChanges;        // since the last snapshot
+    std::vector<std::shared_ptr<Request>>   _waitingForOccupancy;   // tile path requests, queued once the snapshot has this frame's occupancy
+
+    PathService();
+
+    void workerLoop();
+    void process(const PathSnapshot & snapshot, Request & request) const;
+    void publishSnapshot();
+
+public:
+
+    ~PathService();
+
+    static PathService & Instance();
+
+    // Takes the first snapshot, so call it after the map analysis is done
+    void start(int threads);
+    void stop();
+
+    // Call when BWEM has been told about a destroyed mineral or static building
+    void onNeutralDestroyed(BWAPI::Unit unit);
+
+    // Publishes a new snapshot if needed, then delivers completed results and runs their callbacks. Call once per frame.
+    void update();
+
+    // Counts the terrain changes seen by the snapshots, so callers can tell when cached results are out of date
+    int terrainVersion() const { return _snapshot ? _snapshot->terrainVersion() : 0; };
+
+    PathHandle submit(
+        RequestType type,
+        BWAPI::Position start,
+        BWAPI::Position end,
+        BWAPI::UnitType unitType = BWAPI::UnitTypes::Protoss_Dragoon,
+        PathFinding::PathFindingOptions options = PathFinding::PathFindingOptions::Default,
+        Callback callback = nullptr);
+
+    PathHandle getGroundTileDistance(BWAPI::Position start, BWAPI::Position end, Callback callback = nullptr)
+    {
+        return submit(RequestType::GroundTileDistance, start, end, BWAPI::UnitTypes::Protoss_Dragoon, PathFinding::PathFindingOptions::Default, callback);
+    };
+};
+
+}
@@ -0,0 +1,519 @@
+#include "Common.h"
+#include "PathSnapshot.h"
+#include "MapTools.h"
+
+#include <climits>
+#include <queue>
+
+namespace { auto & bwemMap = BWEM::Map::Instance(); }
+namespace { auto & bwebMap = BWEB::Map::Instance(); }
+
+using namespace UAlbertaBot;
+
+std::shared_ptr<const PathSnapshot> PathSnapshot::Create()
+{
+    auto staticData = std::make_shared<StaticData>();
+    staticData->width = BWAPI::Broodwar->mapWidth();
+    staticData->height = BWAPI::Broodwar->mapHeight();
+    staticData->walkable.resize(staticData->width * staticData->height);
+    staticData->bwebWalkable.resize(staticData->width * staticData->height);
+    for (int y = 0; y < staticData->height; ++y)
+    {
+        for (int x = 0; x < staticData->width; ++x)
+        {
+            staticData->walkable[y * staticData->width + x] = MapTools::Instance().isWalkable(BWAPI::TilePosition(x, y));
+            staticData->bwebWalkable[y * staticData->width + x] = BWEB::Map::isWalkable(BWAPI::TilePosition(x, y));
+        }
+    }
+    staticData->minChokeWidth = MapTools::Instance().getMinChokeWidth();
+    staticData->hasMineralWalkChokes = MapTools::Instance().hasMineralWalkChokes();
+    staticData->isPlasma = BWAPI::Broodwar->mapHash() == "6f5295624a7e3887470f3f2e14727b1411321a67";
+
+    auto terrain = std::make_shared<TerrainData>();
+    terrain->version = 0;
+    terrain->areaIds.resize(bwemMap.WalkSize().x * bwemMap.WalkSize().y);
+    for (int y = 0; y < bwemMap.WalkSize().y; ++y)
+    {
+        for (int x = 0; x < bwemMap.WalkSize().x; ++x)
+        {
+            terrain->areaIds[y * bwemMap.WalkSize().x + x] = bwemMap.GetMiniTile(BWAPI::WalkPosition(x, y)).AreaId();
+        }
+    }
+    copyGraph(*terrain);
+
+    std::shared_ptr<PathSnapshot> snapshot(new PathSnapshot());
+    snapshot->_static = staticData;
+    snapshot->_terrain = terrain;
+    snapshot->_occupancy = std::make_shared<BWEB::Occupancy>(bwebMap.occupancy);
+    snapshot->_occupancyFrame = BWAPI::Broodwar->getFrameCount();
+    return snapshot;
+}
+
+// Copies the areas and choke points, with the choke distances and paths between them.
+void PathSnapshot::copyGraph(TerrainData & terrain)
+{
+    int chokeCount = 0;
+    for (const auto & area : bwemMap.Areas())
+    {
+        for (auto choke : area.ChokePoints())
+        {
+            chokeCount = std::max(chokeCount, int(choke->Index()) + 1);
+        }
+    }
+
+    terrain.areas.assign(bwemMap.Areas().size() + 1, Area());
+    terrain.chokes.assign(chokeCount, Choke());
+    for (const auto & area : bwemMap.Areas())
+    {
+        auto & areaData = terrain.areas[area.Id()];
+        areaData.groupId = area.GroupId();
+
+        for (auto choke : area.ChokePoints())
+        {
+            areaData.chokes.push_back(choke->Index());
+
+            auto & chokeData = terrain.chokes[choke->Index()];
+            chokeData.choke = choke;
+            chokeData.center = choke->Center();
+            chokeData.end1 = BWEM::BWAPI_ext::center(choke->Pos(BWEM::ChokePoint::end1));
+            chokeData.end2 = BWEM::BWAPI_ext::center(choke->Pos(BWEM::ChokePoint::end2));
+            chokeData.areas[0] = choke->GetAreas().first->Id();
+            chokeData.areas[1] = choke->GetAreas().second->Id();
+            chokeData.blocked = choke->Blocked();
+            chokeData.width = ((ChokeData*)choke->Ext())->width;
+            chokeData.requiresMineralWalk = ((ChokeData*)choke->Ext())->requiresMineralWalk;
+        }
+    }
+
+    terrain.distances.assign(chokeCount * chokeCount, -1);
+    terrain.paths.assign(chokeCount * chokeCount, std::vector<int>());
+    for (const auto & from : terrain.chokes)
+    {
+        if (!from.choke) continue;
+
+        for (const auto & to : terrain.chokes)
+        {
+            if (!to.choke) continue;
+
+            int index = from.choke->Index() * chokeCount + to.choke->Index();
+            terrain.distances[index] = from.choke->DistanceFrom(to.choke);
+            for (auto choke : from.choke->GetPathTo(to.choke))
+            {
+                terrain.paths[index].push_back(choke->Index());
+            }
+        }
+    }
+}
+
+// BWEM changes the area ids only inside the footprint of a destroyed neutral, so only they are copied again.
+// The graph is small and is copied whole.
+std::shared_ptr<const PathSnapshot> PathSnapshot::withTerrainChanges(const std::vector<Footprint> & footprints) const
+{
+    auto terrain = std::make_shared<TerrainData>();
+    terrain->version = _terrain->version + 1;
+    terrain->areaIds = _terrain->areaIds;
+    for (const auto & footprint : footprints)
+    {
+        int left = std::max(0, 4 * footprint.topLeft.x);
+        int top = std::max(0, 4 * footprint.topLeft.y);
+        int right = std::min(walkWidth(), 4 * (footprint.topLeft.x + footprint.size.x));
+        int bottom = std::min(walkHeight(), 4 * (footprint.topLeft.y + footprint.size.y));
+        for (int y = top; y < bottom; ++y)
+        {
+            for (int x = left; x < right; ++x)
+            {
+                terrain->areaIds[y * walkWidth() + x] = bwemMap.GetMiniTile(BWAPI::WalkPosition(x, y)).AreaId();
+            }
+        }
+    }
+    copyGraph(*terrain);
+
+    std::shared_ptr<PathSnapshot> snapshot(new PathSnapshot(*this));
+    snapshot->_terrain = terrain;
+    return snapshot;
+}
+
+std::shared_ptr<const PathSnapshot> PathSnapshot::withCurrentOccupancy() const
+{
+    std::shared_ptr<PathSnapshot> snapshot(new PathSnapshot(*this));
+    snapshot->_occupancy = std::make_shared<BWEB::Occupancy>(bwebMap.occupancy);
+    snapshot->_occupancyFrame = BWAPI::Broodwar->getFrameCount();
+    return snapshot;
+}
+
+// As BWEM::Map::GetArea, 0 if none.
+int PathSnapshot::getArea(BWAPI::WalkPosition walk) const
+{
+    if (walk.x < 0 || walk.y < 0 || walk.x >= walkWidth() || walk.y >= walkHeight()) return 0;
+
+    int id = _terrain->areaIds[walk.y * walkWidth() + walk.x];
+    return id > 0 ? id : 0;
+}
+
+// As BWEM::Map::GetNearestArea, an 8-connected breadth-first search for a walk tile inside an area.
+int PathSnapshot::getNearestArea(BWAPI::WalkPosition walk) const
+{
+    if (int area = getArea(walk)) return area;
+
+    static const BWAPI::WalkPosition directions[] = {
+        BWAPI::WalkPosition(-1, -1), BWAPI::WalkPosition(0, -1), BWAPI::WalkPosition(1, -1),
+        BWAPI::WalkPosition(-1, 0), BWAPI::WalkPosition(1, 0),
+        BWAPI::WalkPosition(-1, 1), BWAPI::WalkPosition(0, 1), BWAPI::WalkPosition(1, 1) };
+
+    std::vector<bool> visited(walkWidth() * walkHeight(), false);
+    std::queue<BWAPI::WalkPosition> toVisit;
+    if (walk.x >= 0 && walk.y >= 0 && walk.x < walkWidth() && walk.y < walkHeight())
+    {
+        visited[walk.y * walkWidth() + walk.x] = true;
+    }
+    toVisit.push(walk);
+
+    while (!toVisit.empty())
+    {
+        BWAPI::WalkPosition current = toVisit.front();
+        toVisit.pop();
+
+        for (const auto & direction : directions)
+        {
+            BWAPI::WalkPosition next = current + direction;
+            if (next.x < 0 || next.y < 0 || next.x >= walkWidth() || next.y >= walkHeight()) continue;
+
+            if (int area = getArea(next)) return area;
+
+            if (!visited[next.y * walkWidth() + next.x])
+            {
+                visited[next.y * walkWidth() + next.x] = true;
+                toVisit.push(next);
+            }
+        }
+    }
+
+    return 0;
+}
+
+int PathSnapshot::chokeTo(const Choke & choke, int fromArea) const
+{
+    return fromArea == choke.areas[0] ? choke.areas[1] : choke.areas[0];
+}
+
+// As validChoke in PathFinding.cpp.
+bool PathSnapshot::validChoke(const Choke & choke, int minChokeWidth, bool allowMineralWalk) const
+{
+    if (choke.width < minChokeWidth) return false;
+    if (allowMineralWalk && choke.requiresMineralWalk) return true;
+    return !choke.blocked && !choke.requiresMineralWalk;
+}
+
+BWEM::CPPath PathSnapshot::toCPPath(const std::vector<int> & chokes) const
+{
+    BWEM::CPPath path;
+    for (int choke : chokes)
+    {
+        path.push_back(_terrain->chokes[choke].choke);
+    }
+    return path;
+}
+
+// As BWEM::Map::GetPath.
+BWEM::CPPath PathSnapshot::bwemPath(BWAPI::Position start, BWAPI::Position end, int * pathLength) const
+{
+    if (pathLength) *pathLength = -1;
+
+    int startArea = getNearestArea(BWAPI::WalkPosition(start));
+    int endArea = getNearestArea(BWAPI::WalkPosition(end));
+    if (!startArea || !endArea) return {};
+
+    if (startArea == endArea)
+    {
+        if (pathLength) *pathLength = start.getApproxDistance(end);
+        return {};
+    }
+
+    if (_terrain->areas[startArea].groupId != _terrain->areas[endArea].groupId) return {};
+
+    int chokeCount = _terrain->chokes.size();
+    int bestDist = INT_MAX;
+    int bestStart = -1;
+    int bestEnd = -1;
+    for (int startIndex : _terrain->areas[startArea].chokes)
+    {
+        const auto & startChoke = _terrain->chokes[startIndex];
+        if (startChoke.blocked) continue;
+
+        int startDist = start.getApproxDistance(BWAPI::Position(startChoke.center));
+        for (int endIndex : _terrain->areas[endArea].chokes)
+        {
+            const auto & endChoke = _terrain->chokes[endIndex];
+            if (endChoke.blocked) continue;
+
+            int chokeDist = _terrain->distances[startIndex * chokeCount + endIndex];
+            if (chokeDist < 0) continue;
+
+            int dist = startDist + end.getApproxDistance(BWAPI::Position(endChoke.center)) + chokeDist;
+            if (dist < bestDist)
+            {
+                bestDist = dist;
+                bestStart = startIndex;
+                bestEnd = endIndex;
+            }
+        }
+    }
+
+    if (bestStart < 0) return {};
+
+    const auto & path = _terrain->paths[bestStart * chokeCount + bestEnd];
+    if (pathLength)
+    {
+        *pathLength = bestDist;
+
+        if (path.size() == 1)
+        {
+            const auto & choke = _terrain->chokes[bestStart];
+            if (BWEM::utils::intersect(start.x, start.y, end.x, end.y, choke.end1.x, choke.end1.y, choke.end2.x, choke.end2.y))
+            {
+                *pathLength = start.getApproxDistance(end);
+            }
+            else
+            {
+                for (const auto & chokeEnd : { choke.end1, choke.end2 })
+                {
+                    int dist = start.getApproxDistance(chokeEnd) + end.getApproxDistance(chokeEnd);
+                    if (dist < *pathLength) *pathLength = dist;
+                }
+            }
+        }
+    }
+
+    return toCPPath(path);
+}
+
+// As CustomChokePointPath in PathFinding.cpp, a Dijkstra search over the valid chokes.
+BWEM::CPPath PathSnapshot::customChokePointPath(
+    BWAPI::Position start,
+    BWAPI::Position end,
+    bool useNearestBWEMArea,
+    BWAPI::UnitType unitType,
+    int * pathLength) const
+{
+    if (pathLength) *pathLength = -1;
+
+    int startArea = useNearestBWEMArea ? getNearestArea(BWAPI::WalkPosition(start)) : getArea(BWAPI::WalkPosition(start));
+    int targetArea = useNearestBWEMArea ? getNearestArea(BWAPI::WalkPosition(end)) : getArea(BWAPI::WalkPosition(end));
+    if (!startArea || !targetArea) return {};
+
+    if (startArea == targetArea)
+    {
+        if (pathLength) *pathLength = start.getApproxDistance(end);
+        return {};
+    }
+
+    struct Node
+    {
+        int choke;
+        int dist;
+        int toArea;
+        int parent;
+    };
+
+    auto cmp = [](const Node & left, const Node & right) { return left.dist > right.dist; };
+    std::priority_queue<Node, std::vector<Node>, decltype(cmp)> nodeQueue(cmp);
+    for (int index : _terrain->areas[startArea].chokes)
+    {
+        const auto & choke = _terrain->chokes[index];
+        if (validChoke(choke, unitType.width(), unitType.isWorker()))
+        {
+            nodeQueue.push({ index, start.getApproxDistance(BWAPI::Position(choke.center)), chokeTo(choke, startArea), -1 });
+        }
+    }
+
+    // -2 for chokes not reached yet
+    std::vector<int> parents(_terrain->chokes.size(), -2);
+
+    while (!nodeQueue.empty())
+    {
+        Node current = nodeQueue.top();
+        nodeQueue.pop();
+
+        if (parents[current.choke] != -2) continue;
+        parents[current.choke] = current.parent;
+
+        const auto & currentChoke = _terrain->chokes[current.choke];
+        if (current.toArea == targetArea)
+        {
+            if (pathLength) *pathLength = current.dist + currentChoke.center.getApproxDistance(BWAPI::WalkPosition(end));
+
+            std::vector<int> path;
+            for (int choke = current.choke; choke >= 0; choke = parents[choke])
+            {
+                path.push_back(choke);
+            }
+            std::reverse(path.begin(), path.end());
+            return toCPPath(path);
+        }
+
+        for (int index : _terrain->areas[current.toArea].chokes)
+        {
+            const auto & choke = _terrain->chokes[index];
+            if (validChoke(choke, unitType.width(), unitType.isWorker()) && parents[index] == -2)
+            {
+                nodeQueue.push({ index, current.dist + choke.center.getApproxDistance(currentChoke.center), chokeTo(choke, current.toArea), current.choke });
+            }
+        }
+    }
+
+    return {};
+}
+
+int PathSnapshot::getGroundDistance(BWAPI::Position start, BWAPI::Position end, BWAPI::UnitType unitType, PathFinding::PathFindingOptions options) const
+{
+    bool useNearestBWEMArea = ((int)options & (int)PathFinding::PathFindingOptions::UseNearestBWEMArea) != 0;
+
+    if (!useNearestBWEMArea && (!getArea(BWAPI::WalkPosition(start)) || !getArea(BWAPI::WalkPosition(end))))
+        return start.getApproxDistance(end);
+
+    int dist;
+    getChokePointPath(start, end, unitType, options, &dist);
+    return dist;
+}
+
+BWEM::CPPath PathSnapshot::getChokePointPath(
+    BWAPI::Position start,
+    BWAPI::Position end,
+    BWAPI::UnitType unitType,
+    PathFinding::PathFindingOptions options,
+    int * pathLength) const
+{
+    if (pathLength) *pathLength = -1;
+
+    bool useNearestBWEMArea = ((int)options & (int)PathFinding::PathFindingOptions::UseNearestBWEMArea) != 0;
+
+    if (!useNearestBWEMArea && (!getArea(BWAPI::WalkPosition(start)) || !getArea(BWAPI::WalkPosition(end))))
+        return {};
+
+    auto path = bwemPath(start, end, pathLength);
+
+    // See PathFinding::GetChokePointPath for when the BWEM path is good enough
+    bool canUseBwemPath = std::max(unitType.width(), unitType.height()) <= _static->minChokeWidth;
+    if (_static->isPlasma)
+    {
+        canUseBwemPath = canUseBwemPath && unitType.isWorker();
+    }
+    else
+    {
+        canUseBwemPath = canUseBwemPath && (!_static->hasMineralWalkChokes || !unitType.isWorker());
+    }
+
+    if (!canUseBwemPath && !path.empty())
+    {
+        canUseBwemPath = true;
+        for (auto choke : path)
+        {
+            if (!validChoke(_terrain->chokes[choke->Index()], unitType.width(), unitType.isWorker()))
+            {
+                canUseBwemPath = false;
+                break;
+            }
+        }
+    }
+
+    if (canUseBwemPath)
+        return path;
+
+    return customChokePointPath(start, end, useNearestBWEMArea, unitType, pathLength);
+}
+
+// As DistanceMap(end).getDistance(start), but stops as soon as the start is reached.
+int PathSnapshot::getGroundTileDistance(BWAPI::TilePosition start, BWAPI::TilePosition end) const
+{
+    const int width = _static->width;
+    const int height = _static->height;
+    auto inMap = [&](BWAPI::TilePosition tile) { return tile.x >= 0 && tile.y >= 0 && tile.x < width && tile.y < height; };
+
+    if (!inMap(start) || !inMap(end)) return -1;
+    if (start == end) return 0;
+
+    static const BWAPI::TilePosition directions[] = {
+        BWAPI::TilePosition(1, 0), BWAPI::TilePosition(-1, 0), BWAPI::TilePosition(0, 1), BWAPI::TilePosition(0, -1) };
+
+    std::vector<short> dist(width * height, -1);
+    std::vector<BWAPI::TilePosition> fringe;
+    fringe.reserve(width * height);
+    fringe.push_back(end);
+    dist[end.y * width + end.x] = 0;
+
+    for (size_t fringeIndex = 0; fringeIndex < fringe.size(); ++fringeIndex)
+    {
+        const BWAPI::TilePosition tile = fringe[fringeIndex];
+        for (const auto & direction : directions)
+        {
+            BWAPI::TilePosition next = tile + direction;
+            if (!inMap(next) || dist[next.y * width + next.x] != -1 || !_static->walkable[next.y * width + next.x]) continue;
+
+            dist[next.y * width + next.x] = dist[tile.y * width + tile.x] + 1;
+            if (next == start) return dist[next.y * width + next.x];
+
+            fringe.push_back(next);
+        }
+    }
+
+    return -1;
+}
+
+// As BWEB::Map::findPath with the default options, a breadth-first search avoiding used, overlap and unwalkable tiles.
+// The path is returned in the same order and with the same ends as BWEB's.
+std::vector<BWAPI::TilePosition> PathSnapshot::findTilePath(BWAPI::TilePosition start, BWAPI::TilePosition end) const
+{
+    if (start == end) return { start };
+
+    const int width = _static->width;
+    const int height = _static->height;
+    auto collision = [&](BWAPI::TilePosition tile) {
+        return tile.x < 0 || tile.y < 0 || tile.x >= width || tile.y >= height
+            || _occupancy->test(BWEB::Layers::Used | BWEB::Layers::Overlap, tile)
+            || !_static->bwebWalkable[tile.y * width + tile.x];
+    };
+
+    static const BWAPI::TilePosition directions[] = {
+        BWAPI::TilePosition(0, 1), BWAPI::TilePosition(1, 0), BWAPI::TilePosition(-1, 0), BWAPI::TilePosition(0, -1) };
+
+    // The parent of each tile once it is visited, the start is its own parent
+    std::vector<BWAPI::TilePosition> parents(width * height, BWAPI::TilePositions::None);
+    auto parentOf = [&](BWAPI::TilePosition tile) -> BWAPI::TilePosition & { return parents[tile.y * width + tile.x]; };
+
+    if (start.x < 0 || start.y < 0 || start.x >= width || start.y >= height) return {};
+
+    std::queue<std::pair<BWAPI::TilePosition, BWAPI::TilePosition>> nodeQueue;     // tile, parent
+    nodeQueue.emplace(start, start);
+
+    while (!nodeQueue.empty())
+    {
+        auto current = nodeQueue.front();
+        nodeQueue.pop();
+
+        if (current.first == end)
+        {
+            std::vector<BWAPI::TilePosition> path;
+            path.push_back(end);
+            BWAPI::TilePosition check = current.second;
+            do
+            {
+                path.push_back(check);
+                check = parentOf(check);
+            } while (check != start);
+            return path;
+        }
+
+        if (parentOf(current.first) != BWAPI::TilePositions::None) continue;
+        parentOf(current.first) = current.second;
+
+        for (const auto & direction : directions)
+        {
+            BWAPI::TilePosition next = current.first + direction;
+            if (collision(next) || parentOf(next) != BWAPI::TilePositions::None) continue;
+
+            nodeQueue.emplace(next, current.first);
+        }
+    }
+
+    return {};
+}
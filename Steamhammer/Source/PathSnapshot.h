@@ -0,0 +1,110 @@
+#pragma once
+
+#include "Common.h"
+#include "PathFinding.h"
+
+#include <memory>
+
+// An immutable copy of the map data that path requests need, so they can run on worker threads
+// without reading BWAPI, BWEM or BWEB while the frame thread is changing them.
+// The frame thread publishes a new snapshot when the data changes. The new snapshot shares
+// whatever did not change with the old one, so workers still holding the old snapshot are not disturbed.
+
+namespace UAlbertaBot
+{
+
+class PathSnapshot
+{
+public:
+
+    // A tile rectangle whose terrain changed, usually the footprint of a destroyed neutral
+    struct Footprint
+    {
+        BWAPI::TilePosition topLeft;
+        BWAPI::TilePosition size;
+    };
+
+private:
+
+    // Fixed for the whole game
+    struct StaticData
+    {
+        int                 width;                  // in tiles
+        int                 height;
+        std::vector<bool>   walkable;               // MapTools::isWalkable by tile
+        std::vector<bool>   bwebWalkable;           // BWEB::Map::isWalkable by tile
+        int                 minChokeWidth;
+        bool                hasMineralWalkChokes;
+        bool                isPlasma;
+    };
+
+    struct Choke
+    {
+        const BWEM::ChokePoint *    choke;
+        BWAPI::WalkPosition         center;
+        BWAPI::Position             end1;           // center of the end walk tiles, as BWEM uses them
+        BWAPI::Position             end2;
+        int                         areas[2];       // area ids
+        bool                        blocked;
+        int                         width;          // from ChokeData
+        bool                        requiresMineralWalk;
+    };
+
+    struct Area
+    {
+        int                 groupId;
+        std::vector<int>    chokes;                 // choke indexes
+    };
+
+    // The BWEM areas and choke points, which change when a blocking neutral is destroyed
+    struct TerrainData
+    {
+        int                             version;
+        std::vector<short>              areaIds;    // BWEM area id by walk tile, > 0 inside an area
+        std::vector<Area>               areas;      // by area id, 0 is unused
+        std::vector<Choke>              chokes;     // by BWEM choke point index
+        std::vector<int>                distances;  // BWEM ground distance between each pair of chokes
+        std::vector<std::vector<int>>   paths;      // BWEM choke path between each pair of chokes
+    };
+
+    std::shared_ptr<const StaticData>       _static;
+    std::shared_ptr<const TerrainData>      _terrain;
+    std::shared_ptr<const BWEB::Occupancy>  _occupancy;
+    int                                     _occupancyFrame;
+
+    PathSnapshot() {};
+
+    static void copyGraph(TerrainData & terrain);
+
+    int     walkWidth() const { return 4 * _static->width; };
+    int     walkHeight() const { return 4 * _static->height; };
+    int     getArea(BWAPI::WalkPosition walk) const;
+    int     getNearestArea(BWAPI::WalkPosition walk) const;
+    int     chokeTo(const Choke & choke, int fromArea) const;
+    bool    validChoke(const Choke & choke, int minChokeWidth, bool allowMineralWalk) const;
+
+    BWEM::CPPath    toCPPath(const std::vector<int> & chokes) const;
+    BWEM::CPPath    bwemPath(BWAPI::Position start, BWAPI::Position end, int * pathLength) const;
+    BWEM::CPPath    customChokePointPath(BWAPI::Position start, BWAPI::Position end, bool useNearestBWEMArea, BWAPI::UnitType unitType, int * pathLength) const;
+
+public:
+
+    // Copies the live map data. Call on the frame thread after the map analysis is done.
+    static std::shared_ptr<const PathSnapshot> Create();
+
+    // Copies of this snapshot with fresh BWEM data for the changed terrain, or with the current BWEB occupancy.
+    // Call on the frame thread.
+    std::shared_ptr<const PathSnapshot> withTerrainChanges(const std::vector<Footprint> & footprints) const;
+    std::shared_ptr<const PathSnapshot> withCurrentOccupancy() const;
+
+    int     terrainVersion() const { return _terrain->version; };
+    int     occupancyFrame() const { return _occupancyFrame; };
+
+    // The same results as the functions they copy, but read only the snapshot
+    int                 getGroundDistance(BWAPI::Position start, BWAPI::Position end, BWAPI::UnitType unitType, PathFinding::PathFindingOptions options) const;
+    BWEM::CPPath        getChokePointPath(BWAPI::Position start, BWAPI::Position end, BWAPI::UnitType unitType, PathFinding::PathFindingOptions options, int * pathLength) const;
+    int                 getGroundTileDistance(BWAPI::TilePosition start, BWAPI::TilePosition end) const;    // DistanceMap
+    std::vector<BWAPI::TilePosition> findTilePath(BWAPI::TilePosition start, BWAPI::TilePosition end) const;  // BWEB::Map::findPath
+};
+
+}
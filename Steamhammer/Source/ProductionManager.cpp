@@ -944,6 +944,7 @@ void ProductionManager::executeCommand(MacroCommand command)
 	else if (cmd == MacroCommandType::Proxying)
 	{
 		StrategyManager::Instance().setProxying();
+		BuildingPlacer::Instance().findProxyBlocks();
 	}
 	else if (cmd == MacroCommandType::PullWorkers)
 	{
@@ -231,6 +231,10 @@ void ScoutManager::update()
 	{
         calculateEnemyRegionVertices();
     }
+    else if (!_naturalSpliceDistances.empty())
+    {
+        spliceEnemyNaturalVertices();
+    }
 
 	// Do the actual scouting. Also steal gas if called for.
 	setScoutTargets();
@@ -307,6 +311,10 @@ void ScoutManager::setWorkerScout(BWAPI::Unit unit)
 
     _workerScout = unit;
     WorkerManager::Instance().setScoutWorker(_workerScout);
+
+    // Distances from the old scout are no use
+    _scoutDistanceRequest = PathHandle();
+    _scoutDistance = PathHandle();
 }
 
 // Send the worker scout home.
@@ -391,7 +399,19 @@ void ScoutManager::moveGroundScout(BWAPI::Unit scout)
 
 		UAB_ASSERT(enemyBaseLocation, "no enemy base");
 
-		int scoutDistanceToEnemy = MapTools::Instance().getGroundTileDistance(scout->getPosition(), enemyBaseLocation->getPosition());
+		// The ground distance is computed in the background, so it is a few frames out of date.
+		// Until the first one is in, use the air distance.
+		if (_scoutDistanceRequest.isReady())
+		{
+			_scoutDistance = _scoutDistanceRequest;
+		}
+		if (!_scoutDistanceRequest.isValid() || _scoutDistanceRequest.isReady())
+		{
+			_scoutDistanceRequest = PathService::Instance().getGroundTileDistance(scout->getPosition(), enemyBaseLocation->getPosition());
+		}
+		int scoutDistanceToEnemy = _scoutDistance.isValid()
+			? _scoutDistance.get().length
+			: scout->getDistance(enemyBaseLocation->getPosition()) / 32;
 		bool scoutInRangeOfenemy = scoutDistanceToEnemy <= scoutDistanceThreshold;
 
 		// we only care if the scout is under attack within the enemy region
@@ -741,62 +761,90 @@ void ScoutManager::calculateEnemyRegionVertices()
     BWTA::BaseLocation * enemyBaseLocation = InformationManager::Instance().getEnemyMainBaseLocation();
     if (!enemyBaseLocation) return;
 
-    std::vector<BWAPI::Position> enemyMainVertices = calculateScoutVerticesForBase(enemyBaseLocation);
-    std::vector<BWAPI::Position> enemyNaturalVertices = calculateScoutVerticesForBase(InformationManager::Instance().getEnemyNaturalLocation());
+    _enemyRegionVertices = calculateScoutVerticesForBase(enemyBaseLocation);
+    _enemyNaturalVertices = calculateScoutVerticesForBase(InformationManager::Instance().getEnemyNaturalLocation());
 
-    // Splice the two together where they have vertices closest to each other
-    if (!enemyMainVertices.empty() && !enemyNaturalVertices.empty())
+    // The natural is spliced in where the two have vertices closest to each other.
+    // The ground distances are computed in the background. Until they are in, we circle only the main.
+    _naturalSpliceDistances.clear();
+    if (!_enemyRegionVertices.empty() && !_enemyNaturalVertices.empty())
     {
-        int bestDist = INT_MAX;
-        std::vector<BWAPI::Position>::iterator bestMain = enemyMainVertices.end();
-        std::vector<BWAPI::Position>::iterator bestNatural = enemyNaturalVertices.end();
-        for (auto mainIt = enemyMainVertices.begin(); mainIt != enemyMainVertices.end(); mainIt++)
-            for (auto naturalIt = enemyNaturalVertices.begin(); naturalIt != enemyNaturalVertices.end(); naturalIt++)
-            {
-                int dist = PathFinding::GetGroundDistance(*mainIt, *naturalIt, BWAPI::UnitTypes::Protoss_Probe, PathFinding::PathFindingOptions::UseNearestBWEMArea);
-                if (dist < bestDist)
-                {
-                    bestDist = dist;
-                    bestMain = mainIt;
-                    bestNatural = naturalIt;
-                }
-            }
+        for (const auto & mainVertex : _enemyRegionVertices)
+            for (const auto & naturalVertex : _enemyNaturalVertices)
+                _naturalSpliceDistances.push_back(PathService::Instance().submit(
+                    PathService::RequestType::GroundDistance,
+                    mainVertex,
+                    naturalVertex,
+                    BWAPI::UnitTypes::Protoss_Probe,
+                    PathFinding::PathFindingOptions::UseNearestBWEMArea));
+    }
 
-        if (bestMain != enemyMainVertices.end() && bestNatural != enemyNaturalVertices.end())
+    // Set the initial index to the vertex closest to the enemy main, so we get scouting information as soon as possible
+    double bestDist = 1000000;
+    for (size_t i = 0; i < _enemyRegionVertices.size(); i++)
+    {
+        double dist = _enemyRegionVertices[i].getDistance(enemyBaseLocation->getPosition());
+        if (dist < bestDist)
         {
-            std::vector<BWAPI::Position> result;
-            for (auto mainIt = enemyMainVertices.begin(); mainIt != enemyMainVertices.end(); mainIt++)
-            {
-                result.push_back(*mainIt);
-                if (mainIt != bestMain) continue;
+            bestDist = dist;
+            _currentRegionVertexIndex = i;
+        }
+    }
+}
 
-                for (auto naturalIt = bestNatural; naturalIt != enemyNaturalVertices.end(); naturalIt++)
-                    result.push_back(*naturalIt);
+// Splice the enemy natural's vertices into the main's once all the distances between them are in.
+void ScoutManager::spliceEnemyNaturalVertices()
+{
+    for (const auto & distance : _naturalSpliceDistances)
+    {
+        if (!distance.isReady()) return;
+    }
 
-                for (auto naturalIt = enemyNaturalVertices.begin(); naturalIt != bestNatural; naturalIt++)
-                    result.push_back(*naturalIt);
+    std::vector<BWAPI::Position> & enemyMainVertices = _enemyRegionVertices;
+    std::vector<BWAPI::Position> & enemyNaturalVertices = _enemyNaturalVertices;
 
-                result.push_back(*bestNatural);
-                result.push_back(*bestMain);
+    int bestDist = INT_MAX;
+    std::vector<BWAPI::Position>::iterator bestMain = enemyMainVertices.end();
+    std::vector<BWAPI::Position>::iterator bestNatural = enemyNaturalVertices.end();
+    auto distanceIt = _naturalSpliceDistances.begin();
+    for (auto mainIt = enemyMainVertices.begin(); mainIt != enemyMainVertices.end(); mainIt++)
+        for (auto naturalIt = enemyNaturalVertices.begin(); naturalIt != enemyNaturalVertices.end(); naturalIt++, distanceIt++)
+        {
+            int dist = distanceIt->get().length;
+            if (dist < bestDist)
+            {
+                bestDist = dist;
+                bestMain = mainIt;
+                bestNatural = naturalIt;
             }
-
-            enemyMainVertices = result;
         }
-    }
-
-    _enemyRegionVertices = enemyMainVertices;
 
-    // Set the initial index to the vertex closest to the enemy main, so we get scouting information as soon as possible
-    double bestDist = 1000000;
-    for (size_t i = 0; i < enemyMainVertices.size(); i++)
+    if (bestMain != enemyMainVertices.end() && bestNatural != enemyNaturalVertices.end())
     {
-        double dist = enemyMainVertices[i].getDistance(enemyBaseLocation->getPosition());
-        if (dist < bestDist)
+        std::vector<BWAPI::Position> result;
+        for (auto mainIt = enemyMainVertices.begin(); mainIt != enemyMainVertices.end(); mainIt++)
         {
-            bestDist = dist;
-            _currentRegionVertexIndex = i;
+            result.push_back(*mainIt);
+            if (mainIt != bestMain) continue;
+
+            for (auto naturalIt = bestNatural; naturalIt != enemyNaturalVertices.end(); naturalIt++)
+                result.push_back(*naturalIt);
+
+            for (auto naturalIt = enemyNaturalVertices.begin(); naturalIt != bestNatural; naturalIt++)
+                result.push_back(*naturalIt);
+
+            result.push_back(*bestNatural);
+            result.push_back(*bestMain);
         }
+
+        // Keep heading for the same vertex
+        BWAPI::Position currentVertex = _enemyRegionVertices[_currentRegionVertexIndex];
+        _enemyRegionVertices = result;
+        _currentRegionVertexIndex = int(std::find(result.begin(), result.end(), currentVertex) - result.begin());
     }
+
+    _enemyNaturalVertices.clear();
+    _naturalSpliceDistances.clear();
 }
 
 std::vector<BWAPI::Position> ScoutManager::calculateScoutVerticesForBase(BWTA::BaseLocation * base) 
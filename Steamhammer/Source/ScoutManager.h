@@ -4,6 +4,7 @@
 #include "MacroCommand.h"
 #include "MicroManager.h"
 #include "InformationManager.h"
+#include "PathService.h"
 
 namespace UAlbertaBot
 {
@@ -53,6 +54,10 @@ class ScoutManager
     int                             _currentRegionVertexIndex;
     int                             _previousScoutHP;
 	std::vector<BWAPI::Position>    _enemyRegionVertices;
+	std::vector<BWAPI::Position>    _enemyNaturalVertices;     // waiting to be spliced into _enemyRegionVertices
+	std::vector<PathHandle>         _naturalSpliceDistances;   // from each main vertex to each natural vertex
+	PathHandle                      _scoutDistanceRequest;     // worker scout to enemy main, in flight
+	PathHandle                      _scoutDistance;            // the latest one that is in
 	int								_enemyBaseLastSeen;
 
 	PylonHarassStates				_pylonHarassState;
@@ -74,6 +79,7 @@ class ScoutManager
 	void                            moveAirScout(BWAPI::Unit scout);
 	void                            drawScoutInformation(int x, int y);
     void                            calculateEnemyRegionVertices();
+    void                            spliceEnemyNaturalVertices();
     std::vector<BWAPI::Position>    calculateScoutVerticesForBase(BWTA::BaseLocation * base);
     void                            updatePylonHarassState();
 	bool							pylonHarass();
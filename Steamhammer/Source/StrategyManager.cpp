@@ -1101,7 +1101,7 @@ void SetWallCannons(BuildOrderQueue & queue, int numCannons)
     int builtCannons = 0;
     for (auto it = cannonPlacements.begin(); it != cannonPlacements.end(); )
     {
-        if (bwebMap.usedTiles.find(*it) != bwebMap.usedTiles.end() ||
+        if (bwebMap.occupancy.test(BWEB::Layers::Used | BWEB::Layers::Planned, *it) ||
             queuedCannonPlacements.find(*it) != queuedCannonPlacements.end())
         {
             builtCannons++;
@@ -1152,7 +1152,7 @@ void SetWallCannons(BuildOrderQueue & queue, int numCannons)
     for (int i = 0; i < (numCannons - builtCannons) && i < cannonPlacements.size(); i++)
     {
         // Queue if there is not already a cannon at this location
-        if (bwebMap.usedTiles.find(cannonPlacements[i]) == bwebMap.usedTiles.end())
+        if (!bwebMap.occupancy.test(BWEB::Layers::Used | BWEB::Layers::Planned, cannonPlacements[i]))
         {
             MacroAct thisCannon(BWAPI::UnitTypes::Protoss_Photon_Cannon);
             thisCannon.setReservedPosition(cannonPlacements[i]);
@@ -0,0 +1,77 @@
+#include "SummedAreaTable.h"
+
+#include <algorithm>
+
+using namespace UAlbertaBot;
+
+SummedAreaTable::SummedAreaTable()
+    : _width(0)
+    , _height(0)
+    , _sums(1, 0)
+{
+}
+
+SummedAreaTable::SummedAreaTable(int width, int height)
+    : _width(width)
+    , _height(height)
+    , _flags(width * height, 0)
+    , _sums((width + 1) * (height + 1), 0)
+{
+}
+
+void SummedAreaTable::update(int left, int top)
+{
+    // Row 0 and column 0 of the sums stay 0
+    for (int y = top; y < _height; y++)
+    {
+        int rowSum = 0;
+        for (int x = 0; x < left; x++)
+            rowSum += _flags[flagIndex(x, y)];
+
+        for (int x = left; x < _width; x++)
+        {
+            rowSum += _flags[flagIndex(x, y)];
+            _sums[sumIndex(x + 1, y + 1)] = _sums[sumIndex(x + 1, y)] + rowSum;
+        }
+    }
+}
+
+bool SummedAreaTable::get(int x, int y) const
+{
+    if (x < 0 || y < 0 || x >= _width || y >= _height) return false;
+
+    return _flags[flagIndex(x, y)] != 0;
+}
+
+void SummedAreaTable::set(int x, int y, int width, int height, bool value)
+{
+    int left = std::max(0, x);
+    int top = std::max(0, y);
+    int right = std::min(_width, x + width);
+    int bottom = std::min(_height, y + height);
+
+    bool changed = false;
+    for (int ty = top; ty < bottom; ty++)
+        for (int tx = left; tx < right; tx++)
+        {
+            unsigned char & flag = _flags[flagIndex(tx, ty)];
+            if (flag != (value ? 1 : 0))
+            {
+                flag = value ? 1 : 0;
+                changed = true;
+            }
+        }
+
+    if (changed) update(left, top);
+}
+
+int SummedAreaTable::count(int x, int y, int width, int height) const
+{
+    int left = std::max(0, x);
+    int top = std::max(0, y);
+    int right = std::min(_width, x + width);
+    int bottom = std::min(_height, y + height);
+    if (left >= right || top >= bottom) return 0;
+
+    return _sums[sumIndex(right, bottom)] - _sums[sumIndex(left, bottom)] - _sums[sumIndex(right, top)] + _sums[sumIndex(left, top)];
+}
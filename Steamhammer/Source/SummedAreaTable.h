@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vector>
+
+namespace UAlbertaBot
+{
+
+// A grid of flags with a summed-area table over it, so the flags set in any rectangle are counted with four lookups.
+// Changing flags recomputes only the sums below and to the right of the change, which is what they depend on.
+class SummedAreaTable
+{
+    int                         _width;
+    int                         _height;
+
+    std::vector<unsigned char>  _flags;     // _width x _height
+    std::vector<int>            _sums;      // (_width + 1) x (_height + 1): the flags set above and left of each corner
+
+    int  flagIndex(int x, int y) const { return y * _width + x; };
+    int  sumIndex(int x, int y) const { return y * (_width + 1) + x; };
+
+    // Recomputes the sums of all corners right of left and below top
+    void update(int left, int top);
+
+public:
+
+    SummedAreaTable();
+    SummedAreaTable(int width, int height);
+
+    // Sets the flag of every tile for which isSet(x, y) is true and clears the others
+    template <class Predicate>
+    void build(Predicate isSet)
+    {
+        for (int y = 0; y < _height; y++)
+            for (int x = 0; x < _width; x++)
+                _flags[flagIndex(x, y)] = isSet(x, y) ? 1 : 0;
+
+        update(0, 0);
+    };
+
+    bool get(int x, int y) const;
+
+    // Sets or clears the flags of a rectangle, clipped to the grid
+    void set(int x, int y, int width, int height, bool value);
+
+    // The number of flags set in a rectangle, clipped to the grid
+    int count(int x, int y, int width, int height) const;
+};
+
+}
@@ -8,12 +8,19 @@
 
 #include "UAlbertaBotModule.h"
 
+#include "BOSSManager.h"
 #include "Bases.h"
+#include "ClearanceMap.h"
 #include "Common.h"
+#include "FlowField.h"
+#include "MapDump.h"
 #include "OpponentModel.h"
 #include "ParseUtils.h"
+#include "PathService.h"
 #include "UnitUtil.h"
 
+#include <thread>
+
 using namespace UAlbertaBot;
 
 namespace { auto & bwemMap = BWEM::Map::Instance(); }
@@ -36,11 +43,20 @@ void UAlbertaBotModule::onStart()
 	BWTA::analyze();
 
 	// BWEM map init
+	// The analysis can use all of our cores, since nothing else is running yet
+	bwemMap.SetInitializationThreads(std::thread::hardware_concurrency());
+	// The config file is not parsed yet, so this uses the default directories
+	bwemMap.SetCacheDirectories(Config::IO::ReadDir, Config::IO::WriteDir);
+	bwemMap.SetAltitudeAlgorithm(BWEM::altitude_algorithm_t::distance_transform);
+	bwemMap.SetCompactStorage(true);
 	bwemMap.Initialize(BWAPI::BroodwarPtr);
 	bwemMap.EnableAutomaticPathAnalysis();
 	bool startingLocationsOK = bwemMap.FindBasesForStartingLocations();
 	UAB_ASSERT(startingLocationsOK, "BWEM map analysis failed");
 
+    // Clearance for unit sizes. It depends on BWEM, and much of the rest depends on it.
+    ClearanceMap::Instance().initialize();
+
     // BWEB map init
     BuildingPlacer::Instance().initializeBWEB();
 
@@ -53,6 +69,16 @@ void UAlbertaBotModule::onStart()
 	// The config depends on the map and must be read after the map is analyzed.
     ParseUtils::ParseConfigFile(Config::ConfigFile::ConfigFileLocation);
 
+    // Now that debug logging is configured, record how long each step of the BWEM analysis took
+    for (const auto & timing : bwemMap.InitializationTimings())
+        Log().Debug() << "BWEM " << timing.first << ": " << timing.second << " ms";
+
+    // Save the map for the offline map analysis tool
+    if (Config::Tools::DumpMap)
+    {
+        MapDump::write(Config::IO::WriteDir + MapDump::fileName());
+    }
+
     // Set our BWAPI options according to the configuration. 
 	BWAPI::Broodwar->setLocalSpeed(Config::BWAPIOptions::SetLocalSpeed);
 	BWAPI::Broodwar->setFrameSkip(Config::BWAPIOptions::SetFrameSkip);
@@ -71,6 +97,13 @@ void UAlbertaBotModule::onStart()
 
 	StrategyManager::Instance().initializeOpening();    // may depend on config and/or opponent model
 
+    // Start the background path workers on a snapshot of the map
+    PathService::Instance().start(Config::Tools::PathServiceThreads);
+    MapTools::Instance().requestBaseDistances();
+
+    // Flow fields outlive a game, and their age check can't tell one game's frames from another's
+    FlowFields::Instance().clear();
+
     if (Config::BotInfo::PrintInfoOnStart)
     {
         BWAPI::Broodwar->printf("%s by %s, based on UAlbertaBot via Steamhammer.", Config::BotInfo::BotName.c_str(), Config::BotInfo::Authors.c_str());
@@ -81,6 +114,9 @@ void UAlbertaBotModule::onEnd(bool isWinner)
 {
     if (gameEnded) return;
 
+    PathService::Instance().stop();
+    BOSSManager::Instance().stop();
+
     GameCommander::Instance().onEnd(isWinner);
 
     gameEnded = true;
@@ -126,6 +162,13 @@ void UAlbertaBotModule::onUnitDestroy(BWAPI::Unit unit)
 	else if (unit->getType().isSpecialBuilding())
 		bwemMap.OnStaticBuildingDestroyed(unit);
 
+    // Units may fit through where the neutral was
+    if (unit->getType().isMineralField() || unit->getType().isSpecialBuilding())
+    {
+        ClearanceMap::Instance().onNeutralDestroyed(unit);
+        PathService::Instance().onNeutralDestroyed(unit);
+    }
+
 	bwebMap.onUnitDestroy(unit);
 
 	GameCommander::Instance().onUnitDestroy(unit);